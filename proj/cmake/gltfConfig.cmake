@@ -8,7 +8,19 @@ if( NOT TARGET gltf )
 			"${gltf_SOURCE_PATH}/cinder/gltf/Types.cpp"
 			"${gltf_SOURCE_PATH}/cinder/gltf/SimpleScene.cpp"
 			"${gltf_SOURCE_PATH}/cinder/gltf/MeshLoader.cpp"
-			"${gltf_SOURCE_PATH}/cinder/gltf/File.cpp" )
+			"${gltf_SOURCE_PATH}/cinder/gltf/MeshOptimizer.cpp"
+			"${gltf_SOURCE_PATH}/cinder/gltf/JsonStreamReader.cpp"
+			"${gltf_SOURCE_PATH}/cinder/gltf/MappedFile.cpp"
+			"${gltf_SOURCE_PATH}/cinder/gltf/ThreadPool.cpp"
+			"${gltf_SOURCE_PATH}/cinder/gltf/Symbol.cpp"
+			"${gltf_SOURCE_PATH}/cinder/gltf/DataUri.cpp"
+			"${gltf_SOURCE_PATH}/cinder/gltf/ResourceCache.cpp"
+			"${gltf_SOURCE_PATH}/cinder/gltf/LoadStats.cpp"
+			"${gltf_SOURCE_PATH}/cinder/gltf/File.cpp"
+			"${gltf_SOURCE_PATH}/cinder/gltf/Snapshot.cpp"
+			"${gltf_SOURCE_PATH}/cinder/gltf/Selection.cpp"
+			"${gltf_SOURCE_PATH}/cinder/gltf/BatchLoader.cpp"
+			"${gltf_SOURCE_PATH}/cinder/gltf/InterleavedMesh.cpp" )
 
 	add_library( gltf "${gltf_SOURCES}" )
 
@@ -21,9 +21,14 @@ class SkeletalAnimationApp : public App {
 	void draw() override;
 	
 	void loadFromFile( const fs::path &path, const string &nodeName );
+	void loadFromFileAsync( const fs::path &path, const string &nodeName );
+	void applyFile( const gltf::FileRef &file, const string &nodeName );
 	
 	vector<pair<fs::path, string>> gltf;
 	
+	gltf::LoadRequestRef	mPendingLoad;
+	string					mPendingNodeName;
+	
 	CameraPersp		mCam;
 	CameraUi		mCamUi;
 	
@@ -71,9 +76,20 @@ void SkeletalAnimationApp::setup()
 
 void SkeletalAnimationApp::loadFromFile( const fs::path &path, const std::string &nodeName )
 {
-	auto fileAsset = loadAsset( path );
-	auto file = gltf::File::create( fileAsset );
-	
+	applyFile( gltf::File::create( loadAsset( path ) ), nodeName );
+}
+
+void SkeletalAnimationApp::loadFromFileAsync( const fs::path &path, const std::string &nodeName )
+{
+	// Only the latest request matters, stop whatever is still loading.
+	if( mPendingLoad )
+		mPendingLoad->cancel();
+	mPendingLoad = gltf::File::createAsync( loadAsset( path ), gltf::File::Options(), gltf::ThreadPool::Priority::HIGH );
+	mPendingNodeName = nodeName;
+}
+
+void SkeletalAnimationApp::applyFile( const gltf::FileRef &file, const std::string &nodeName )
+{
 	auto &node = file->getNodeInfo( nodeName );
 	auto &meshes = node.meshes;
 	
@@ -116,11 +132,18 @@ void SkeletalAnimationApp::keyDown( KeyEvent event )
 	}
 	
 	const auto &next = gltf[mGltfIndex];
-	loadFromFile( next.first, next.second );
+	loadFromFileAsync( next.first, next.second );
 }
 
 void SkeletalAnimationApp::update()
 {
+	if( mPendingLoad && mPendingLoad->isReady() ) {
+		auto file = mPendingLoad->getFile();
+		mPendingLoad.reset();
+		if( file )
+			applyFile( file, mPendingNodeName );
+	}
+	
 	localTransforms.clear();
 #if USE_SKELETON_ANIM
 	mSkeletonAnim->getLoopedLocal( getElapsedSeconds(), &localTransforms );
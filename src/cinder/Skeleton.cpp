@@ -13,6 +13,24 @@ using namespace ci;
 Skeleton::Skeleton( std::vector<Joint> joints, std::vector<std::string> jointNames, const ci::mat4 &bindShapeMatrix )
 : mJointArray( std::move( joints ) ), mJointNames( std::move( jointNames ) ), mBindShapeMatrix( bindShapeMatrix )
 {
+	// glTF 2.0 doesn't order joints parent first, so each joint's chain of unvisited ancestors is
+	// appended root first. Visited joints end a chain, which also breaks malformed cycles.
+	auto numJoints = mJointArray.size();
+	std::vector<bool> visited( numJoints, false );
+	std::vector<uint8_t> chain;
+	mEvalOrder.reserve( numJoints );
+	for( size_t i = 0; i < numJoints; i++ ) {
+		auto current = static_cast<uint8_t>( i );
+		while( ! visited[current] ) {
+			visited[current] = true;
+			chain.push_back( current );
+			current = mJointArray[current].getParentId();
+			if( current >= numJoints )
+				break;
+		}
+		mEvalOrder.insert( mEvalOrder.end(), chain.rbegin(), chain.rend() );
+		chain.clear();
+	}
 }
 
 bool Skeleton::hasJoint( const std::string &name ) const
@@ -350,7 +368,10 @@ void SkeletonRenderer::draw( const Skeleton &skeleton, const std::vector<ci::mat
 	
 	int instances = 0;
 	auto jointSize = static_cast< uint32_t >( joints.size() );
-	for (uint32_t i = 1; i < jointSize; ++i) {
+	for (uint32_t i = 0; i < jointSize; ++i) {
+		// Roots have no bone leading to them.
+		if( joints[i].getParentId() >= jointSize )
+			continue;
 		
 		// Selects joint matrices.
 		const ci::mat4& parent = finalPose[joints[i].getParentId()];
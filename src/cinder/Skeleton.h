@@ -25,8 +25,8 @@ public:
 			  std::vector<std::string> jointNames,
 			  const ci::mat4 &bindShapeMatrix );
 	
-	//! Returns a const ptr to the root joint.
-	const Joint*	getRoot() const { return &mJointArray[0]; }
+	//! Returns a const ptr to the first root joint, a skeleton can have several.
+	const Joint*	getRoot() const { return &mJointArray[mEvalOrder.front()]; }
 	//! Returns a const ptr to joint with name /a name.
 	const Joint*	getJoint( const std::string& name ) const;
 	//! Returns a const ptr to joint with id /a jointId.
@@ -195,6 +195,8 @@ private:
 	std::vector<Joint>			mJointArray;
 	std::vector<std::string>	mJointNames;
 	ci::mat4					mBindShapeMatrix;
+	//! Joint indices ordered so that every parent comes before its children.
+	std::vector<uint8_t>		mEvalOrder;
 };
 
 class SkeletonRenderer {
@@ -231,12 +233,16 @@ inline void Skeleton::calcMatrixPaletteFromLocal( const std::vector<ci::mat4> &l
 inline void Skeleton::calcGlobalMatrices( const std::vector<ci::mat4> &localJointTransforms,
 										 std::vector<ci::mat4> *globalJoint ) const
 {
-	globalJoint->clear();
-	// Derive root
-	globalJoint->emplace_back( localJointTransforms[0] );
-	// Derive children
-	for( size_t i = 1, end = mJointArray.size(); i < end; i++ )
-		globalJoint->emplace_back( (*globalJoint)[mJointArray[i].getParentId()] * localJointTransforms[i] );
+	globalJoint->resize( mJointArray.size() );
+	// Roots, with a parent id of 0xFF, take their local transform. Children are derived after
+	// their parent, wherever either sits in the joint array.
+	for( auto i : mEvalOrder ) {
+		auto parentId = mJointArray[i].getParentId();
+		if( parentId < mJointArray.size() )
+			(*globalJoint)[i] = (*globalJoint)[parentId] * localJointTransforms[i];
+		else
+			(*globalJoint)[i] = localJointTransforms[i];
+	}
 }
 
 inline Skeleton::Anim::JointClip::JointClip( const TransformClip &transform )
@@ -0,0 +1,318 @@
+//
+//  AccessorView.h
+//  gltf
+//
+//  Typed, stride-aware views over Accessor data, read in place from the buffer.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+
+#include "cinder/Log.h"
+
+#include "cinder/gltf/Types.h"
+
+namespace cinder {
+namespace gltf {
+
+//! Maps the element types an AccessorView can read to the Accessor type and component type
+//! they're stored as. Reading any other type is a compile error.
+template<typename T>
+struct AccessorTraits {
+	static_assert( sizeof( T ) == 0, "AccessorView has no Accessor layout for this element type" );
+};
+
+#define CI_GLTF_ACCESSOR_TRAITS( T, TYPE, COMPONENT_TYPE )											\
+	template<> struct AccessorTraits<T> {															\
+		static constexpr Accessor::Type				type = Accessor::Type::TYPE;					\
+		static constexpr Accessor::ComponentType	componentType = Accessor::ComponentType::COMPONENT_TYPE;	\
+	};
+
+CI_GLTF_ACCESSOR_TRAITS( float, SCALAR, FLOAT )
+CI_GLTF_ACCESSOR_TRAITS( ci::vec2, VEC2, FLOAT )
+CI_GLTF_ACCESSOR_TRAITS( ci::vec3, VEC3, FLOAT )
+CI_GLTF_ACCESSOR_TRAITS( ci::vec4, VEC4, FLOAT )
+// glTF rotations are stored x, y, z, w like glm.
+CI_GLTF_ACCESSOR_TRAITS( ci::quat, VEC4, FLOAT )
+CI_GLTF_ACCESSOR_TRAITS( ci::mat2, MAT2, FLOAT )
+CI_GLTF_ACCESSOR_TRAITS( ci::mat3, MAT3, FLOAT )
+CI_GLTF_ACCESSOR_TRAITS( ci::mat4, MAT4, FLOAT )
+CI_GLTF_ACCESSOR_TRAITS( int8_t, SCALAR, BYTE )
+CI_GLTF_ACCESSOR_TRAITS( uint8_t, SCALAR, UNSIGNED_BYTE )
+CI_GLTF_ACCESSOR_TRAITS( int16_t, SCALAR, SHORT )
+CI_GLTF_ACCESSOR_TRAITS( uint16_t, SCALAR, UNSIGNED_SHORT )
+CI_GLTF_ACCESSOR_TRAITS( uint32_t, SCALAR, UNSIGNED_INT )
+
+#undef CI_GLTF_ACCESSOR_TRAITS
+
+//! Reads the elements of an Accessor as T directly from its buffer, stepping by the Accessor's
+//! byte stride, so interleaved data is read without copying it out first. The view is empty if
+//! the Accessor isn't stored as T, or if it has no data. Note: the File the Accessor belongs to
+//! needs to outlive the view.
+template<typename T>
+class AccessorView {
+public:
+	//! Random access over the elements, dereferencing returns a copy as elements of
+	//! interleaved data needn't be aligned.
+	class const_iterator {
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type		= T;
+		using difference_type	= std::ptrdiff_t;
+		using pointer			= const T*;
+		using reference			= T;
+
+		const_iterator() = default;
+		const_iterator( const uint8_t *ptr, uint32_t stride ) : mPtr( ptr ), mStride( stride ) {}
+
+		T					operator*() const { return read( mPtr ); }
+		T					operator[]( difference_type n ) const { return read( mPtr + n * mStride ); }
+
+		const_iterator&		operator++() { mPtr += mStride; return *this; }
+		const_iterator		operator++( int ) { auto ret = *this; mPtr += mStride; return ret; }
+		const_iterator&		operator--() { mPtr -= mStride; return *this; }
+		const_iterator		operator--( int ) { auto ret = *this; mPtr -= mStride; return ret; }
+		const_iterator&		operator+=( difference_type n ) { mPtr += n * mStride; return *this; }
+		const_iterator&		operator-=( difference_type n ) { mPtr -= n * mStride; return *this; }
+		const_iterator		operator+( difference_type n ) const { return const_iterator( mPtr + n * mStride, mStride ); }
+		const_iterator		operator-( difference_type n ) const { return const_iterator( mPtr - n * mStride, mStride ); }
+		difference_type		operator-( const const_iterator &rhs ) const { return ( mPtr - rhs.mPtr ) / static_cast<difference_type>( mStride ); }
+
+		bool	operator==( const const_iterator &rhs ) const { return mPtr == rhs.mPtr; }
+		bool	operator!=( const const_iterator &rhs ) const { return mPtr != rhs.mPtr; }
+		bool	operator<( const const_iterator &rhs ) const { return mPtr < rhs.mPtr; }
+		bool	operator>( const const_iterator &rhs ) const { return mPtr > rhs.mPtr; }
+		bool	operator<=( const const_iterator &rhs ) const { return mPtr <= rhs.mPtr; }
+		bool	operator>=( const const_iterator &rhs ) const { return mPtr >= rhs.mPtr; }
+
+	private:
+		const uint8_t	*mPtr{nullptr};
+		uint32_t		mStride{sizeof( T )};
+	};
+
+	AccessorView() = default;
+	//! Views the elements of /a accessor, which mustn't be sparse, see SparseAccessorView.
+	explicit AccessorView( const Accessor &accessor );
+	//! Views /a size elements at /a data, /a stride bytes apart.
+	AccessorView( const void *data, size_t size, uint32_t stride = sizeof( T ) )
+	: mData( reinterpret_cast<const uint8_t*>( data ) ), mSize( size ), mStride( stride ) {}
+
+	//! Returns the number of elements in the view.
+	size_t			size() const { return mSize; }
+	//! Returns whether there's nothing to read, see AccessorView().
+	bool			empty() const { return mSize == 0; }
+	//! Returns a copy of the element at /a index.
+	T				operator[]( size_t index ) const { return read( mData + index * mStride ); }
+	const_iterator	begin() const { return const_iterator( mData, mStride ); }
+	const_iterator	end() const { return const_iterator( mData + mSize * mStride, mStride ); }
+
+	//! Returns the number of bytes from one element to the next.
+	uint32_t		getByteStride() const { return mStride; }
+	//! Returns whether the elements are tightly packed.
+	bool			isContiguous() const { return mStride == sizeof( T ); }
+	//! Copies every element to /a dst, which must hold size() elements. Packed data is copied at once.
+	void			copyTo( T *dst ) const;
+
+private:
+	static T read( const uint8_t *ptr )
+	{
+		T ret;
+		std::memcpy( &ret, ptr, sizeof( T ) );
+		return ret;
+	}
+
+	const uint8_t	*mData{nullptr};
+	size_t			mSize{0};
+	uint32_t		mStride{sizeof( T )};
+};
+
+template<typename T>
+AccessorView<T>::AccessorView( const Accessor &accessor )
+{
+	using Traits = AccessorTraits<T>;
+	if( accessor.dataType != Traits::type || accessor.componentType != Traits::componentType ) {
+		CI_LOG_E( "Accessor " << accessor.key << " isn't stored as the type viewed" );
+		return;
+	}
+	if( accessor.isSparse() ) {
+		CI_LOG_E( "Accessor " << accessor.key << " is sparse, view it with a SparseAccessorView" );
+		return;
+	}
+	auto data = reinterpret_cast<const uint8_t*>( accessor.getDataPtr() );
+	if( ! data || accessor.count == 0 )
+		return;
+	auto stride = accessor.getByteStride();
+	auto byteLength = accessor.bufferView->byteLength;
+	if( byteLength && accessor.byteOffset + size_t( accessor.count - 1 ) * stride + sizeof( T ) > byteLength ) {
+		CI_LOG_E( "Accessor " << accessor.key << " reads past the end of its bufferView" );
+		return;
+	}
+	mData = data;
+	mSize = accessor.count;
+	mStride = stride;
+}
+
+template<typename T>
+void AccessorView<T>::copyTo( T *dst ) const
+{
+	if( isContiguous() ) {
+		std::memcpy( dst, mData, mSize * sizeof( T ) );
+		return;
+	}
+	auto src = mData;
+	for( size_t i = 0; i < mSize; i++, src += mStride )
+		std::memcpy( dst + i, src, sizeof( T ) );
+}
+
+//! Reads a sparse Accessor without densifying it: the sparse values are iterated by index over
+//! the base elements, which are zeros if the Accessor has no bufferView. Also reads Accessors
+//! that aren't sparse, as a base without values.
+template<typename T>
+class SparseAccessorView {
+public:
+	SparseAccessorView() = default;
+	//! Views the base elements and sparse values of /a accessor.
+	explicit SparseAccessorView( const Accessor &accessor );
+
+	//! Returns the number of elements, with the sparse ones.
+	size_t					size() const { return mSize; }
+	//! Returns the base elements, empty if they're zeros.
+	const AccessorView<T>&	getBase() const { return mBase; }
+	//! Returns the number of sparse values.
+	size_t					getNumSparse() const { return mValues.size(); }
+	//! Returns the index of the element replaced by the sparse value /a i.
+	uint32_t				getSparseIndex( size_t i ) const;
+	//! Returns the sparse value /a i.
+	T						getSparseValue( size_t i ) const { return mValues[i]; }
+	//! Returns a copy of the element at /a index, searching the sparse indices first.
+	T						operator[]( size_t index ) const;
+	//! Densifies every element to /a dst, which must hold size() elements.
+	void					copyTo( T *dst ) const;
+
+private:
+	//! Returns whether /a size bytes at /a byteOffset are within /a bufferView, whose byteLength
+	//! is 0 if unknown.
+	static bool fits( const BufferView &bufferView, size_t byteOffset, size_t size )
+	{
+		return ! bufferView.byteLength || byteOffset + size <= bufferView.byteLength;
+	}
+	//! Returns an element of zeros, a default constructed quat or matrix is the identity.
+	static T zero()
+	{
+		T ret;
+		std::memset( static_cast<void*>( &ret ), 0, sizeof( T ) );
+		return ret;
+	}
+
+	AccessorView<T>	mBase, mValues;
+	const uint8_t	*mIndices{nullptr};
+	uint8_t			mIndexSize{4};
+	size_t			mSize{0};
+};
+
+template<typename T>
+SparseAccessorView<T>::SparseAccessorView( const Accessor &accessor )
+{
+	using Traits = AccessorTraits<T>;
+	if( accessor.dataType != Traits::type || accessor.componentType != Traits::componentType ) {
+		CI_LOG_E( "Accessor " << accessor.key << " isn't stored as the type viewed" );
+		return;
+	}
+	if( accessor.bufferView ) {
+		auto data = accessor.getDataPtr();
+		if( ! data )
+			return;
+		auto stride = accessor.getByteStride();
+		if( accessor.count && ! fits( *accessor.bufferView, accessor.byteOffset, size_t( accessor.count - 1 ) * stride + sizeof( T ) ) ) {
+			CI_LOG_E( "Accessor " << accessor.key << " reads past the end of its bufferView" );
+			return;
+		}
+		mBase = AccessorView<T>( data, accessor.count, stride );
+	}
+	mSize = accessor.count;
+	if( ! accessor.isSparse() )
+		return;
+
+	auto &sparse = accessor.sparse;
+	auto invalidate = [this] {
+		mSize = 0;
+		mBase = AccessorView<T>();
+	};
+	if( ! sparse.indicesBufferView || ! sparse.valuesBufferView ) {
+		CI_LOG_E( "Sparse accessor " << accessor.key << " has no indices or values to read" );
+		invalidate();
+		return;
+	}
+	auto indicesData = sparse.indicesBufferView->buffer->getBuffer();
+	auto valuesData = sparse.valuesBufferView->buffer->getBuffer();
+	switch( sparse.indicesComponentType ) {
+		case Accessor::ComponentType::UNSIGNED_BYTE: mIndexSize = 1; break;
+		case Accessor::ComponentType::UNSIGNED_SHORT: mIndexSize = 2; break;
+		case Accessor::ComponentType::UNSIGNED_INT: mIndexSize = 4; break;
+		default: indicesData = nullptr; break;
+	}
+	if( ! indicesData || ! valuesData ) {
+		CI_LOG_E( "Sparse accessor " << accessor.key << " has no indices or values to read" );
+		invalidate();
+		return;
+	}
+	if( ! fits( *sparse.indicesBufferView, sparse.indicesByteOffset, size_t( sparse.count ) * mIndexSize )
+	   || ! fits( *sparse.valuesBufferView, sparse.valuesByteOffset, size_t( sparse.count ) * sizeof( T ) ) ) {
+		CI_LOG_E( "Sparse accessor " << accessor.key << " reads past the end of its bufferViews" );
+		invalidate();
+		return;
+	}
+	mIndices = reinterpret_cast<const uint8_t*>( indicesData->getData() ) + sparse.indicesBufferView->byteOffset + sparse.indicesByteOffset;
+	mValues = AccessorView<T>( reinterpret_cast<const uint8_t*>( valuesData->getData() ) + sparse.valuesBufferView->byteOffset + sparse.valuesByteOffset,
+							   sparse.count );
+}
+
+template<typename T>
+uint32_t SparseAccessorView<T>::getSparseIndex( size_t i ) const
+{
+	auto ptr = mIndices + i * mIndexSize;
+	switch( mIndexSize ) {
+		case 1: return *ptr;
+		case 2: { uint16_t ret; std::memcpy( &ret, ptr, 2 ); return ret; }
+		default: { uint32_t ret; std::memcpy( &ret, ptr, 4 ); return ret; }
+	}
+}
+
+template<typename T>
+T SparseAccessorView<T>::operator[]( size_t index ) const
+{
+	// sparse indices are strictly increasing.
+	size_t first = 0, last = mValues.size();
+	while( first < last ) {
+		auto middle = first + ( last - first ) / 2;
+		auto sparseIndex = getSparseIndex( middle );
+		if( sparseIndex == index )
+			return mValues[middle];
+		if( sparseIndex < index )
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return mBase.empty() ? zero() : mBase[index];
+}
+
+template<typename T>
+void SparseAccessorView<T>::copyTo( T *dst ) const
+{
+	if( mBase.empty() )
+		std::fill( dst, dst + mSize, zero() );
+	else
+		mBase.copyTo( dst );
+	for( size_t i = 0; i < mValues.size(); i++ ) {
+		auto index = getSparseIndex( i );
+		if( index < mSize )
+			dst[index] = mValues[i];
+	}
+}
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,137 @@
+//
+//  BatchLoader.cpp
+//  gltf
+//
+
+#include "BatchLoader.h"
+
+#include <algorithm>
+
+namespace cinder {
+namespace gltf {
+
+BatchLoaderRef BatchLoader::create( const std::vector<ci::DataSourceRef> &sources, const File::Options &options, size_t maxPending,
+									ThreadPool::Priority priority )
+{
+	BatchLoaderRef ret( new BatchLoader( sources, options, maxPending, priority ) );
+	// the first loads start once there's a shared_ptr for them to hold.
+	std::lock_guard<std::mutex> lock( ret->mMutex );
+	ret->startLoads();
+	return ret;
+}
+
+BatchLoaderRef BatchLoader::create( const std::vector<ci::fs::path> &paths, const File::Options &options, size_t maxPending,
+									ThreadPool::Priority priority )
+{
+	// files are opened by the load, not here.
+	std::vector<ci::DataSourceRef> sources;
+	sources.reserve( paths.size() );
+	for( auto &path : paths )
+		sources.push_back( DataSourcePath::create( path ) );
+	return create( sources, options, maxPending, priority );
+}
+
+BatchLoader::BatchLoader( const std::vector<ci::DataSourceRef> &sources, const File::Options &options, size_t maxPending,
+						  ThreadPool::Priority priority )
+: mSources( sources ), mOptions( options ), mMaxPending( maxPending ), mPriority( priority ), mNextSource( 0 ), mNumTaken( 0 ),
+	mCanceled( false ), mStart( Clock::now() )
+{
+	if( mMaxPending == 0 )
+		mMaxPending = 2 * ThreadPool::get().getNumThreads();
+}
+
+void BatchLoader::startLoads()
+{
+	auto self = shared_from_this();
+	while( mNextSource < mSources.size() && mInFlight.size() + mCompleted.size() < mMaxPending ) {
+		auto index = mNextSource++;
+		LoadRequestRef request( new LoadRequest( mPriority ) );
+		if( mCanceled )
+			request->cancel();
+		mInFlight[index] = request;
+		// the result is handed over here rather than through the LoadRequest's future.
+		ThreadPool::get().submit( [self, index, request] {
+			auto &source = self->mSources[index];
+			auto file = request->isCanceled() ? FileRef() : File::createForRequest( source, self->mOptions, request );
+			auto loadStats = file ? file->getLoadStats() : LoadStats();
+
+			std::lock_guard<std::mutex> lock( self->mMutex );
+			Result result;
+			result.index = index;
+			result.source = source;
+			result.file = file;
+			self->mCompleted.push_back( result );
+			self->mInFlight.erase( index );
+			if( file ) {
+				self->mStats.numLoaded++;
+				self->mStats.numBytes += loadStats.fileBytes + loadStats.bufferBytes;
+			}
+			else
+				self->mStats.numFailed++;
+			self->mStats.seconds = std::chrono::duration<double>( Clock::now() - self->mStart ).count();
+			self->mCompletedCondition.notify_all();
+		}, mPriority );
+	}
+}
+
+void BatchLoader::takeCompleted( Result *result )
+{
+	*result = std::move( mCompleted.front() );
+	mCompleted.pop_front();
+	mNumTaken++;
+	// taking a result makes room for the next load.
+	startLoads();
+}
+
+bool BatchLoader::next( Result *result )
+{
+	auto &pool = ThreadPool::get();
+	while( true ) {
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			if( ! mCompleted.empty() ) {
+				takeCompleted( result );
+				return true;
+			}
+			if( mNumTaken == mSources.size() )
+				return false;
+		}
+		// helps with the loads instead of idling, like ThreadPool::wait().
+		if( ! pool.runPendingTask() ) {
+			std::unique_lock<std::mutex> lock( mMutex );
+			mCompletedCondition.wait( lock, [this] { return ! mCompleted.empty() || mNumTaken == mSources.size(); } );
+		}
+	}
+}
+
+bool BatchLoader::tryNext( Result *result )
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	if( mCompleted.empty() )
+		return false;
+	takeCompleted( result );
+	return true;
+}
+
+void BatchLoader::cancel()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	mCanceled = true;
+	for( auto &request : mInFlight )
+		request.second->cancel();
+}
+
+size_t BatchLoader::getNumRemaining() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mSources.size() - mNumTaken;
+}
+
+BatchLoader::Stats BatchLoader::getStats() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mStats;
+}
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,101 @@
+//
+//  BatchLoader.h
+//  gltf
+//
+//  Loads many Files concurrently on the shared ThreadPool, handing them out as they complete.
+//
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "cinder/DataSource.h"
+#include "cinder/Filesystem.h"
+
+#include "cinder/gltf/File.h"
+
+namespace cinder {
+namespace gltf {
+
+using BatchLoaderRef = std::shared_ptr<class BatchLoader>;
+
+class BatchLoader : public std::enable_shared_from_this<BatchLoader> {
+public:
+	//! A File that finished loading.
+	struct Result {
+		//! Index of the source in the list the BatchLoader was created with.
+		size_t				index{0};
+		ci::DataSourceRef	source;
+		//! Null if the load failed or was canceled.
+		FileRef				file;
+	};
+
+	//! Throughput of the loads completed so far.
+	struct Stats {
+		size_t	numLoaded{0}, numFailed{0};
+		//! Bytes read for the loaded Files, their JSON, binary bodies and external buffers.
+		size_t	numBytes{0};
+		//! Wall time from creation until the last load completed.
+		double	seconds{0.0};
+
+		double	getFilesPerSecond() const { return seconds > 0.0 ? numLoaded / seconds : 0.0; }
+		double	getMegabytesPerSecond() const { return seconds > 0.0 ? numBytes / ( 1024.0 * 1024.0 ) / seconds : 0.0; }
+	};
+
+	//! Starts loading /a sources with /a options. At most /a maxPending Files are loading or waiting
+	//! to be taken with next() at once, further loads only start as results are taken. 0 allows
+	//! two per worker thread. Tasks are queued with /a priority.
+	static BatchLoaderRef create( const std::vector<ci::DataSourceRef> &sources, const File::Options &options = File::Options(),
+								  size_t maxPending = 0, ThreadPool::Priority priority = ThreadPool::Priority::NORMAL );
+	//! Starts loading the files at /a paths, see above.
+	static BatchLoaderRef create( const std::vector<ci::fs::path> &paths, const File::Options &options = File::Options(),
+								  size_t maxPending = 0, ThreadPool::Priority priority = ThreadPool::Priority::NORMAL );
+
+	//! Blocks until the next load completes and writes it to /a result, in completion order.
+	//! Runs queued pool tasks while waiting. Returns false once every result was taken.
+	bool	next( Result *result );
+	//! Writes the next completed load to /a result without blocking. Returns false if none is ready.
+	bool	tryNext( Result *result );
+	//! Cancels the loads in flight and skips the ones that haven't started. Their results are
+	//! still returned by next(), with a null file.
+	void	cancel();
+
+	//! Returns the number of results that haven't been taken yet.
+	size_t	getNumRemaining() const;
+	//! Returns the throughput so far.
+	Stats	getStats() const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	BatchLoader( const std::vector<ci::DataSourceRef> &sources, const File::Options &options, size_t maxPending,
+				 ThreadPool::Priority priority );
+
+	//! Starts loads until mMaxPending are in flight or waiting. The caller must hold mMutex.
+	void	startLoads();
+	//! Moves the front completed load to /a result. The caller must hold mMutex.
+	void	takeCompleted( Result *result );
+
+	std::vector<ci::DataSourceRef>	mSources;
+	File::Options					mOptions;
+	size_t							mMaxPending;
+	ThreadPool::Priority			mPriority;
+
+	mutable std::mutex							mMutex;
+	std::condition_variable						mCompletedCondition;
+	std::deque<Result>							mCompleted;
+	std::unordered_map<size_t, LoadRequestRef>	mInFlight;
+	size_t										mNextSource, mNumTaken;
+	bool										mCanceled;
+	Stats										mStats;
+	Clock::time_point							mStart;
+};
+
+} // namespace gltf
+} // namespace cinder
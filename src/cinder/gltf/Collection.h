@@ -0,0 +1,127 @@
+//
+//  Collection.h
+//  gltf
+//
+//  Contiguous storage of the objects of one glTF collection, addressed by index handles.
+//
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinder/CinderAssert.h"
+#include "cinder/gltf/Symbol.h"
+
+namespace cinder {
+namespace gltf {
+
+template<typename T>
+class Collection {
+public:
+	//! Index of an object in its Collection. Stays valid for the lifetime of the File.
+	using Handle = uint32_t;
+	static const Handle INVALID_HANDLE = static_cast<Handle>( -1 );
+
+	using iterator = typename std::vector<T>::iterator;
+	using const_iterator = typename std::vector<T>::const_iterator;
+
+	//! Returns the handle of /a key, or INVALID_HANDLE if it isn't part of this Collection.
+	Handle		find( const std::string &key ) const;
+	//! Returns whether /a key is part of this Collection.
+	bool		contains( const std::string &key ) const { return find( key ) != INVALID_HANDLE; }
+	//! Returns a pointer to the object associated with /a key, or nullptr if there is none.
+	T*			get( const std::string &key );
+	const T*	get( const std::string &key ) const;
+	//! Returns the object associated with /a key, which must be part of this Collection.
+	const T&	at( const std::string &key ) const;
+
+	//! Returns the object at /a handle.
+	T&			operator[]( Handle handle ) { return mObjects[handle]; }
+	const T&	operator[]( Handle handle ) const { return mObjects[handle]; }
+
+	//! Returns the number of objects.
+	size_t		size() const { return mObjects.size(); }
+	bool		empty() const { return mObjects.empty(); }
+	//! Returns a pointer to the contiguous objects.
+	T*			data() { return mObjects.data(); }
+	const T*	data() const { return mObjects.data(); }
+
+	iterator		begin() { return mObjects.begin(); }
+	iterator		end() { return mObjects.end(); }
+	const_iterator	begin() const { return mObjects.begin(); }
+	const_iterator	end() const { return mObjects.end(); }
+
+	//! Appends a default constructed object for /a key and returns its handle, or returns the
+	//! handle of the existing object. Invalidates pointers to the objects if the storage grows,
+	//! so every object is allocated before any pointer is taken. The key string isn't copied, it
+	//! has to outlive the Collection like the strings of the File's SymbolTable do.
+	Handle		allocate( const Symbol &key );
+	//! Reserves storage for /a count objects.
+	void		reserve( size_t count ) { mObjects.reserve( count ); mHandles.reserve( count ); }
+	//! Returns the estimated bytes of the objects and the key lookup, not counting what the
+	//! objects own on the heap.
+	size_t		getNumBytes() const;
+
+private:
+	//! Hashes and compares the strings pointed to, so lookups by any std::string work.
+	struct KeyHash {
+		size_t operator()( const std::string *key ) const { return std::hash<std::string>()( *key ); }
+	};
+	struct KeyEqual {
+		bool operator()( const std::string *lhs, const std::string *rhs ) const { return *lhs == *rhs; }
+	};
+
+	std::vector<T>													mObjects;
+	std::unordered_map<const std::string*, Handle, KeyHash, KeyEqual>	mHandles;
+};
+
+template<typename T>
+typename Collection<T>::Handle Collection<T>::find( const std::string &key ) const
+{
+	auto found = mHandles.find( &key );
+	return found != mHandles.end() ? found->second : INVALID_HANDLE;
+}
+
+template<typename T>
+T* Collection<T>::get( const std::string &key )
+{
+	auto handle = find( key );
+	return handle != INVALID_HANDLE ? &mObjects[handle] : nullptr;
+}
+
+template<typename T>
+const T* Collection<T>::get( const std::string &key ) const
+{
+	auto handle = find( key );
+	return handle != INVALID_HANDLE ? &mObjects[handle] : nullptr;
+}
+
+template<typename T>
+const T& Collection<T>::at( const std::string &key ) const
+{
+	auto handle = find( key );
+	CI_ASSERT_MSG( handle != INVALID_HANDLE, "Unknown key" );
+	return mObjects[handle];
+}
+
+template<typename T>
+size_t Collection<T>::getNumBytes() const
+{
+	// a node of the lookup holds the key pointer, the handle and the next pointer.
+	return mObjects.capacity() * sizeof( T ) + mHandles.bucket_count() * sizeof( void* )
+		+ mHandles.size() * ( 2 * sizeof( void* ) + sizeof( Handle ) );
+}
+
+template<typename T>
+typename Collection<T>::Handle Collection<T>::allocate( const Symbol &key )
+{
+	auto emplaced = mHandles.emplace( &key.str(), static_cast<Handle>( mObjects.size() ) );
+	if( emplaced.second )
+		mObjects.emplace_back();
+	return emplaced.first->second;
+}
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,274 @@
+//
+//  DataUri.cpp
+//  gltf
+//
+
+#include "DataUri.h"
+
+#include <cstring>
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+	#define GLTF_BASE64_X86 1
+	#include <immintrin.h>
+	#if defined( _MSC_VER )
+		#include <intrin.h>
+	#endif
+#endif
+
+// Lets gcc and clang emit SSSE3/AVX2 for single functions without raising the baseline of the
+// whole block, the instructions are only reached after checking the CPU at runtime.
+#if defined( __GNUC__ ) || defined( __clang__ )
+	#define GLTF_TARGET( isa ) __attribute__(( target( isa ) ))
+#else
+	#define GLTF_TARGET( isa )
+#endif
+
+namespace cinder {
+namespace gltf {
+
+bool parseDataUri( const char *begin, const char *end, std::string *header, const char **payload )
+{
+	static const char sScheme[] = "data:";
+	const size_t schemeLength = sizeof( sScheme ) - 1;
+	if( size_t( end - begin ) < schemeLength || std::strncmp( begin, sScheme, schemeLength ) != 0 )
+		return false;
+	auto comma = static_cast<const char*>( std::memchr( begin, ',', end - begin ) );
+	if( ! comma )
+		return false;
+	if( header )
+		header->assign( begin, comma );
+	*payload = comma + 1;
+	return true;
+}
+
+std::string getDataUriMimeType( const std::string &header )
+{
+	auto begin = header.find( ':' );
+	if( begin == std::string::npos )
+		return std::string();
+	auto end = header.find( ';', begin );
+	return header.substr( begin + 1, end == std::string::npos ? std::string::npos : end - begin - 1 );
+}
+
+namespace {
+
+//! Maps every character to its 6 bit value, -1 for characters outside the alphabet.
+struct DecodeTable {
+	DecodeTable()
+	{
+		static const char sAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		std::memset( values, -1, sizeof( values ) );
+		for( int i = 0; i < 64; i++ )
+			values[static_cast<uint8_t>( sAlphabet[i] )] = static_cast<int8_t>( i );
+	}
+	int8_t values[256];
+};
+
+const DecodeTable sDecodeTable;
+
+size_t stripPadding( const char *data, size_t length )
+{
+	for( int i = 0; i < 2 && length > 0 && data[length - 1] == '='; i++ )
+		length--;
+	return length;
+}
+
+#if defined( GLTF_BASE64_X86 )
+
+struct CpuFeatures {
+	CpuFeatures()
+	{
+#if defined( _MSC_VER )
+		int info[4];
+		__cpuid( info, 0 );
+		int maxLeaf = info[0];
+		__cpuid( info, 1 );
+		ssse3 = ( info[2] & ( 1 << 9 ) ) != 0;
+		// AVX2 also needs the OS to save the ymm registers.
+		bool osxsave = ( info[2] & ( 1 << 27 ) ) != 0;
+		avx2 = false;
+		if( maxLeaf >= 7 && osxsave && ( _xgetbv( 0 ) & 6 ) == 6 ) {
+			__cpuidex( info, 7, 0 );
+			avx2 = ( info[1] & ( 1 << 5 ) ) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		ssse3 = __builtin_cpu_supports( "ssse3" ) != 0;
+		avx2 = __builtin_cpu_supports( "avx2" ) != 0;
+#endif
+	}
+	bool ssse3, avx2;
+};
+
+// Both kernels translate characters to 6 bit values with range compares, which also validates
+// them, then pack four values into three bytes per 32 bit lane:
+// maddubs merges pairs into 12 bits, madd merges those into 24 and pshufb drops the top byte
+// while swapping to big endian order.
+
+//! Decodes blocks of 16 characters while 24 or more remain, so the 16 byte stores stay inside the
+//! output. Returns the number of characters consumed, stopping early at an invalid block.
+GLTF_TARGET( "ssse3" )
+size_t decodeSsse3( const char *src, size_t length, uint8_t *dst )
+{
+	const __m128i upperMin = _mm_set1_epi8( 'A' - 1 ), upperMax = _mm_set1_epi8( 'Z' + 1 );
+	const __m128i lowerMin = _mm_set1_epi8( 'a' - 1 ), lowerMax = _mm_set1_epi8( 'z' + 1 );
+	const __m128i digitMin = _mm_set1_epi8( '0' - 1 ), digitMax = _mm_set1_epi8( '9' + 1 );
+	const __m128i plus = _mm_set1_epi8( '+' ), slash = _mm_set1_epi8( '/' );
+	const __m128i mergePairs = _mm_set1_epi32( 0x01400140 );
+	const __m128i mergeQuads = _mm_set1_epi32( 0x00011000 );
+	const __m128i pack = _mm_setr_epi8( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 );
+
+	size_t consumed = 0;
+	while( length - consumed >= 24 ) {
+		__m128i chars = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + consumed ) );
+		__m128i upper = _mm_and_si128( _mm_cmpgt_epi8( chars, upperMin ), _mm_cmpgt_epi8( upperMax, chars ) );
+		__m128i lower = _mm_and_si128( _mm_cmpgt_epi8( chars, lowerMin ), _mm_cmpgt_epi8( lowerMax, chars ) );
+		__m128i digit = _mm_and_si128( _mm_cmpgt_epi8( chars, digitMin ), _mm_cmpgt_epi8( digitMax, chars ) );
+		__m128i isPlus = _mm_cmpeq_epi8( chars, plus );
+		__m128i isSlash = _mm_cmpeq_epi8( chars, slash );
+		__m128i valid = _mm_or_si128( _mm_or_si128( upper, lower ), _mm_or_si128( digit, _mm_or_si128( isPlus, isSlash ) ) );
+		if( _mm_movemask_epi8( valid ) != 0xFFFF )
+			break;
+
+		__m128i shift = _mm_or_si128( _mm_and_si128( upper, _mm_set1_epi8( -65 ) ), _mm_and_si128( lower, _mm_set1_epi8( -71 ) ) );
+		shift = _mm_or_si128( shift, _mm_and_si128( digit, _mm_set1_epi8( 4 ) ) );
+		shift = _mm_or_si128( shift, _mm_and_si128( isPlus, _mm_set1_epi8( 19 ) ) );
+		shift = _mm_or_si128( shift, _mm_and_si128( isSlash, _mm_set1_epi8( 16 ) ) );
+		__m128i values = _mm_add_epi8( chars, shift );
+
+		__m128i merged = _mm_madd_epi16( _mm_maddubs_epi16( values, mergePairs ), mergeQuads );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst ), _mm_shuffle_epi8( merged, pack ) );
+		consumed += 16;
+		dst += 12;
+	}
+	return consumed;
+}
+
+//! Decodes blocks of 32 characters while 40 or more remain, see decodeSsse3().
+GLTF_TARGET( "avx2" )
+size_t decodeAvx2( const char *src, size_t length, uint8_t *dst )
+{
+	const __m256i upperMin = _mm256_set1_epi8( 'A' - 1 ), upperMax = _mm256_set1_epi8( 'Z' + 1 );
+	const __m256i lowerMin = _mm256_set1_epi8( 'a' - 1 ), lowerMax = _mm256_set1_epi8( 'z' + 1 );
+	const __m256i digitMin = _mm256_set1_epi8( '0' - 1 ), digitMax = _mm256_set1_epi8( '9' + 1 );
+	const __m256i plus = _mm256_set1_epi8( '+' ), slash = _mm256_set1_epi8( '/' );
+	const __m256i mergePairs = _mm256_set1_epi32( 0x01400140 );
+	const __m256i mergeQuads = _mm256_set1_epi32( 0x00011000 );
+	// pshufb works within each 128 bit lane, so each lane packs its own 12 bytes.
+	const __m256i pack = _mm256_setr_epi8( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+										   2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 );
+
+	size_t consumed = 0;
+	while( length - consumed >= 40 ) {
+		__m256i chars = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + consumed ) );
+		__m256i upper = _mm256_and_si256( _mm256_cmpgt_epi8( chars, upperMin ), _mm256_cmpgt_epi8( upperMax, chars ) );
+		__m256i lower = _mm256_and_si256( _mm256_cmpgt_epi8( chars, lowerMin ), _mm256_cmpgt_epi8( lowerMax, chars ) );
+		__m256i digit = _mm256_and_si256( _mm256_cmpgt_epi8( chars, digitMin ), _mm256_cmpgt_epi8( digitMax, chars ) );
+		__m256i isPlus = _mm256_cmpeq_epi8( chars, plus );
+		__m256i isSlash = _mm256_cmpeq_epi8( chars, slash );
+		__m256i valid = _mm256_or_si256( _mm256_or_si256( upper, lower ), _mm256_or_si256( digit, _mm256_or_si256( isPlus, isSlash ) ) );
+		if( _mm256_movemask_epi8( valid ) != -1 )
+			break;
+
+		__m256i shift = _mm256_or_si256( _mm256_and_si256( upper, _mm256_set1_epi8( -65 ) ), _mm256_and_si256( lower, _mm256_set1_epi8( -71 ) ) );
+		shift = _mm256_or_si256( shift, _mm256_and_si256( digit, _mm256_set1_epi8( 4 ) ) );
+		shift = _mm256_or_si256( shift, _mm256_and_si256( isPlus, _mm256_set1_epi8( 19 ) ) );
+		shift = _mm256_or_si256( shift, _mm256_and_si256( isSlash, _mm256_set1_epi8( 16 ) ) );
+		__m256i values = _mm256_add_epi8( chars, shift );
+
+		__m256i merged = _mm256_madd_epi16( _mm256_maddubs_epi16( values, mergePairs ), mergeQuads );
+		__m256i packed = _mm256_shuffle_epi8( merged, pack );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst ), _mm256_castsi256_si128( packed ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + 12 ), _mm256_extracti128_si256( packed, 1 ) );
+		consumed += 32;
+		dst += 24;
+	}
+	return consumed;
+}
+
+#endif
+
+} // anonymous namespace
+
+size_t getBase64DecodedSize( const char *data, size_t length )
+{
+	length = stripPadding( data, length );
+	return length / 4 * 3 + ( length % 4 ) * 3 / 4;
+}
+
+bool isBase64DecoderSupported( Base64Decoder decoder )
+{
+#if defined( GLTF_BASE64_X86 )
+	static const CpuFeatures sCpu;
+	switch( decoder ) {
+		case Base64Decoder::SSSE3: return sCpu.ssse3;
+		case Base64Decoder::AVX2: return sCpu.avx2;
+		default: return true;
+	}
+#else
+	return decoder == Base64Decoder::SCALAR;
+#endif
+}
+
+bool decodeBase64( const char *data, size_t length, uint8_t *dst )
+{
+	static const Base64Decoder sDecoder = isBase64DecoderSupported( Base64Decoder::AVX2 ) ? Base64Decoder::AVX2
+										: isBase64DecoderSupported( Base64Decoder::SSSE3 ) ? Base64Decoder::SSSE3 : Base64Decoder::SCALAR;
+	return decodeBase64( data, length, dst, sDecoder );
+}
+
+bool decodeBase64( const char *data, size_t length, uint8_t *dst, Base64Decoder decoder )
+{
+	length = stripPadding( data, length );
+	if( length % 4 == 1 )
+		return false;
+
+	const char *src = data;
+#if defined( GLTF_BASE64_X86 )
+	size_t consumed = 0;
+	if( decoder == Base64Decoder::AVX2 )
+		consumed = decodeAvx2( src, length, dst );
+	else if( decoder == Base64Decoder::SSSE3 )
+		consumed = decodeSsse3( src, length, dst );
+	src += consumed;
+	dst += consumed / 4 * 3;
+	length -= consumed;
+#else
+	( void )decoder;
+#endif
+
+	// the rest, and anything the kernels stopped at, which also reports invalid characters.
+	const auto &table = sDecodeTable.values;
+	for( ; length >= 4; length -= 4, src += 4, dst += 3 ) {
+		int a = table[static_cast<uint8_t>( src[0] )], b = table[static_cast<uint8_t>( src[1] )];
+		int c = table[static_cast<uint8_t>( src[2] )], d = table[static_cast<uint8_t>( src[3] )];
+		if( ( a | b | c | d ) < 0 )
+			return false;
+		uint32_t bits = ( a << 18 ) | ( b << 12 ) | ( c << 6 ) | d;
+		dst[0] = static_cast<uint8_t>( bits >> 16 );
+		dst[1] = static_cast<uint8_t>( bits >> 8 );
+		dst[2] = static_cast<uint8_t>( bits );
+	}
+	if( length > 0 ) {
+		int a = table[static_cast<uint8_t>( src[0] )], b = table[static_cast<uint8_t>( src[1] )];
+		int c = length > 2 ? table[static_cast<uint8_t>( src[2] )] : 0;
+		if( ( a | b | c ) < 0 )
+			return false;
+		uint32_t bits = ( a << 18 ) | ( b << 12 ) | ( c << 6 );
+		dst[0] = static_cast<uint8_t>( bits >> 16 );
+		if( length > 2 )
+			dst[1] = static_cast<uint8_t>( bits >> 8 );
+	}
+	return true;
+}
+
+ci::BufferRef decodeBase64( const char *data, size_t length )
+{
+	auto ret = ci::Buffer::create( getBase64DecodedSize( data, length ) );
+	if( ! decodeBase64( data, length, static_cast<uint8_t*>( ret->getData() ) ) )
+		return ci::BufferRef();
+	return ret;
+}
+
+} // namespace gltf
+} // namespace cinder
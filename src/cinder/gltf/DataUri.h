@@ -0,0 +1,42 @@
+//
+//  DataUri.h
+//  gltf
+//
+//  Decoding of embedded data: URIs straight from the JSON string storage.
+//
+
+#pragma once
+
+#include <string>
+
+#include "cinder/Buffer.h"
+
+namespace cinder {
+namespace gltf {
+
+//! Splits the data: URI [/a begin, /a end) at its comma. /a header receives everything before the
+//! comma, e.g. "data:image/png;base64". /a payload points at the first character after the comma.
+//! Returns false if the URI isn't a data: URI.
+bool	parseDataUri( const char *begin, const char *end, std::string *header, const char **payload );
+//! Returns the mime type of a data: URI /a header, e.g. "image/png" for "data:image/png;base64".
+std::string	getDataUriMimeType( const std::string &header );
+
+//! Returns the number of bytes the /a length base64 characters at /a data decode to.
+size_t	getBase64DecodedSize( const char *data, size_t length );
+//! Decodes /a length base64 characters at /a data into /a dst, which must hold at least
+//! getBase64DecodedSize() bytes. Uses AVX2 or SSSE3 when the CPU has them. Returns false if
+//! /a data isn't valid base64.
+bool	decodeBase64( const char *data, size_t length, uint8_t *dst );
+//! The decoders decodeBase64() chooses from. SCALAR is always available, the others decode
+//! blocks of characters with SIMD and leave the rest to SCALAR.
+enum class Base64Decoder { SCALAR, SSSE3, AVX2 };
+//! Returns whether the CPU can run /a decoder.
+bool	isBase64DecoderSupported( Base64Decoder decoder );
+//! Decodes like decodeBase64() above with /a decoder, which must be supported, to compare them.
+bool	decodeBase64( const char *data, size_t length, uint8_t *dst, Base64Decoder decoder );
+//! Decodes /a length base64 characters at /a data into a new Buffer. Returns a null ref if
+//! /a data isn't valid base64.
+ci::BufferRef	decodeBase64( const char *data, size_t length );
+
+} // namespace gltf
+} // namespace cinder
@@ -8,12 +8,23 @@
 
 #include "File.h"
 
+#include <exception>
+#include <mutex>
+
 #include "cinder/gl/Vbo.h"
 #include "cinder/Utilities.h"
 #include "cinder/Log.h"
 #include "cinder/DataSource.h"
-#include "cinder/Base64.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Surface.h"
 #include "cinder/Log.h"
+#include "cinder/Timer.h"
+
+#include "JsonStreamReader.h"
+#include "MappedFile.h"
+#include "DataUri.h"
+#include "ThreadPool.h"
+#include "ResourceCache.h"
 
 using namespace ci;
 using namespace ci::gl;
@@ -30,141 +41,654 @@ struct BinaryHeader {
 	uint32_t				sceneFormat;
 };
 	
-FileRef File::create( const ci::DataSourceRef &gltfFile )
+//! Header of every chunk following the 12 byte header of a glTF 2.0 .glb.
+struct BinaryChunkHeader {
+	uint32_t				length;
+	uint32_t				type;
+};
+	
+static const uint32_t BINARY_CHUNK_JSON = 0x4E4F534A; // "JSON"
+static const uint32_t BINARY_CHUNK_BIN = 0x004E4942; // "BIN\0"
+	
+//! Thrown to unwind an asynchronous load once its LoadRequest is canceled.
+struct LoadCanceled {};
+	
+LoadRequest::LoadRequest( ThreadPool::Priority priority )
+: mPriority( priority ), mPhase( static_cast<int>( Phase::QUEUED ) ), mDone( 0 ), mTotal( 0 ), mCanceled( false )
 {
-	return FileRef( new File( gltfFile ) );
 }
 	
-File::File( const ci::DataSourceRef &gltfFile )
-: mGltfPath( gltfFile->getFilePath().parent_path() )
+void LoadRequest::beginPhase( Phase phase, size_t total )
 {
-	std::string gltfJson;
-	verifyFile( gltfFile, gltfJson );
+	mDone = 0;
+	mTotal = total;
+	mPhase = static_cast<int>( phase );
+}
 	
-	Json::Features features;
-	features.allowComments_ = true;
-	features.strictRoot_ = true;
+float LoadRequest::getPhaseProgress() const
+{
+	size_t total = mTotal;
+	if( total == 0 )
+		return getPhase() >= Phase::DONE ? 1.0f : 0.0f;
+	return std::min( 1.0f, static_cast<float>( mDone ) / total );
+}
 	
-	Json::Reader reader( features );
+bool LoadRequest::isReady() const
+{
+	return mFile.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+}
+	
+FileRef LoadRequest::getFile()
+{
+	return ThreadPool::get().wait( mFile );
+}
+	
+FileRef File::create( const ci::DataSourceRef &gltfFile, const Options &options )
+{
+	return FileRef( new File( gltfFile, options ) );
+}
+	
+LoadRequestRef File::createAsync( const ci::DataSourceRef &gltfFile, const Options &options, ThreadPool::Priority priority )
+{
+	LoadRequestRef request( new LoadRequest( priority ) );
+	request->mFile = ThreadPool::get().submit( [gltfFile, options, request]() -> FileRef {
+		return createForRequest( gltfFile, options, request );
+	}, priority ).share();
+	return request;
+}
+	
+FileRef File::createForRequest( const ci::DataSourceRef &gltfFile, const Options &options, const LoadRequestRef &request )
+{
 	try {
-		reader.parse( gltfJson, mGltfTree );
+		FileRef ret( new File( gltfFile, options, request ) );
+		ret->prefetchBuffers( true );
+		ret->waitForImages();
+		ret->mRequest.reset();
+		request->beginPhase( LoadRequest::Phase::DONE, 0 );
+		return ret;
+	}
+	catch( const LoadCanceled & ) {
+		request->beginPhase( LoadRequest::Phase::CANCELED, 0 );
+	}
+	catch( const std::exception &e ) {
+		CI_LOG_E( "Error loading gltf file " << e.what() );
+		request->beginPhase( LoadRequest::Phase::FAILED, 0 );
+	}
+	return FileRef();
+}
+	
+File::File( const ci::DataSourceRef &gltfFile, const Options &options, const LoadRequestRef &request )
+: mGltfPath( gltfFile->getFilePath().parent_path() ), mLoadCounters( std::make_shared<LoadCounters>() ), mLiveJsonBytes( 0 ), mPeakJsonBytes( 0 ),
+	mLoadJsonBytes( 0 ), mVersion2( false ), mShareResources( options.getShareResources() ),
+	mSelectedScene( options.getSelectedScene() ), mSelectedNodes( options.getSelectedNodes() ),
+	mSelectedMeshes( options.getSelectedMeshes() ), mRequest( request )
+{
+	checkCanceled();
+	if( mRequest )
+		mRequest->beginPhase( LoadRequest::Phase::JSON, 0 );
+	
+	std::string gltfJson;
+	verifyFile( gltfFile, gltfJson, options.getMapBinary() );
+	
+	Timer parseTimer( true );
+	mParseStats.jsonBytes = gltfJson.size();
+	mParseStats.streamed = options.getStreamJson();
+	if( mParseStats.streamed ) {
+		// a malformed document throws out of here, so async and batch loads report it as FAILED.
+		loadStreamed( gltfJson, options.getParallel() );
+		mParseStats.peakJsonBytes = mPeakJsonBytes;
 	}
-	catch ( const std::runtime_error &e ) {
-		CI_LOG_E( "Error parsing gltf file " << e.what() );
+	else {
+		Json::Features features;
+		features.allowComments_ = true;
+		features.strictRoot_ = true;
+		
+		Json::Reader reader( features );
+		bool parsed;
+		{
+			LoadCounters::ScopedTimer timer( mLoadCounters->parseNanos );
+			parsed = reader.parse( gltfJson, mGltfTree );
+		}
+		if( ! parsed )
+			throw std::runtime_error( "Error parsing gltf file " + reader.getFormattedErrorMessages() );
+		if( ! mGltfTree.isObject() )
+			throw std::runtime_error( "glTF root must be an object" );
+	//	cout << mGltfTree.toStyledString() << endl;
+		mParseStats.peakJsonBytes = estimateJsonBytes( mGltfTree );
+		loadExtensions( mGltfTree["extensionsUsed"] );
+		if( ! mGltfTree["asset"].isNull() )
+			setAssetInfo( mGltfTree["asset"] );
+		load( options.getParallel() );
+		// everything that's read later was kept by keepRawJson().
+		if( options.getDiscardJson() )
+			Json::Value().swap( mGltfTree );
 	}
-//	cout << mGltfTree.toStyledString() << endl;
-	loadExtensions();
-	if( ! mGltfTree["asset"].isNull() )
-		setAssetInfo( mGltfTree["asset"] );
-	load();
+	mParseStats.parseSeconds = parseTimer.getSeconds();
+	
+	if( options.getPrefetchBuffers() )
+		prefetchBuffers( options.getParallel() );
+	
+	// the text is still held here, the Json::Values were held with it at their peak. The rest of
+	// the peak is added by getMemoryStats(), walking everything here would slow every load.
+	mLoadJsonBytes = gltfJson.size() + ( mParseStats.streamed ? mParseStats.peakJsonBytes : 0 );
 }
 	
-void File::verifyFile( const ci::DataSourceRef &data, std::string &gltfJson )
+File::File()
+: mLoadCounters( std::make_shared<LoadCounters>() ), mLiveJsonBytes( 0 ), mPeakJsonBytes( 0 ), mLoadJsonBytes( 0 ),
+	mVersion2( false ), mShareResources( false )
 {
+}
+	
+void File::verifyFile( const ci::DataSourceRef &data, std::string &gltfJson, bool mapBinary )
+{
+	LoadCounters::ScopedTimer timer( mLoadCounters->readNanos );
 	auto pathExtension = data->getFilePath().extension().string();
 	auto binary = pathExtension == ".glb";
 	if( binary ) {
-		auto buffer = data->getBuffer();
-		auto header = reinterpret_cast<BinaryHeader*>( buffer->getData() );
+		MappedFileRef mapping;
+		if( mapBinary && data->isFilePath() )
+			mapping = MappedFile::create( data->getFilePath() );
 		
-		auto sceneStart = reinterpret_cast<uint8_t*>( header + 1 );
-		gltfJson.append( sceneStart, sceneStart + header->sceneLength );
+		ci::BufferRef buffer;
+		const uint8_t *fileStart;
+		size_t fileSize;
+		if( mapping ) {
+			fileStart = mapping->getData();
+			fileSize = mapping->getSize();
+		}
+		else {
+			buffer = data->getBuffer();
+			fileStart = reinterpret_cast<const uint8_t*>( buffer->getData() );
+			fileSize = buffer->getSize();
+		}
+		mLoadCounters->fileBytes = fileSize;
+		// magic, version and length are common to both versions.
+		CI_ASSERT( fileSize >= 3 * sizeof( uint32_t ) );
+		auto header = reinterpret_cast<const BinaryHeader*>( fileStart );
 		
-		auto binaryStart = sceneStart + header->sceneLength;
-		auto binarySize = header->length - header->sceneLength - sizeof( BinaryHeader );
+		const uint8_t *binaryStart = nullptr;
+		size_t binarySize = 0;
+		if( header->version == 2 ) {
+			// The JSON chunk comes first, then an optional BIN chunk. Unknown chunks are skipped.
+			auto fileEnd = fileStart + std::min<size_t>( header->length, fileSize );
+			auto chunk = fileStart + 3 * sizeof( uint32_t );
+			while( chunk + sizeof( BinaryChunkHeader ) <= fileEnd ) {
+				auto chunkHeader = reinterpret_cast<const BinaryChunkHeader*>( chunk );
+				auto chunkStart = chunk + sizeof( BinaryChunkHeader );
+				if( chunkHeader->length > static_cast<size_t>( fileEnd - chunkStart ) ) {
+					CI_LOG_E( "Truncated chunk in glb file " << data->getFilePath() );
+					break;
+				}
+				if( chunkHeader->type == BINARY_CHUNK_JSON && gltfJson.empty() )
+					gltfJson.append( chunkStart, chunkStart + chunkHeader->length );
+				else if( chunkHeader->type == BINARY_CHUNK_BIN && ! binaryStart ) {
+					binaryStart = chunkStart;
+					binarySize = chunkHeader->length;
+				}
+				chunk = chunkStart + chunkHeader->length;
+			}
+			if( ! binaryStart )
+				return;
+		}
+		else {
+			CI_ASSERT( fileSize >= sizeof( BinaryHeader ) );
+			auto sceneStart = reinterpret_cast<const uint8_t*>( header + 1 );
+			gltfJson.append( sceneStart, sceneStart + header->sceneLength );
+			
+			binaryStart = sceneStart + header->sceneLength;
+			binarySize = header->length - header->sceneLength - sizeof( BinaryHeader );
+		}
 		
-		mBuffer = ci::Buffer::create( binarySize );
-		memcpy( mBuffer->getData(), binaryStart, binarySize );
+		if( mapping )
+			mBuffer = mapping->createBuffer( binaryStart - fileStart, binarySize );
+		else {
+			mBuffer = ci::Buffer::create( binarySize );
+			memcpy( mBuffer->getData(), binaryStart, binarySize );
+		}
 	}
-	else
+	else {
 		gltfJson = loadString( data );
+		mLoadCounters->fileBytes = gltfJson.size();
+	}
 }
 	
-void File::load()
+void File::load( bool parallel )
 {
-	auto gltfTypes = mGltfTree.getMemberNames();
-	auto hasMaterialsCommon = hasExtension( "KHR_materials_common" );
+	const auto &tree = mGltfTree;
+	std::vector<EntryList> collections;
+	auto gltfTypes = tree.getMemberNames();
 	for( auto &typeName : gltfTypes ) {
-		auto &typeObj = mGltfTree[typeName];
+		auto &typeObj = tree[typeName];
+		if( typeName == "scene" )
+			mDefaultScene = typeObj.isString() ? typeObj.asString() : std::to_string( typeObj.asUInt() );
+		else if( typeName == "extensions" ) {
+			if( mVersion2 && hasExtension( "KHR_lights_punctual" ) )
+				collections.emplace_back( indexTree( "lights", typeObj["KHR_lights_punctual"]["lights"] ) );
+			else if( hasExtension( "KHR_materials_common" ) )
+				collections.emplace_back( indexTree( "lights", typeObj["KHR_materials_common"]["lights"] ) );
+		}
+		else if( typeName != "extensionsUsed" && typeName != "asset" && ( typeObj.isObject() || typeObj.isArray() ) )
+			collections.emplace_back( indexTree( typeName, typeObj ) );
+	}
+	ingest( collections, parallel );
+}
+	
+void File::loadStreamed( const std::string &gltfJson, bool parallel )
+{
+	// Index the top level members by skipping over them, so that the collections can be
+	// ingested in the same (sorted) order as the Json::Value path regardless of document order.
+	std::map<std::string, JsonStreamReader::Range> members;
+	{
+		LoadCounters::ScopedTimer timer( mLoadCounters->parseNanos );
+		JsonStreamReader reader( gltfJson.data(), gltfJson.data() + gltfJson.size() );
+		if( ! reader.beginObject() )
+			throw std::runtime_error( "glTF root must be an object" );
+		std::string name;
+		while( reader.nextMember( &name ) )
+			members[name] = reader.skipValue();
+	}
+	
+	auto readMember = [&]( const std::string &memberName, Json::Value *value ) {
+		auto found = members.find( memberName );
+		if( found == members.end() )
+			return false;
+		JsonStreamReader( found->second ).readValue( value );
+		mPeakJsonBytes = std::max<size_t>( mPeakJsonBytes, estimateJsonBytes( *value ) );
+		return true;
+	};
+	
+	Json::Value value, extensions;
+	if( readMember( "extensionsUsed", &value ) )
+		loadExtensions( value );
+	if( readMember( "asset", &value ) )
+		setAssetInfo( value );
+	
+	std::vector<EntryList> collections;
+	for( auto &member : members ) {
+		auto &typeName = member.first;
 		if( typeName == "scene" ) {
-			mDefaultScene = typeObj.asString();
-			continue;
+			readMember( typeName, &value );
+			mDefaultScene = value.isString() ? value.asString() : std::to_string( value.asUInt() );
 		}
-		else if( typeName == "extensionsUsed" )
-			continue;
 		else if( typeName == "extensions" ) {
-			if( hasMaterialsCommon ) {
-				auto &lights = typeObj["KHR_materials_common"]["lights"];
-				auto lightKeys = lights.getMemberNames();
-				for ( auto &lightKey : lightKeys ) {
-					addLightInfo( lightKey, lights[lightKey] );
+			// extensions are small, and lights are only a handful of entries.
+			readMember( typeName, &extensions );
+			if( mVersion2 && hasExtension( "KHR_lights_punctual" ) )
+				collections.emplace_back( indexTree( "lights", extensions["KHR_lights_punctual"]["lights"] ) );
+			else if( hasExtension( "KHR_materials_common" ) )
+				collections.emplace_back( indexTree( "lights", extensions["KHR_materials_common"]["lights"] ) );
+		}
+		else if( typeName != "extensionsUsed" && typeName != "asset" ) {
+			// Only the key and byte range of every entry is gathered, entries are read when added.
+			JsonStreamReader collectionReader( member.second );
+			EntryList collection;
+			collection.typeName = typeName;
+			Entry entry;
+			if( mVersion2 ) {
+				// keyed by index, in document order so that every handle is its index.
+				if( ! collectionReader.beginArray() )
+					continue;
+				while( collectionReader.nextElement() ) {
+					entry.key = std::to_string( collection.entries.size() );
+					entry.range = collectionReader.skipValue();
+					collection.entries.push_back( entry );
+				}
+			}
+			else {
+				if( ! collectionReader.beginObject() )
+					continue;
+				while( collectionReader.nextMember( &entry.key ) ) {
+					entry.range = collectionReader.skipValue();
+					collection.entries.push_back( entry );
 				}
+				// keeps the Collection order the same as the Json::Value path, sorted by key.
+				std::sort( collection.entries.begin(), collection.entries.end(), []( const Entry &lhs, const Entry &rhs ) {
+					return lhs.key < rhs.key;
+				} );
 			}
+			collections.emplace_back( std::move( collection ) );
 		}
-		auto typeKeys = typeObj.getMemberNames();
-		for( auto &typeKey : typeKeys ) {
-			auto &obj = typeObj[typeKey];
-			if( typeName == "accessors" )
-				addAccessorInfo( typeKey, obj );
-			else if( typeName == "animations" )
-				addAnimationInfo( typeKey, obj );
-			else if( typeName == "bufferViews" )
-				addBufferViewInfo( typeKey, obj );
-			else if( typeName == "buffers" )
-				addBufferInfo( typeKey, obj );
-			else if( typeName == "cameras" )
-				addCameraInfo( typeKey, obj );
-			else if( typeName == "images" )
-				addImageInfo( typeKey, obj );
-			else if( typeName == "materials" )
-				addMaterialInfo( typeKey, obj );
-			else if( typeName == "meshes" )
-				addMeshInfo( typeKey, obj );
-			else if( typeName == "nodes" )
-				addNodeInfo( typeKey, obj );
-			else if( typeName == "programs" )
-				addProgramInfo( typeKey, obj );
-			else if( typeName == "samplers" )
-				addSamplerInfo( typeKey, obj );
-			else if( typeName == "scenes" )
-				addSceneInfo( typeKey, obj );
-			else if( typeName == "shaders" )
-				addShaderInfo( typeKey, obj );
-			else if( typeName == "skins" )
-				addSkinInfo( typeKey, obj );
-			else if( typeName == "techniques" )
-				addTechniqueInfo( typeKey, obj );
-			else if( typeName == "textures" )
-				addTextureInfo( typeKey, obj );
+	}
+	ingest( collections, parallel );
+}
+	
+File::EntryList File::indexTree( const std::string &typeName, const Json::Value &typeObj )
+{
+	EntryList ret;
+	ret.typeName = typeName;
+	if( typeObj.isArray() ) {
+		ret.entries.resize( typeObj.size() );
+		for( Json::ArrayIndex i = 0; i < typeObj.size(); i++ ) {
+			ret.entries[i].key = std::to_string( i );
+			ret.entries[i].value = &typeObj[i];
 		}
+		return ret;
+	}
+	auto typeKeys = typeObj.getMemberNames();
+	ret.entries.resize( typeKeys.size() );
+	for( size_t i = 0; i < typeKeys.size(); i++ ) {
+		ret.entries[i].key = typeKeys[i];
+		ret.entries[i].value = &typeObj[typeKeys[i]];
+	}
+	return ret;
+}
+	
+void File::ingest( std::vector<EntryList> &collections, bool parallel )
+{
+	if( ! mSelectedScene.empty() || ! mSelectedNodes.empty() || ! mSelectedMeshes.empty() )
+		selectEntries( collections );
+	
+	// Every slot exists before anything is added, so references resolve to stable addresses
+	// without inserting and each entry only ever writes to its own slot.
+	for( auto &collection : collections )
+		allocateSlots( collection );
+	
+	if( mRequest ) {
+		size_t numEntries = 0;
+		for( auto &collection : collections )
+			numEntries += collection.entries.size();
+		mRequest->beginPhase( LoadRequest::Phase::JSON, numEntries );
 	}
-	// setup heirarchy for traversal.
-	for( auto &scenes : mGltfTree["scenes"] ) {
-		for( auto & node : scenes["nodes"] ) {
-			setParentForChildren( nullptr, node.asString() );
+	
+	auto &pool = ThreadPool::get();
+	auto priority = getPriority();
+	auto ingestStart = LoadCounters::Clock::now();
+	// images and shaders read their BufferView when they're KHR_binary_glTF, so they go second.
+	for( int wave = 0; wave < 2; wave++ ) {
+		std::vector<std::future<void>> tasks;
+		// the first chunk to throw is rethrown once every chunk has finished.
+		std::mutex errorMutex;
+		std::exception_ptr firstError;
+		for( auto &collection : collections ) {
+			bool readsBufferViews = collection.typeName == "images" || collection.typeName == "shaders";
+			if( readsBufferViews != ( wave == 1 ) )
+				continue;
+			auto numEntries = collection.entries.size();
+			mParseStats.numEntries += numEntries;
+			if( ! parallel ) {
+				checkCanceled();
+				addEntries( collection, 0, numEntries );
+				if( mRequest )
+					mRequest->advance( numEntries );
+				continue;
+			}
+			// a few chunks per worker keeps the pool busy without paying per entry for a task.
+			auto chunkSize = std::max<size_t>( 8, numEntries / ( pool.getNumThreads() * 4 ) );
+			for( size_t begin = 0; begin < numEntries; begin += chunkSize ) {
+				auto end = std::min( begin + chunkSize, numEntries );
+				const auto *chunkCollection = &collection;
+				tasks.emplace_back( pool.submit( [this, chunkCollection, begin, end, &errorMutex, &firstError] {
+					if( mRequest && mRequest->isCanceled() )
+						return;
+					try {
+						addEntries( *chunkCollection, begin, end );
+					}
+					catch( ... ) {
+						std::lock_guard<std::mutex> lock( errorMutex );
+						if( ! firstError )
+							firstError = std::current_exception();
+						return;
+					}
+					if( mRequest )
+						mRequest->advance( end - begin );
+				}, priority ) );
+			}
 		}
+		// every task has to finish before the collections go away.
+		for( auto &task : tasks )
+			pool.wait( task );
+		if( firstError )
+			std::rethrow_exception( firstError );
+		checkCanceled();
 	}
+	mLoadCounters->ingestNanos += LoadCounters::nanosSince( ingestStart );
+	link();
 }
 	
-void File::setParentForChildren( Node *parent, const std::string &childKey )
+//! Allocates a slot in /a slots for every one of /a entries, in order. Keys are interned in /a symbols.
+template<typename T, typename Entries>
+static void allocateAll( Collection<T> &slots, const Entries &entries, SymbolTable &symbols )
 {
-	auto foundChild = mNodes.find( childKey );
-	auto &currentNode = foundChild->second;
-	currentNode.parent = parent;
-	if( parent )
-		parent->children.push_back( &currentNode );
-	auto children = mGltfTree["nodes"][childKey]["children"];
-	if( ! children.empty() ) {
-		for( auto & child : children ) {
-			setParentForChildren( &currentNode, child.asString() );
+	slots.reserve( slots.size() + entries.size() );
+	for( auto &entry : entries )
+		slots.allocate( symbols.intern( entry.key ) );
+}
+	
+void File::allocateSlots( const EntryList &collection )
+{
+	auto &typeName = collection.typeName;
+	if( typeName == "accessors" )			allocateAll( mAccessors, collection.entries, mSymbols );
+	else if( typeName == "animations" ) {
+		allocateAll( mAnimations, collection.entries, mSymbols );
+		if( mVersion2 )
+			mAnimationTargets.resize( collection.entries.size() );
+	}
+	else if( typeName == "bufferViews" )	allocateAll( mBufferViews, collection.entries, mSymbols );
+	else if( typeName == "buffers" )		allocateAll( mBuffers, collection.entries, mSymbols );
+	else if( typeName == "cameras" )		allocateAll( mCameras, collection.entries, mSymbols );
+	else if( typeName == "images" )			allocateAll( mImages, collection.entries, mSymbols );
+	else if( typeName == "lights" )			allocateAll( mLights, collection.entries, mSymbols );
+	else if( typeName == "materials" )		allocateAll( mMaterials, collection.entries, mSymbols );
+	else if( typeName == "meshes" )			allocateAll( mMeshes, collection.entries, mSymbols );
+	else if( typeName == "nodes" )			allocateAll( mNodes, collection.entries, mSymbols );
+	else if( typeName == "programs" )		allocateAll( mPrograms, collection.entries, mSymbols );
+	else if( typeName == "samplers" )		allocateAll( mSamplers, collection.entries, mSymbols );
+	else if( typeName == "scenes" )			allocateAll( mScenes, collection.entries, mSymbols );
+	else if( typeName == "shaders" )		allocateAll( mShaders, collection.entries, mSymbols );
+	else if( typeName == "skins" )			allocateAll( mSkins, collection.entries, mSymbols );
+	else if( typeName == "techniques" )		allocateAll( mTechniques, collection.entries, mSymbols );
+	else if( typeName == "textures" )		allocateAll( mTextures, collection.entries, mSymbols );
+}
+	
+void File::addEntries( const EntryList &collection, size_t begin, size_t end )
+{
+	// tallied once per call, a chunk is many entries.
+	auto start = LoadCounters::Clock::now();
+	size_t jsonBytes = 0;
+	for( size_t i = begin; i < end; i++ ) {
+		auto &entry = collection.entries[i];
+		if( ! entry.selected )
+			continue;
+		if( entry.value ) {
+			if( mVersion2 )
+				addInfoV2( collection.typeName, static_cast<uint32_t>( i ), entry.key, *entry.value );
+			else
+				addInfo( collection.typeName, entry.key, *entry.value );
+			keepRawJson( collection.typeName, entry.key, *entry.value );
+			continue;
 		}
+		// streamed, only this entry is held as a Json::Value.
+		Json::Value value;
+		JsonStreamReader( entry.range ).readValue( &value );
+		auto bytes = estimateJsonBytes( value );
+		auto live = mLiveJsonBytes += bytes;
+		auto peak = mPeakJsonBytes.load();
+		while( live > peak && ! mPeakJsonBytes.compare_exchange_weak( peak, live ) );
+		if( mVersion2 )
+			addInfoV2( collection.typeName, static_cast<uint32_t>( i ), entry.key, value );
+		else
+			addInfo( collection.typeName, entry.key, value );
+		keepRawJson( collection.typeName, entry.key, value );
+		mLiveJsonBytes -= bytes;
+		jsonBytes += entry.range.size();
 	}
+	mLoadCounters->addCollection( collection.typeName, end - begin, jsonBytes, LoadCounters::nanosSince( start ) );
+}
+	
+void File::addInfo( const std::string &typeName, const std::string &key, const Json::Value &val )
+{
+	if( typeName == "accessors" )
+		addAccessorInfo( key, val );
+	else if( typeName == "animations" )
+		addAnimationInfo( key, val );
+	else if( typeName == "bufferViews" )
+		addBufferViewInfo( key, val );
+	else if( typeName == "buffers" )
+		addBufferInfo( key, val );
+	else if( typeName == "cameras" )
+		addCameraInfo( key, val );
+	else if( typeName == "images" )
+		addImageInfo( key, val );
+	else if( typeName == "lights" )
+		addLightInfo( key, val );
+	else if( typeName == "materials" )
+		addMaterialInfo( key, val );
+	else if( typeName == "meshes" )
+		addMeshInfo( key, val );
+	else if( typeName == "nodes" )
+		addNodeInfo( key, val );
+	else if( typeName == "programs" )
+		addProgramInfo( key, val );
+	else if( typeName == "samplers" )
+		addSamplerInfo( key, val );
+	else if( typeName == "scenes" )
+		addSceneInfo( key, val );
+	else if( typeName == "shaders" )
+		addShaderInfo( key, val );
+	else if( typeName == "skins" )
+		addSkinInfo( key, val );
+	else if( typeName == "techniques" )
+		addTechniqueInfo( key, val );
+	else if( typeName == "textures" )
+		addTextureInfo( key, val );
+}
+	
+void File::addInfoV2( const std::string &typeName, uint32_t index, const std::string &key, const Json::Value &val )
+{
+	// cameras and samplers didn't change between versions.
+	if( typeName == "accessors" )
+		addAccessorInfoV2( index, key, val );
+	else if( typeName == "animations" )
+		addAnimationInfoV2( index, key, val );
+	else if( typeName == "bufferViews" )
+		addBufferViewInfoV2( index, key, val );
+	else if( typeName == "buffers" )
+		addBufferInfoV2( index, key, val );
+	else if( typeName == "cameras" )
+		addCameraInfo( key, val );
+	else if( typeName == "images" )
+		addImageInfoV2( index, key, val );
+	else if( typeName == "lights" )
+		addLightInfoV2( index, key, val );
+	else if( typeName == "materials" )
+		addMaterialInfoV2( index, key, val );
+	else if( typeName == "meshes" )
+		addMeshInfoV2( index, key, val );
+	else if( typeName == "nodes" )
+		addNodeInfoV2( index, key, val );
+	else if( typeName == "samplers" )
+		addSamplerInfo( key, val );
+	else if( typeName == "scenes" )
+		addSceneInfoV2( index, key, val );
+	else if( typeName == "skins" )
+		addSkinInfoV2( index, key, val );
+	else if( typeName == "textures" )
+		addTextureInfoV2( index, key, val );
+}
+	
+//! Returns whether File reads the extension /a name itself.
+static bool isInterpretedExtension( const std::string &name )
+{
+	return name == "KHR_binary_glTF" || name == "KHR_materials_common" || name == "KHR_lights_punctual";
+}
+	
+void File::keepRawJson( const std::string &typeName, const std::string &key, const Json::Value &val )
+{
+	if( ! val.isObject() )
+		return;
+	auto &extras = val["extras"];
+	auto &extensions = val["extensions"];
+	Json::Value uninterpreted;
+	if( extensions.isObject() ) {
+		for( auto &name : extensions.getMemberNames() ) {
+			if( ! isInterpretedExtension( name ) )
+				uninterpreted[name] = extensions[name];
+		}
+	}
+	if( extras.isNull() && uninterpreted.isNull() )
+		return;
+	
+	// written outside the lock, entries are added in parallel.
+	Json::FastWriter writer;
+	auto extrasText = extras.isNull() ? std::string() : writer.write( extras );
+	auto extensionsText = uninterpreted.isNull() ? std::string() : writer.write( uninterpreted );
+	
+	std::lock_guard<std::mutex> lock( mRawJsonMutex );
+	RawJson ret;
+	ret.extrasBegin = static_cast<uint32_t>( mRawJson.size() );
+	mRawJson += extrasText;
+	ret.extrasEnd = ret.extensionsBegin = static_cast<uint32_t>( mRawJson.size() );
+	mRawJson += extensionsText;
+	ret.extensionsEnd = static_cast<uint32_t>( mRawJson.size() );
+	mRawJsonEntries[typeName + "/" + key] = ret;
+}
+	
+Json::Value File::readRawJson( const char *typeName, const std::string &key, bool extras ) const
+{
+	Json::Value ret;
+	std::lock_guard<std::mutex> lock( mRawJsonMutex );
+	auto found = mRawJsonEntries.find( std::string( typeName ) + "/" + key );
+	if( found == mRawJsonEntries.end() )
+		return ret;
+	auto begin = extras ? found->second.extrasBegin : found->second.extensionsBegin;
+	auto end = extras ? found->second.extrasEnd : found->second.extensionsEnd;
+	if( begin != end )
+		JsonStreamReader( mRawJson.data() + begin, mRawJson.data() + end ).readValue( &ret );
+	return ret;
 }
 	
-void File::loadExtensions()
+void File::link()
 {
-	if( ! mGltfTree["extensionsUsed"].isNull() && mGltfTree["extensionsUsed"].isArray() ) {
-		auto &extensions = mGltfTree["extensionsUsed"];
+	LoadCounters::ScopedTimer timer( mLoadCounters->linkNanos );
+	linkNodes();
+	if( mVersion2 )
+		linkV2();
+}
+	
+void File::linkNodes()
+{
+	for( auto &nodeInfo : mNodes ) {
+		auto &node = nodeInfo;
+		// setup heirarchy for traversal.
+		for( auto child : node.children ) {
+			if( child->parent && child->parent != &node )
+				CI_LOG_W( "Node " << child->key << " has more than one parent" );
+			child->parent = &node;
+		}
+		if( node.camera )
+			node.camera->node = &node;
+	}
+	
+	// depth first with an explicit stack, children are pushed in reverse to keep document order.
+	mNodesParentFirst.clear();
+	mNodesParentFirst.reserve( mNodes.size() );
+	std::vector<bool> visited( mNodes.size(), false );
+	std::vector<const Node*> pending;
+	for( auto &root : mNodes ) {
+		if( ! root.isRoot() )
+			continue;
+		pending.push_back( &root );
+		while( ! pending.empty() ) {
+			auto node = pending.back();
+			pending.pop_back();
+			auto handle = node - mNodes.data();
+			if( visited[handle] )
+				continue;
+			visited[handle] = true;
+			mNodesParentFirst.push_back( node );
+			for( auto child = node->children.rbegin(); child != node->children.rend(); ++child ) {
+				if( (*child)->parent == node )
+					pending.push_back( *child );
+			}
+		}
+	}
+	if( mNodesParentFirst.size() != mNodes.size() )
+		CI_LOG_W( mNodes.size() - mNodesParentFirst.size() << " nodes are part of a cycle and unreachable from any root" );
+}
+	
+void File::loadExtensions( const Json::Value &extensions )
+{
+	if( ! extensions.isNull() && extensions.isArray() ) {
 		std::transform( begin( extensions ), end( extensions ), std::back_inserter( mExtensions ),
 		[]( const Json::Value &val ){ return val.asString(); } );
 		std::sort( begin( mExtensions ), end( mExtensions ) );
@@ -178,26 +702,35 @@ bool File::hasExtension( const std::string &extension ) const
 	
 const Scene& File::getDefaultScene() const
 {
-	if( ! mDefaultScene.empty() ) {
-		auto found = mScenes.find( mDefaultScene );
-		return found->second;
-	}
-	else {
-		auto found = mScenes.begin();
-		return found->second;
-	}
+	if( ! mDefaultScene.empty() )
+		return mScenes.at( mDefaultScene );
+	else
+		return *mScenes.begin();
+}
+	
+//! Returns the Accessor::Type spelled /a type, e.g. "VEC3".
+static Accessor::Type parseAccessorType( const std::string &type )
+{
+	if( type == "SCALAR" )	  return Accessor::Type::SCALAR;
+	else if( type == "VEC2" ) return Accessor::Type::VEC2;
+	else if( type == "VEC3" ) return Accessor::Type::VEC3;
+	else if( type == "VEC4" ) return Accessor::Type::VEC4;
+	else if( type == "MAT2" ) return Accessor::Type::MAT2;
+	else if( type == "MAT3" ) return Accessor::Type::MAT3;
+	else if( type == "MAT4" ) return Accessor::Type::MAT4;
+	CI_ASSERT_MSG( false, "Unknown data type" );
+	return Accessor::Type::SCALAR;
 }
 	
 const Accessor& File::getAccessorInfo( const std::string& key ) const
 {
-	auto found = mAccessors.find( key );
-	return found->second;
+	return mAccessors.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Accessor accessor )
 {
-	mAccessors[key] = move(accessor);
+	*resolve( mAccessors, key ) = move(accessor);
 }
 
 void File::addAccessorInfo( const std::string &key, const Json::Value &accessorInfo )
@@ -211,24 +744,14 @@ void File::addAccessorInfo( const std::string &key, const Json::Value &accessorI
 
 	Accessor ret;
 	auto bufferViewKey = accessorInfo["bufferView"].asString();
-	auto &bufferView = mBufferViews[bufferViewKey];
-	ret.bufferView = &bufferView;
+	ret.bufferView = resolve( mBufferViews, bufferViewKey );
 	ret.byteOffset = accessorInfo["byteOffset"].asUInt();
 	ret.count = accessorInfo["count"].asUInt();
 	
-	auto type = accessorInfo["type"].asString();
-	if( type == "SCALAR" )	  ret.dataType = Accessor::Type::SCALAR;
-	else if( type == "VEC2" ) ret.dataType = Accessor::Type::VEC2;
-	else if( type == "VEC3" ) ret.dataType = Accessor::Type::VEC3;
-	else if( type == "VEC4" ) ret.dataType = Accessor::Type::VEC4;
-	else if( type == "MAT2" ) ret.dataType = Accessor::Type::MAT2;
-	else if( type == "MAT3" ) ret.dataType = Accessor::Type::MAT3;
-	else if( type == "MAT4" ) ret.dataType = Accessor::Type::MAT4;
-	else					  CI_ASSERT_MSG( false, "Unknown data type" );
-	
+	ret.dataType = parseAccessorType( accessorInfo["type"].asString() );
 	ret.componentType = static_cast<Accessor::ComponentType>( accessorInfo["componentType"].asUInt() );
-	ret.name = accessorInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( accessorInfo["name"].asString() );
+	ret.key = intern( key );
 
 	if( !accessorInfo["byteStride"].isNull() )
 		ret.byteStride = accessorInfo["byteStride"].asUInt();
@@ -251,14 +774,13 @@ void File::addAccessorInfo( const std::string &key, const Json::Value &accessorI
 	
 const Animation& File::getAnimationInfo( const std::string &key ) const
 {
-	auto found = mAnimations.find( key );
-	return found->second;
+	return mAnimations.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Animation animation )
 {
-	mAnimations[key] = move( animation );
+	*resolve( mAnimations, key ) = move( animation );
 }
 
 void File::addAnimationInfo( const std::string &key, const Json::Value &animationInfo )
@@ -275,11 +797,10 @@ void File::addAnimationInfo( const std::string &key, const Json::Value &animatio
 
 		Animation::Channel animChannel;
 		auto targetNodeKey = target["id"].asString();
-		auto &targetNode = mNodes[targetNodeKey];
-		animChannel.targetId = targetNodeKey;
-		animChannel.target = &targetNode;
-		animChannel.sampler = channel["sampler"].asString();
-		animChannel.path = target["path"].asString();
+		animChannel.targetId = intern( targetNodeKey );
+		animChannel.target = resolve( mNodes, targetNodeKey );
+		animChannel.sampler = intern( channel["sampler"].asString() );
+		animChannel.path = intern( target["path"].asString() );
 		ret.channels.emplace_back( move( animChannel ) );
 	}
 	if( ret.channels.empty() )
@@ -293,8 +814,8 @@ void File::addAnimationInfo( const std::string &key, const Json::Value &animatio
 		CI_ASSERT( sampler["output"].isString() );
 		
 		Animation::Sampler animSampler;
-		animSampler.input = sampler["input"].asString();
-		animSampler.output = sampler["output"].asString();
+		animSampler.input = intern( sampler["input"].asString() );
+		animSampler.output = intern( sampler["output"].asString() );
 		if( sampler["interpolation"].isString() )
 			if( sampler["interpolation"].asString() == "LINEAR" )
 				animSampler.type = Animation::Sampler::LerpType::LINEAR;
@@ -302,22 +823,20 @@ void File::addAnimationInfo( const std::string &key, const Json::Value &animatio
 		ret.samplers.emplace_back( move( animSampler ) );
 	}
 
-	ret.name = animationInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( animationInfo["name"].asString() );
+	ret.key = intern( key );
 	auto &params = animationInfo["parameters"];
 	auto paramKeys = params.getMemberNames();
 	for( auto & key : paramKeys ) {
 		if( key == "TIME" ) {
 			auto accessorKey = params[key].asString();
-			auto &accessor = mAccessors[accessorKey];
-			ret.timeAccessor = &accessor;
+			ret.timeAccessor = resolve( mAccessors, accessorKey );
 		}
 		else {
 			auto accessorKey = params[key].asString();
-			auto &accessor = mAccessors[accessorKey];
 			Animation::Parameter param;
-			param.accessor = &accessor;
-			param.parameter = key;
+			param.accessor = resolve( mAccessors, accessorKey );
+			param.parameter = intern( key );
 			ret.parameters.emplace_back( move( param ) );
 		}
 	}
@@ -334,6 +853,7 @@ void File::setAssetInfo( const Json::Value &assetInfo )
 {
 	CI_ASSERT( ! assetInfo["version"].isNull() );
 	mAssetInfo.version = assetInfo["version"].asString();
+	mVersion2 = ! mAssetInfo.version.empty() && mAssetInfo.version[0] == '2';
 	
 	if( assetInfo["profile"].isObject() ) {
 		if( assetInfo["profile"]["api"].isString() )
@@ -347,16 +867,123 @@ void File::setAssetInfo( const Json::Value &assetInfo )
 	mAssetInfo.premultipliedAlpha = assetInfo["premultipliedAlpha"].asBool();
 }
 	
+void File::prefetchBuffers( bool parallel ) const
+{
+	if( mRequest )
+		mRequest->beginPhase( LoadRequest::Phase::BUFFERS, mBuffers.size() );
+	if( ! parallel ) {
+		for( auto &buffer : mBuffers ) {
+			checkCanceled();
+			buffer.prefetch();
+			if( mRequest )
+				mRequest->advance();
+		}
+		return;
+	}
+	
+	auto &pool = ThreadPool::get();
+	auto request = mRequest;
+	std::vector<std::future<void>> tasks;
+	for( auto &buffer : mBuffers ) {
+		const auto *toLoad = &buffer;
+		tasks.emplace_back( pool.submit( [toLoad, request] {
+			if( request && request->isCanceled() )
+				return;
+			toLoad->prefetch();
+			if( request )
+				request->advance();
+		}, getPriority() ) );
+	}
+	for( auto &task : tasks )
+		pool.wait( task );
+	checkCanceled();
+}
+	
+void File::waitForImages() const
+{
+	if( mRequest )
+		mRequest->beginPhase( LoadRequest::Phase::IMAGES, mImages.size() );
+	for( auto &image : mImages ) {
+		checkCanceled();
+		image.cacheData();
+		if( mRequest )
+			mRequest->advance();
+	}
+}
+	
+File::MemoryStats File::getMemoryStats() const
+{
+	MemoryStats ret;
+	// the tree is estimated once right after parsing, it isn't modified after.
+	if( ! mParseStats.streamed && ! mGltfTree.isNull() )
+		ret.jsonTreeBytes = mParseStats.peakJsonBytes;
+	if( mBuffer )
+		ret.binaryBodyBytes = mBuffer->getSize();
+	
+	for( auto &buffer : mBuffers ) {
+		auto data = std::atomic_load( &buffer.data );
+		if( ! data || data == mBuffer )
+			continue;
+		MemoryStats::Resource resource;
+		resource.key = buffer.key.str();
+		resource.bytes = data->getSize();
+		resource.shared = buffer.shared;
+		ret.bufferBytes += resource.bytes;
+		ret.buffers.push_back( resource );
+	}
+	for( auto &image : mImages ) {
+		if( ! image.imageSource.valid() || ! image.isReady() )
+			continue;
+		auto decoded = image.imageSource.get();
+		if( ! decoded )
+			continue;
+		// decoded into a Surface8u, 3 or 4 channels.
+		MemoryStats::Resource resource;
+		resource.key = image.key.str();
+		resource.bytes = static_cast<size_t>( decoded->getWidth() ) * decoded->getHeight() * ( decoded->hasAlpha() ? 4 : 3 );
+		resource.shared = image.shared;
+		ret.imageBytes += resource.bytes;
+		ret.images.push_back( resource );
+	}
+	for( auto &shader : mShaders )
+		ret.shaderBytes += shader.source.capacity();
+	
+	ret.collectionBytes = mAccessors.getNumBytes() + mAnimations.getNumBytes() + mBufferViews.getNumBytes()
+		+ mBuffers.getNumBytes() + mCameras.getNumBytes() + mImages.getNumBytes() + mLights.getNumBytes()
+		+ mMaterials.getNumBytes() + mMeshes.getNumBytes() + mNodes.getNumBytes() + mPrograms.getNumBytes()
+		+ mSamplers.getNumBytes() + mScenes.getNumBytes() + mShaders.getNumBytes() + mSkins.getNumBytes()
+		+ mTechniques.getNumBytes() + mTextures.getNumBytes();
+	ret.symbolBytes = mSymbols.getNumBytes();
+	{
+		std::lock_guard<std::mutex> lock( mRawJsonMutex );
+		ret.rawJsonBytes = mRawJson.capacity() + mRawJsonEntries.size() * sizeof( RawJson );
+		for( auto &entry : mRawJsonEntries )
+			ret.rawJsonBytes += entry.first.capacity();
+	}
+	ret.peakLoadBytes = ret.getTotalBytes() + mLoadJsonBytes;
+	return ret;
+}
+	
+void File::checkCanceled() const
+{
+	if( mRequest && mRequest->isCanceled() )
+		throw LoadCanceled();
+}
+	
+ThreadPool::Priority File::getPriority() const
+{
+	return mRequest ? mRequest->getPriority() : ThreadPool::Priority::NORMAL;
+}
+	
 const gltf::Buffer& File::getBufferInfo( const std::string &name ) const
 {
-	auto found = mBuffers.find( name );
-	return found->second;
+	return mBuffers.at( name );
 }
 	
 template<>
 void File::add( const std::string &key, gltf::Buffer buffer )
 {
-	mBuffers[key] = move( buffer );
+	*resolve( mBuffers, key ) = move( buffer );
 }
 	
 void File::addBufferInfo( const std::string &key, const Json::Value &bufferInfo )
@@ -364,40 +991,49 @@ void File::addBufferInfo( const std::string &key, const Json::Value &bufferInfo
 	CI_ASSERT( bufferInfo["uri"].isString() );
 	
 	gltf::Buffer ret;
-	auto uri = bufferInfo["uri"].asString();
-	
-	auto pos = uri.find_first_of(',');
-	if( pos != std::string::npos ) {
-		ret.uri = uri.substr( 0, pos );
-		auto data = uri.substr( pos + 1, uri.size() );
-		auto buffer = fromBase64( data );
-		ret.data = BufferRef( new ci::Buffer( std::move( buffer ) ) );
+	// decoded straight from the Json::Value's storage, embedded buffers can be many MB of text.
+	auto uriBegin = bufferInfo["uri"].asCString();
+	auto uriEnd = uriBegin + strlen( uriBegin );
+	const char *payload;
+	if( key == "binary_glTF" ) {
+		ret.uri = bufferInfo["uri"].asString();
+		ret.data = mBuffer;
 	}
-	else {
-		if( key == "binary_glTF" )
-			ret.data = mBuffer;
+	else if( parseDataUri( uriBegin, uriEnd, &ret.uri, &payload ) ) {
+		{
+			LoadCounters::ScopedTimer timer( mLoadCounters->base64Nanos );
+			ret.data = decodeBase64( payload, uriEnd - payload );
+		}
+		if( ret.data )
+			mLoadCounters->base64Bytes += ret.data->getSize();
 		else
-			ret.data = loadFile( mGltfPath / uri )->getBuffer();
+			CI_LOG_E( "Invalid base64 data in buffer " << key );
+	}
+	else {
+		ret.uri = bufferInfo["uri"].asString();
+		// External buffers are loaded on first use, see Buffer::getBuffer().
+		ret.path = mGltfPath / ret.uri;
+		ret.shared = mShareResources;
+		ret.counters = mLoadCounters;
 	}
 	
 	ret.type = bufferInfo["type"].asString();
 	ret.byteLength = bufferInfo["byteLength"].asUInt();
-	ret.name = bufferInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( bufferInfo["name"].asString() );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 
 const BufferView& File::getBufferViewInfo( const std::string &name ) const
 {
-	auto found = mBufferViews.find( name );
-	return found->second;
+	return mBufferViews.at( name );
 }
 	
 template<>
 void File::add( const std::string &key, gltf::BufferView bufferView )
 {
-	mBufferViews[key] = move( bufferView );
+	*resolve( mBufferViews, key ) = move( bufferView );
 }
 
 void File::addBufferViewInfo( const std::string &key, const Json::Value &bufferViewInfo )
@@ -407,27 +1043,25 @@ void File::addBufferViewInfo( const std::string &key, const Json::Value &bufferV
 	
 	BufferView ret;
 	auto bufferKey = bufferViewInfo["buffer"].asString();
-	auto &buffer = mBuffers[bufferKey];
-	ret.buffer = &buffer;
+	ret.buffer = resolve( mBuffers, bufferKey );
 	ret.byteOffset = bufferViewInfo["byteOffset"].asUInt();
 	ret.byteLength = bufferViewInfo["byteLength"].asUInt();
 	ret.target = static_cast<BufferView::Target>( bufferViewInfo["target"].asUInt() );
-	ret.name = bufferViewInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( bufferViewInfo["name"].asString() );
+	ret.key = intern( key );
 	
 	add( key, ret );
 }
 	
 const Camera& File::getCameraInfo( const std::string &key ) const
 {
-	auto found = mCameras.find( key );
-	return found->second;
+	return mCameras.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Camera camera )
 {
-	mCameras[key] = move( camera );
+	*resolve( mCameras, key ) = move( camera );
 }
 	
 void File::addCameraInfo( const std::string &key, const Json::Value &cameraInfo )
@@ -462,22 +1096,21 @@ void File::addCameraInfo( const std::string &key, const Json::Value &cameraInfo
 		ret.znear = orthographicInfo["znear"].asFloat();
 		ret.zfar = orthographicInfo["zfar"].asFloat();
 	}
-	ret.name = cameraInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( cameraInfo["name"].asString() );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 	
 const Image& File::getImageInfo( const std::string &key ) const
 {
-	auto found = mImages.find( key );
-	return found->second;
+	return mImages.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Image image )
 {
-	mImages[key] = move( image );
+	*resolve( mImages, key ) = move( image );
 }
 	
 void File::addImageInfo( const std::string &key, const Json::Value &imageInfo )
@@ -485,58 +1118,115 @@ void File::addImageInfo( const std::string &key, const Json::Value &imageInfo )
 	CI_ASSERT( imageInfo["uri"].isString() );
 	
 	Image ret;
-	ret.uri = imageInfo["uri"].asString();
-	ret.name = imageInfo["name"].asString();
-	ret.key = key;
-	
-	// in embedded use this to look at type
-	size_t dataUri = ret.uri.find( "data:" );
-	
-	if( dataUri != std::string::npos  ) {
+	ret.name = intern( imageInfo["name"].asString() );
+	ret.key = intern( key );
+	
+	auto uriBegin = imageInfo["uri"].asCString();
+	auto uriEnd = uriBegin + strlen( uriBegin );
+	const char *payload;
+	ci::DataSourceRef source;
+	std::string extension;
+	// only the header of embedded images is kept, the data is decoded straight from the Json::Value.
+	if( parseDataUri( uriBegin, uriEnd, &ret.uri, &payload ) ) {
 		auto binaryExt = imageInfo["extensions"]["KHR_binary_glTF"];
-		std::string extension;
 		ci::BufferRef buf;
+		std::string mimeType;
 		if( ! binaryExt.isNull() ) {
-			auto binaryExt = imageInfo["extensions"]["KHR_binary_glTF"];
-			auto bufferView = binaryExt["bufferView"].asString();
+			auto bufferViewKey = binaryExt["bufferView"].asString();
 			// auto size = ivec2( binaryExt["width"].asUInt(), binaryExt["height"].asUInt() );
-			extension = binaryExt["mimeType"].asString();
-			auto &bufferViewInfo = mGltfTree["bufferViews"][bufferView];
-			auto byteOffset = bufferViewInfo["byteOffset"].asUInt();
-			auto byteLength = bufferViewInfo["byteLength"].asUInt();
-			auto bufferName = bufferViewInfo["buffer"].asString();
-			buf->setSize( byteLength );
-			memcpy( buf->getData(), reinterpret_cast<uint8_t*>(mBuffer->getData()) + byteOffset, byteLength );
+			mimeType = binaryExt["mimeType"].asString();
+			// bufferViews are always added before images, see ingest().
+			auto bufferView = resolve( mBufferViews, bufferViewKey );
+			CI_ASSERT( bufferView );
+			// Reference the bytes in place, the deleter keeps the binary body alive.
+			auto body = mBuffer;
+			auto imageStart = reinterpret_cast<uint8_t*>( body->getData() ) + bufferView->byteOffset;
+			buf = ci::BufferRef( new ci::Buffer( imageStart, bufferView->byteLength ), [body]( ci::Buffer *imageBuffer ) {
+				delete imageBuffer;
+			} );
 		}
 		else {
-			dataUri += 5; // past data
-			auto beginning = ret.uri.find('/');
-			auto end = ret.uri.find( ';' );
-			auto typeStr = ret.uri.substr( beginning + 1, end );
-			if( typeStr == "image/png" ) extension = "png";
-			else if( typeStr == "image/jpeg" ) extension = "jpeg";
-			auto dataBegin = ret.uri.find( ',' ) + 1;
-			auto len = ret.uri.size() - dataBegin;
-			buf = ci::BufferRef( new ci::Buffer( fromBase64( &ret.uri[dataBegin], len ) ) );
+			mimeType = getDataUriMimeType( ret.uri );
+			{
+				LoadCounters::ScopedTimer timer( mLoadCounters->base64Nanos );
+				buf = decodeBase64( payload, uriEnd - payload );
+			}
+			if( buf )
+				mLoadCounters->base64Bytes += buf->getSize();
+			else
+				CI_LOG_E( "Invalid base64 data in image " << key );
 		}
-		ret.imageSource = ci::loadImage( DataSourceBuffer::create( buf ), ImageSource::Options(), extension );
+		// image/png -> png
+		auto slash = mimeType.find( '/' );
+		if( slash != std::string::npos )
+			extension = mimeType.substr( slash + 1 );
+		if( buf )
+			source = DataSourceBuffer::create( buf );
+	}
+	else {
+		ret.uri = imageInfo["uri"].asString();
+		if( mShareResources ) {
+			// Read and decoded on the pool once for every File referencing it. Never skipped when
+			// the request is canceled, other Files may be waiting on it.
+			auto path = mGltfPath / ret.uri;
+			auto imageKey = key;
+			auto counters = mLoadCounters;
+			ret.shared = true;
+			ret.imageSource = ResourceCache::get().loadImage( path, [path, imageKey, counters]() -> ci::ImageSourceRef {
+				try {
+					LoadCounters::ScopedTimer timer( counters->imageDecodeNanos );
+					ci::ImageSourceRef image = ci::Surface8u( ci::loadImage( loadFile( path ) ) );
+					counters->numImagesDecoded++;
+					return image;
+				}
+				catch( const std::exception &e ) {
+					CI_LOG_E( "Couldn't decode image " << imageKey << ": " << e.what() );
+					return ci::ImageSourceRef();
+				}
+			}, getPriority() );
+		}
+		else
+			source = loadFile( mGltfPath / ret.uri );
 	}
-	else
-		ret.imageSource = loadImage( loadFile( mGltfPath / ret.uri ) );
 	
+	if( source )
+		decodeImage( ret, source, extension );
 	add( key, move( ret ) );
 }
 	
+void File::decodeImage( Image &image, const ci::DataSourceRef &source, const std::string &extension )
+{
+	// Decode on the pool straight away, Image::getImage() only blocks if it isn't done yet. The
+	// pixels are decoded into a Surface, as the ImageSource alone may defer decoding until read.
+	auto imageKey = image.key.str();
+	std::weak_ptr<LoadRequest> request = mRequest;
+	auto counters = mLoadCounters;
+	image.imageSource = ThreadPool::get().submit( [source, extension, imageKey, request, counters]() -> ci::ImageSourceRef {
+		auto owner = request.lock();
+		if( owner && owner->isCanceled() )
+			return ci::ImageSourceRef();
+		try {
+			LoadCounters::ScopedTimer timer( counters->imageDecodeNanos );
+			ci::ImageSourceRef decoded = ci::Surface8u( ci::loadImage( source, ImageSource::Options(), extension ) );
+			counters->numImagesDecoded++;
+			return decoded;
+		}
+		catch( const std::exception &e ) {
+			CI_LOG_E( "Couldn't decode image " << imageKey << ": " << e.what() );
+			return ci::ImageSourceRef();
+		}
+	}, getPriority() ).share();
+}
+	
 const Light& File::getLightInfo( const std::string &key ) const
 {
-	auto found = mLights.find( key );
-	return found->second;
+	return mLights.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Light light )
 {
-	mLights[key] = move( light );
+	*resolve( mLights, key ) = move( light );
 }
 	
 void File::addLightInfo( const std::string &key, const Json::Value &val )
@@ -574,22 +1264,21 @@ void File::addLightInfo( const std::string &key, const Json::Value &val )
 			ret.falloffExponent = lightTypeInfo["falloffExponent"].asFloat();
 		}
 	}
-	ret.name = key;
-	ret.key = key;
+	ret.name = intern( key );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 	
 const Material& File::getMaterialInfo( const std::string &key ) const
 {
-	auto found = mMaterials.find( key );
-	return found->second;
+	return mMaterials.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Material material )
 {
-	mMaterials[key] = move( material );
+	*resolve( mMaterials, key ) = move( material );
 }
 	
 void File::addMaterialInfo( const std::string &key, const Json::Value &materialInfo )
@@ -599,9 +1288,11 @@ void File::addMaterialInfo( const std::string &key, const Json::Value &materialI
 	auto &materialExt = materialInfo["extensions"]["KHR_materials_common"];
 	auto &material = materialExt.isNull() ? materialInfo : materialExt;
 	
-	auto techKey = material["technique"].asString();
-	auto &technique = mTechniques[techKey];
-	ret.technique = &technique;
+	// KHR_materials_common names a lighting model (BLINN, PHONG...) rather than a technique.
+	if( materialExt.isNull() && material["technique"].isString() ) {
+		auto techKey = material["technique"].asString();
+		ret.technique = resolve( mTechniques, techKey );
+	}
 	
 	auto &values = material["values"];
 	auto valueKeys = material["values"].getMemberNames();
@@ -635,8 +1326,7 @@ void File::addMaterialInfo( const std::string &key, const Json::Value &materialI
 			}
 			else if( source.isString() ) {
 				auto sourceKey = source.asString();
-				auto &texture = mTextures[sourceKey];
-				src.texture = &texture;
+				src.texture = resolve( mTextures, sourceKey );
 			}
 			
 			ret.sources.emplace_back( move( src ) );
@@ -661,22 +1351,21 @@ void File::addMaterialInfo( const std::string &key, const Json::Value &materialI
 		}
 	}
 	
-	ret.name = materialInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( materialInfo["name"].asString() );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 	
 const Mesh& File::getMeshInfo( const std::string &key ) const
 {
-	auto found = mMeshes.find( key );
-	return found->second;
+	return mMeshes.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Mesh mesh )
 {
-	mMeshes[key] = move( mesh );
+	*resolve( mMeshes, key ) = move( mesh );
 }
 	
 void File::addMeshInfo( const std::string &key, const Json::Value &meshInfo )
@@ -687,13 +1376,10 @@ void File::addMeshInfo( const std::string &key, const Json::Value &meshInfo )
 		
 		Mesh::Primitive meshPrim;
 		auto materialKey = primitive["material"].asString();
-		auto &material = mMaterials[materialKey];
-		
-		meshPrim.material = &material;
+		meshPrim.material = resolve( mMaterials, materialKey );
 		auto indicesAccessor = primitive["indices"].asString();
 		if( ! indicesAccessor.empty() ) {
-			auto &accessor = mAccessors[indicesAccessor];
-			meshPrim.indices = &accessor;
+			meshPrim.indices = resolve( mAccessors, indicesAccessor );
 		}
 		meshPrim.primitive = primitive["mode"].asUInt();
 		
@@ -704,124 +1390,121 @@ void File::addMeshInfo( const std::string &key, const Json::Value &meshInfo )
 			Mesh::Primitive::AttribAccessor attrib;
 			attrib.attrib = Mesh::getAttribEnum( attribName );
 			auto accessorKey = attributes[attribName].asString();
-			auto &attribAccessor = mAccessors[accessorKey];
-			attrib.accessor = &attribAccessor;
+			attrib.accessor = resolve( mAccessors, accessorKey );
 			meshPrim.attributes.emplace_back( move( attrib ) );
 		}
 		
 		ret.primitives.emplace_back( move( meshPrim ) );
 	}
-	ret.name = meshInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( meshInfo["name"].asString() );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 	
 const Node& File::getNodeInfo( const std::string &key ) const
 {
-	auto found = mNodes.find( key );
-	return found->second;
+	return mNodes.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Node node )
 {
-	mNodes[key] = move( node );
+	*resolve( mNodes, key ) = move( node );
 }
 	
-void File::addNodeInfo( const std::string &key, const Json::Value &nodeInfo )
+//! Reads either the matrix or the translation, rotation and scale of /a nodeInfo into /a node.
+static void readNodeTransform( const Json::Value &nodeInfo, Node *node )
 {
-	Node ret;
-	
 	if( ! nodeInfo["matrix"].isNull() ) {
-		auto matrix = nodeInfo["matrix"];
-		ret.transformMatrix.reserve( 16 );
+		auto &matrix = nodeInfo["matrix"];
+		node->transformMatrix.reserve( 16 );
 		for( auto & matVal : matrix ) {
-			ret.transformMatrix.push_back( matVal.asFloat() );
+			node->transformMatrix.push_back( matVal.asFloat() );
 		}
 	}
 	else {
 		if( ! nodeInfo["translation"].isNull() ) {
-			auto transArray = nodeInfo["translation"];
-			ret.translation.reserve( 3 );
+			auto &transArray = nodeInfo["translation"];
+			node->translation.reserve( 3 );
 			for( auto & transVal : transArray )
-				ret.translation.push_back( transVal.asFloat() );
+				node->translation.push_back( transVal.asFloat() );
 		}
 		if( ! nodeInfo["rotation"].isNull() ) {
-			auto rotArray = nodeInfo["rotation"];
-			ret.rotation.reserve( 4 );
+			auto &rotArray = nodeInfo["rotation"];
+			node->rotation.reserve( 4 );
 			for( auto & rotVal : rotArray )
-				ret.rotation.push_back( rotVal.asFloat() );
+				node->rotation.push_back( rotVal.asFloat() );
 		}
 		if( ! nodeInfo["scale"].isNull() ) {
-			auto & scaleArray = nodeInfo["scale"];
-			ret.scale.reserve( 3 );
+			auto &scaleArray = nodeInfo["scale"];
+			node->scale.reserve( 3 );
 			for( auto & scaleVal : scaleArray )
-				ret.scale.push_back( scaleVal.asFloat() );
+				node->scale.push_back( scaleVal.asFloat() );
 		}
 	}
+}
+	
+void File::addNodeInfo( const std::string &key, const Json::Value &nodeInfo )
+{
+	Node ret;
+	readNodeTransform( nodeInfo, &ret );
 	
 	if( ! nodeInfo["extensions"].isNull() ) {
 		auto &ext = nodeInfo["extensions"];
 		if( ! ext["KHR_materials_common"].isNull() ) {
 			auto lightKey = ext["KHR_materials_common"]["light"].asString();
-			auto &light = mLights[lightKey];
-			ret.light = &light;
+			ret.light = resolve( mLights, lightKey );
 		}
 	}
 	else if( ! nodeInfo["camera"].isNull() ) {
 		auto cameraKey = nodeInfo["camera"].asString();
-		auto &camera = mCameras[cameraKey];
-		ret.camera = &camera;
-		camera.node = &ret;
+		ret.camera = resolve( mCameras, cameraKey );
 	}
 	else if( ! nodeInfo["jointName"].isNull() ) {
-		ret.jointName = nodeInfo["jointName"].asString();
+		ret.jointName = intern( nodeInfo["jointName"].asString() );
 	}
 	else {
 		if( ! nodeInfo["meshes"].isNull() ) {
 			for( auto &meshInfo : nodeInfo["meshes"] ) {
 				auto meshKey = meshInfo.asString();
-				auto &mesh = mMeshes[meshKey];
-				ret.meshes.push_back( &mesh );
+				ret.meshes.push_back( resolve( mMeshes, meshKey ) );
 			}
 		}
 		if( ! nodeInfo["skin"].isNull() ) {
 			auto skinKey = nodeInfo["skin"].asString();
-			auto &skin = mSkins[skinKey];
-			ret.skin = &skin;
+			ret.skin = resolve( mSkins, skinKey );
 		}
 		if( ! nodeInfo["skeletons"].isNull() ) {
 			for( auto &skeletonInfo : nodeInfo["skeletons"] ) {
 				auto skeletonRootKey = skeletonInfo.asString();
-				auto &skeleton = mNodes[skeletonRootKey];
-				ret.skeletons.push_back( &skeleton );
+				ret.skeletons.push_back( resolve( mNodes, skeletonRootKey ) );
 			}
 		}
 	}
 	
-//	if( ! nodeInfo["children"].isNull() ) {
-//		for( auto &childInfo : nodeInfo["children"] ) {
-//			auto childKey
-//		}
-//	}
+	// parents are linked once every node is added, see link().
+	for( auto &childInfo : nodeInfo["children"] ) {
+		auto child = resolve( mNodes, childInfo.asString() );
+		if( child )
+			ret.children.push_back( child );
+	}
 	
-	ret.name = nodeInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( nodeInfo["name"].asString() );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 	
 const Program& File::getProgramInfo( const std::string &key ) const
 {
-	auto found = mPrograms.find( key );
-	return found->second;
+	return mPrograms.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Program program )
 {
-	mPrograms[key] = move( program );
+	*resolve( mPrograms, key ) = move( program );
 }
 	
 void File::addProgramInfo( const std::string &key, const Json::Value &programInfo )
@@ -831,32 +1514,29 @@ void File::addProgramInfo( const std::string &key, const Json::Value &programInf
 	
 	Program ret;
 	auto vertShaderKey = programInfo["vertexShader"].asString();
-	auto &vertShader = mShaders[vertShaderKey];
-	ret.vert = &vertShader;
+	ret.vert = resolve( mShaders, vertShaderKey );
 	auto fragShaderKey = programInfo["fragmentShader"].asString();
-	auto &fragShader = mShaders[fragShaderKey];
-	ret.frag = &fragShader;
+	ret.frag = resolve( mShaders, fragShaderKey );
 	
 	auto &attributes = programInfo["attributes"];
 	for( auto & attribute : attributes )
-		ret.attributes.push_back( attribute.asString() );
+		ret.attributes.push_back( intern( attribute.asString() ) );
 	
-	ret.name = programInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( programInfo["name"].asString() );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 
 const Sampler& File::getSamplerInfo( const std::string &key ) const
 {
-	auto found = mSamplers.find( key );
-	return found->second;
+	return mSamplers.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Sampler sampler )
 {
-	mSamplers[key] = move( sampler );
+	*resolve( mSamplers, key ) = move( sampler );
 }
 	
 void File::addSamplerInfo( const std::string &key, const Json::Value &samplerInfo )
@@ -872,22 +1552,21 @@ void File::addSamplerInfo( const std::string &key, const Json::Value &samplerInf
 	if( samplerInfo["wrapT"].isNumeric() )
 		ret.wrapT = samplerInfo["wrapT"].asUInt();
 	
-	ret.name = samplerInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( samplerInfo["name"].asString() );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 	
 const Scene& File::getSceneInfo( const std::string &key ) const
 {
-	auto found = mScenes.find( key );
-	return found->second;
+	return mScenes.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Scene scene )
 {
-	mScenes[key] = move( scene );
+	*resolve( mScenes, key ) = move( scene );
 }
 	
 void File::addSceneInfo( const std::string &key, const Json::Value &sceneInfo )
@@ -899,26 +1578,24 @@ void File::addSceneInfo( const std::string &key, const Json::Value &sceneInfo )
 	int i = 0;
 	for( auto & node : nodes ) {
 		auto nodeKey = node.asString();
-		auto &nodeInst = mNodes[nodeKey];
-		ret.nodes[i++] = &nodeInst;
+		ret.nodes[i++] = resolve( mNodes, nodeKey );
 	}
 	
-	ret.name = sceneInfo["names"].asString();
-	ret.key = key;
+	ret.name = intern( sceneInfo["names"].asString() );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 	
 const Shader& File::getShaderInfo( const std::string &key ) const
 {
-	auto found = mShaders.find( key );
-	return found->second;
+	return mShaders.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Shader shader )
 {
-	mShaders[key] = move( shader );
+	*resolve( mShaders, key ) = move( shader );
 }
 	
 void File::addShaderInfo( const std::string &key, const Json::Value &shaderInfo )
@@ -928,48 +1605,51 @@ void File::addShaderInfo( const std::string &key, const Json::Value &shaderInfo
 	
 	Shader ret;
 	
-	auto uri = shaderInfo["uri"].asString();
+	auto uriBegin = shaderInfo["uri"].asCString();
+	auto uriEnd = uriBegin + strlen( uriBegin );
+	const char *payload;
 	
 	// either it's embeded, binary, or separate
 	
-	auto pos = uri.find(",");
-	if( pos != std::string::npos ) {
-		if( pos + 1 == uri.size() && hasExtension( "KHR_binary_glTF" ) ) {
+	if( parseDataUri( uriBegin, uriEnd, &ret.uri, &payload ) ) {
+		if( payload == uriEnd && hasExtension( "KHR_binary_glTF" ) ) {
 			auto binaryExt = shaderInfo["extensions"]["KHR_binary_glTF"];
-			auto bufferView = binaryExt["bufferView"].asString();
-			auto &bufferViewInfo = mGltfTree["bufferViews"][bufferView];
-			auto offset = bufferViewInfo["byteOffset"].asUInt();
-			auto length = bufferViewInfo["byteLength"].asUInt();
-			ret.source.append( reinterpret_cast<char*>( mBuffer->getData() ) + offset, length );
-			ret.uri = uri;
+			auto bufferViewKey = binaryExt["bufferView"].asString();
+			// bufferViews are always added before shaders, see ingest().
+			auto bufferView = resolve( mBufferViews, bufferViewKey );
+			CI_ASSERT( bufferView );
+			ret.source.append( reinterpret_cast<char*>( mBuffer->getData() ) + bufferView->byteOffset, bufferView->byteLength );
 		}
 		else {
-			auto data = uri.substr( pos + 1, uri.size() );
-			auto buffer = fromBase64( data );
-			ret.source = std::string( static_cast<char*>(buffer.getData()), buffer.getSize() );
+			LoadCounters::ScopedTimer timer( mLoadCounters->base64Nanos );
+			ret.source.resize( getBase64DecodedSize( payload, uriEnd - payload ) );
+			mLoadCounters->base64Bytes += ret.source.size();
+			if( ! ret.source.empty() && ! decodeBase64( payload, uriEnd - payload, reinterpret_cast<uint8_t*>( &ret.source[0] ) ) ) {
+				CI_LOG_E( "Invalid base64 data in shader " << key );
+				ret.source.clear();
+			}
 		}
 	}
 	else {
-		ret.source = loadString( loadFile( mGltfPath / uri ) );
+		ret.uri = shaderInfo["uri"].asString();
+		ret.source = loadString( loadFile( mGltfPath / ret.uri ) );
 	}
 	ret.type = static_cast<Shader::Type>( shaderInfo["type"].asUInt() );
-	ret.uri = shaderInfo["uri"].asString();
-	ret.name = shaderInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( shaderInfo["name"].asString() );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 	
 const Skin& File::getSkinInfo( const std::string &key ) const
 {
-	auto found = mSkins.find( key );
-	return found->second;
+	return mSkins.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Skin skin )
 {
-	mSkins[key] = move( skin );
+	*resolve( mSkins, key ) = move( skin );
 }
 	
 void File::addSkinInfo( const std::string &key, const Json::Value &skinInfo )
@@ -980,11 +1660,9 @@ void File::addSkinInfo( const std::string &key, const Json::Value &skinInfo )
 	Skin ret;
 	
 	auto accessorKey = skinInfo["inverseBindMatrices"].asString();
-	auto &accessor = mAccessors[accessorKey];
-	ret.inverseBindMatrices = &accessor;
+	ret.inverseBindMatrices = resolve( mAccessors, accessorKey );
 	for( auto &jointName : skinInfo["jointNames"] ) {
-		auto &joint = mNodes[jointName.asString()];
-		ret.joints.push_back( &joint );
+		ret.joints.push_back( resolve( mNodes, jointName.asString() ) );
 	}
 	if( ! skinInfo["bindShapeMatrix"].isNull() ) {
 		auto &bindShapeMatrix = skinInfo["bindShapeMatrix"];
@@ -995,22 +1673,21 @@ void File::addSkinInfo( const std::string &key, const Json::Value &skinInfo )
 		}
 	}
 	
-	ret.name = skinInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( skinInfo["name"].asString() );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 
 const Technique& File::getTechniqueInfo( const std::string &key ) const
 {
-	auto found = mTechniques.find( key );
-	return found->second;
+	return mTechniques.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Technique technique )
 {
-	mTechniques[key] = move( technique );
+	*resolve( mTechniques, key ) = move( technique );
 }
 	
 void File::addTechniqueInfo( const std::string &key, const Json::Value &techniqueInfo )
@@ -1019,15 +1696,14 @@ void File::addTechniqueInfo( const std::string &key, const Json::Value &techniqu
 	
 	Technique ret;
 	auto programKey = techniqueInfo["program"].asString();
-	auto &program = mPrograms[programKey];
-	ret.program = &program;
+	ret.program = resolve( mPrograms, programKey );
 	
 	auto &attribs = techniqueInfo["attributes"];
 	auto attribNames = attribs.getMemberNames();
 	ret.attributes.reserve( attribNames.size() );
 	for( int i = 0; i < attribNames.size(); i++ ) {
 		auto &attribName = attribNames[i];
-		auto pair = make_pair( attribName, attribs[attribName].asString() );
+		auto pair = make_pair( intern( attribName ), intern( attribs[attribName].asString() ) );
 		ret.attributes.emplace_back( move( pair ) );
 	}
 	
@@ -1036,7 +1712,7 @@ void File::addTechniqueInfo( const std::string &key, const Json::Value &techniqu
 	ret.attributes.reserve( uniformNames.size() );
 	for( int i = 0; i < uniformNames.size(); i++ ) {
 		auto &uniformName = uniformNames[i];
-		auto pair = make_pair( uniformName, attribs[uniformName].asString() );
+		auto pair = make_pair( intern( uniformName ), intern( attribs[uniformName].asString() ) );
 		ret.uniforms.emplace_back( move( pair ) );
 	}
 	
@@ -1114,31 +1790,29 @@ void File::addTechniqueInfo( const std::string &key, const Json::Value &techniqu
 			techParam.count = param["count"].asUInt();
 		if( ! param["node"].isNull() ) {
 			auto nodeKey = param["node"].asString();
-			auto &node = mNodes[nodeKey];
-			techParam.node = &node;
+			techParam.node = resolve( mNodes, nodeKey );
 		}
 		if( ! param["semantic"].isNull() )
-			techParam.semantic = param["semantic"].asString();
-		techParam.name = param["name"].asString();
+			techParam.semantic = intern( param["semantic"].asString() );
+		techParam.name = intern( param["name"].asString() );
 		ret.parameters.emplace_back( move( techParam ) );
 	}
 	
-	ret.name = techniqueInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( techniqueInfo["name"].asString() );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 	
 const Texture& File::getTextureInfo( const std::string &key ) const
 {
-	auto found = mTextures.find( key );
-	return found->second;
+	return mTextures.at( key );
 }
 	
 template<>
 void File::add( const std::string &key, Texture texture )
 {
-	mTextures[key] = move( texture );
+	*resolve( mTextures, key ) = move( texture );
 }
 
 void File::addTextureInfo( const std::string &key, const Json::Value &textureInfo )
@@ -1148,11 +1822,9 @@ void File::addTextureInfo( const std::string &key, const Json::Value &textureInf
 	
 	Texture ret;
 	auto imageKey = textureInfo["source"].asString();
-	auto &image = mImages[imageKey];
-	ret.image = &image;
+	ret.image = resolve( mImages, imageKey );
 	auto samplerKey = textureInfo["sampler"].asString();
-	auto &sampler = mSamplers[samplerKey];
-	ret.sampler = &sampler;
+	ret.sampler = resolve( mSamplers, samplerKey );
 	if( textureInfo["target"].isNumeric() )
 		ret.target = textureInfo["target"].asUInt();
 	if( textureInfo["format"].isNumeric() )
@@ -1162,12 +1834,394 @@ void File::addTextureInfo( const std::string &key, const Json::Value &textureInf
 	if( textureInfo["type"].isNumeric() )
 		ret.type = textureInfo["type"].asUInt();
 	
-	ret.name = textureInfo["name"].asString();
-	ret.key = key;
+	ret.name = intern( textureInfo["name"].asString() );
+	ret.key = intern( key );
 	
 	add( key, move( ret ) );
 }
 	
+void File::addAccessorInfoV2( uint32_t index, const std::string &key, const Json::Value &accessorInfo )
+{
+	CI_ASSERT( accessorInfo["componentType"].isNumeric() );
+	CI_ASSERT( accessorInfo["type"].isString() );
+	CI_ASSERT( accessorInfo["count"].isNumeric() );
+	
+	Accessor ret;
+	// null without a bufferView, such an accessor is all zeros.
+	ret.bufferView = resolveIndex( mBufferViews, accessorInfo["bufferView"] );
+	ret.byteOffset = accessorInfo["byteOffset"].asUInt();
+	ret.count = accessorInfo["count"].asUInt();
+	ret.dataType = parseAccessorType( accessorInfo["type"].asString() );
+	ret.componentType = static_cast<Accessor::ComponentType>( accessorInfo["componentType"].asUInt() );
+	ret.normalized = accessorInfo["normalized"].asBool();
+	ret.name = intern( accessorInfo["name"].asString() );
+	ret.key = intern( key );
+	// byteStride is a property of the BufferView in 2.0, see linkV2().
+	
+	auto &sparse = accessorInfo["sparse"];
+	if( sparse.isObject() ) {
+		auto &indices = sparse["indices"];
+		auto &values = sparse["values"];
+		ret.sparse.count = sparse["count"].asUInt();
+		ret.sparse.indicesBufferView = resolveIndex( mBufferViews, indices["bufferView"] );
+		ret.sparse.indicesByteOffset = indices["byteOffset"].asUInt();
+		ret.sparse.indicesComponentType = static_cast<Accessor::ComponentType>( indices["componentType"].asUInt() );
+		ret.sparse.valuesBufferView = resolveIndex( mBufferViews, values["bufferView"] );
+		ret.sparse.valuesByteOffset = values["byteOffset"].asUInt();
+		if( ! ret.sparse.indicesBufferView || ! ret.sparse.valuesBufferView ) {
+			CI_LOG_E( "Sparse accessor " << key << " is missing its indices or values, ignoring them" );
+			ret.sparse = Accessor::Sparse();
+		}
+	}
+	
+	for( auto &maxVal : accessorInfo["max"] )
+		ret.max.push_back( maxVal.asFloat() );
+	for( auto &minVal : accessorInfo["min"] )
+		ret.min.push_back( minVal.asFloat() );
+	
+	mAccessors[index] = move( ret );
+}
+	
+void File::addAnimationInfoV2( uint32_t index, const std::string &key, const Json::Value &animationInfo )
+{
+	auto &samplers = animationInfo["samplers"];
+	auto name = intern( animationInfo["name"].asString() );
+	// one Animation per target node, in the order the nodes are first targeted.
+	std::vector<Animation> targets;
+	for( auto &channel : animationInfo["channels"] ) {
+		auto &target = channel["target"];
+		
+		CI_ASSERT( channel["sampler"].isNumeric() );
+		CI_ASSERT( target["path"].isString() );
+		
+		auto path = target["path"].asString();
+		auto node = resolveIndex( mNodes, target["node"] );
+		auto samplerIndex = channel["sampler"].asUInt();
+		// morph target weights have no counterpart in a TransformClip.
+		if( ! node || path == "weights" || samplerIndex >= samplers.size() )
+			continue;
+		auto &sampler = samplers[samplerIndex];
+		auto timeAccessor = resolveIndex( mAccessors, sampler["input"] );
+		
+		auto found = std::find_if( targets.begin(), targets.end(), [node]( const Animation &animation ) {
+			return animation.channels.front().target == node;
+		} );
+		if( found == targets.end() ) {
+			// node->key may not be written yet, nodes are added in parallel.
+			Animation animation;
+			animation.target = intern( std::to_string( target["node"].asUInt() ) );
+			animation.timeAccessor = timeAccessor;
+			animation.name = name;
+			targets.emplace_back( move( animation ) );
+			found = targets.end() - 1;
+		}
+		else if( found->timeAccessor != timeAccessor ) {
+			CI_LOG_W( "Animation " << key << " keys node " << found->target << " at different times, using the first" );
+		}
+		
+		Animation::Sampler animSampler;
+		// keyed like the accessors they read.
+		animSampler.input = intern( std::to_string( sampler["input"].asUInt() ) );
+		animSampler.output = intern( std::to_string( sampler["output"].asUInt() ) );
+		if( sampler["interpolation"].isString() && sampler["interpolation"].asString() != "LINEAR" )
+			CI_LOG_W( "Animation " << key << " is " << sampler["interpolation"].asString() << ", interpolating linearly" );
+		
+		Animation::Channel animChannel;
+		animChannel.target = node;
+		animChannel.targetId = found->target;
+		animChannel.sampler = intern( std::to_string( found->samplers.size() ) );
+		animChannel.path = intern( path );
+		
+		Animation::Parameter param;
+		param.parameter = animChannel.path;
+		param.accessor = resolveIndex( mAccessors, sampler["output"] );
+		
+		found->samplers.emplace_back( move( animSampler ) );
+		found->channels.emplace_back( move( animChannel ) );
+		found->parameters.emplace_back( move( param ) );
+	}
+	
+	for( auto &animation : targets )
+		animation.key = targets.size() == 1 ? intern( key ) : intern( key + ":" + animation.target.str() );
+	mAnimationTargets[index] = move( targets );
+}
+	
+void File::addBufferInfoV2( uint32_t index, const std::string &key, const Json::Value &bufferInfo )
+{
+	// uris read the same as 1.0.
+	if( bufferInfo["uri"].isString() ) {
+		addBufferInfo( key, bufferInfo );
+		return;
+	}
+	
+	gltf::Buffer ret;
+	ret.data = mBuffer;
+	if( ! ret.data )
+		CI_LOG_E( "Buffer " << key << " has no uri and there is no BIN chunk" );
+	ret.byteLength = bufferInfo["byteLength"].asUInt();
+	ret.name = intern( bufferInfo["name"].asString() );
+	ret.key = intern( key );
+	
+	mBuffers[index] = move( ret );
+}
+	
+void File::addBufferViewInfoV2( uint32_t index, const std::string &key, const Json::Value &bufferViewInfo )
+{
+	CI_ASSERT( bufferViewInfo["buffer"].isNumeric() );
+	CI_ASSERT( bufferViewInfo["byteLength"].isNumeric() );
+	
+	BufferView ret;
+	ret.buffer = resolveIndex( mBuffers, bufferViewInfo["buffer"] );
+	ret.byteOffset = bufferViewInfo["byteOffset"].asUInt();
+	ret.byteLength = bufferViewInfo["byteLength"].asUInt();
+	ret.byteStride = bufferViewInfo["byteStride"].asUInt();
+	ret.target = static_cast<BufferView::Target>( bufferViewInfo["target"].asUInt() );
+	ret.name = intern( bufferViewInfo["name"].asString() );
+	ret.key = intern( key );
+	
+	mBufferViews[index] = move( ret );
+}
+	
+void File::addImageInfoV2( uint32_t index, const std::string &key, const Json::Value &imageInfo )
+{
+	// uris read the same as 1.0.
+	if( imageInfo["uri"].isString() ) {
+		addImageInfo( key, imageInfo );
+		return;
+	}
+	
+	Image ret;
+	ret.name = intern( imageInfo["name"].asString() );
+	ret.key = intern( key );
+	
+	// bufferViews are always added before images, see ingest().
+	auto bufferView = resolveIndex( mBufferViews, imageInfo["bufferView"] );
+	auto data = bufferView && bufferView->buffer ? bufferView->buffer->getBuffer() : ci::BufferRef();
+	if( data ) {
+		// Reference the bytes in place, the deleter keeps the buffer alive.
+		auto imageStart = reinterpret_cast<uint8_t*>( data->getData() ) + bufferView->byteOffset;
+		ci::BufferRef buf( new ci::Buffer( imageStart, bufferView->byteLength ), [data]( ci::Buffer *imageBuffer ) {
+			delete imageBuffer;
+		} );
+		// image/png -> png
+		auto mimeType = imageInfo["mimeType"].asString();
+		auto slash = mimeType.find( '/' );
+		decodeImage( ret, DataSourceBuffer::create( buf ), slash != std::string::npos ? mimeType.substr( slash + 1 ) : std::string() );
+	}
+	else
+		CI_LOG_E( "Image " << key << " has neither a uri nor a loadable bufferView" );
+	
+	mImages[index] = move( ret );
+}
+	
+void File::addLightInfoV2( uint32_t index, const std::string &key, const Json::Value &lightInfo )
+{
+	CI_ASSERT( lightInfo["type"].isString() );
+	
+	Light ret;
+	auto type = lightInfo["type"].asString();
+	if( type == "directional" )
+		ret.type = Light::Type::DIRECTIONAL;
+	else if( type == "point" )
+		ret.type = Light::Type::POINT;
+	else if( type == "spot" )
+		ret.type = Light::Type::SPOT;
+	else
+		CI_ASSERT_MSG( false, "KHR_lights_punctual only supports the above types" );
+	
+	ret.color = vec4( 1.0f );
+	int i = 0;
+	for( auto &colorVal : lightInfo["color"] )
+		ret.color[i++] = colorVal.asFloat();
+	if( lightInfo["intensity"].isNumeric() )
+		ret.intensity = lightInfo["intensity"].asFloat();
+	// 0 is infinite range, like it is for distance.
+	ret.distance = lightInfo["range"].asFloat();
+	if( ret.type == Light::Type::SPOT && lightInfo["spot"]["outerConeAngle"].isNumeric() )
+		ret.falloffAngle = lightInfo["spot"]["outerConeAngle"].asFloat();
+	ret.name = intern( lightInfo["name"].asString() );
+	ret.key = intern( key );
+	
+	mLights[index] = move( ret );
+}
+	
+void File::addMaterialInfoV2( uint32_t index, const std::string &key, const Json::Value &materialInfo )
+{
+	Material ret;
+	
+	auto &pbr = materialInfo["pbrMetallicRoughness"];
+	Material::Source diffuse;
+	diffuse.type = Material::Source::Type::DIFFUSE;
+	diffuse.color = vec4( 1.0f );
+	int i = 0;
+	for( auto &colorVal : pbr["baseColorFactor"] )
+		diffuse.color[i++] = colorVal.asFloat();
+	diffuse.texture = resolveIndex( mTextures, pbr["baseColorTexture"]["index"] );
+	ret.sources.emplace_back( move( diffuse ) );
+	
+	if( ! materialInfo["emissiveFactor"].isNull() || ! materialInfo["emissiveTexture"].isNull() ) {
+		Material::Source emission;
+		emission.type = Material::Source::Type::EMISSION;
+		i = 0;
+		for( auto &colorVal : materialInfo["emissiveFactor"] )
+			emission.color[i++] = colorVal.asFloat();
+		emission.texture = resolveIndex( mTextures, materialInfo["emissiveTexture"]["index"] );
+		ret.sources.emplace_back( move( emission ) );
+	}
+	
+	ret.doubleSided = materialInfo["doubleSided"].asBool();
+	ret.transparent = materialInfo["alphaMode"].asString() == "BLEND";
+	
+	// everything without a 1.0 counterpart is kept as is.
+	for( auto &valueKey : { "pbrMetallicRoughness", "normalTexture", "occlusionTexture", "alphaMode", "alphaCutoff", "extensions" } ) {
+		if( ! materialInfo[valueKey].isNull() )
+			ret.values[valueKey] = materialInfo[valueKey];
+	}
+	
+	ret.name = intern( materialInfo["name"].asString() );
+	ret.key = intern( key );
+	
+	mMaterials[index] = move( ret );
+}
+	
+void File::addMeshInfoV2( uint32_t index, const std::string &key, const Json::Value &meshInfo )
+{
+	Mesh ret;
+	for( auto &primitive : meshInfo["primitives"] ) {
+		Mesh::Primitive meshPrim;
+		meshPrim.material = resolveIndex( mMaterials, primitive["material"] );
+		meshPrim.indices = resolveIndex( mAccessors, primitive["indices"] );
+		if( primitive["mode"].isNumeric() )
+			meshPrim.primitive = primitive["mode"].asUInt();
+		
+		auto &attributes = primitive["attributes"];
+		auto attribNames = attributes.getMemberNames();
+		meshPrim.attributes.reserve( attribNames.size() );
+		for( auto &attribName : attribNames ) {
+			Mesh::Primitive::AttribAccessor attrib;
+			attrib.attrib = Mesh::getAttribEnum( attribName );
+			attrib.accessor = resolveIndex( mAccessors, attributes[attribName] );
+			meshPrim.attributes.emplace_back( move( attrib ) );
+		}
+		
+		ret.primitives.emplace_back( move( meshPrim ) );
+	}
+	ret.name = intern( meshInfo["name"].asString() );
+	ret.key = intern( key );
+	
+	mMeshes[index] = move( ret );
+}
+	
+void File::addNodeInfoV2( uint32_t index, const std::string &key, const Json::Value &nodeInfo )
+{
+	Node ret;
+	readNodeTransform( nodeInfo, &ret );
+	
+	ret.camera = resolveIndex( mCameras, nodeInfo["camera"] );
+	ret.skin = resolveIndex( mSkins, nodeInfo["skin"] );
+	ret.light = resolveIndex( mLights, nodeInfo["extensions"]["KHR_lights_punctual"]["light"] );
+	auto mesh = resolveIndex( mMeshes, nodeInfo["mesh"] );
+	if( mesh )
+		ret.meshes.push_back( mesh );
+	
+	// parents and joint names are linked once every node is added, see link().
+	auto &children = nodeInfo["children"];
+	ret.children.reserve( children.size() );
+	for( auto &childInfo : children ) {
+		auto child = resolveIndex( mNodes, childInfo );
+		if( child )
+			ret.children.push_back( child );
+	}
+	
+	ret.name = intern( nodeInfo["name"].asString() );
+	ret.key = intern( key );
+	
+	mNodes[index] = move( ret );
+}
+	
+void File::addSceneInfoV2( uint32_t index, const std::string &key, const Json::Value &sceneInfo )
+{
+	Scene ret;
+	
+	auto &nodes = sceneInfo["nodes"];
+	ret.nodes.reserve( nodes.size() );
+	for( auto &node : nodes )
+		ret.nodes.push_back( resolveIndex( mNodes, node ) );
+	
+	ret.name = intern( sceneInfo["name"].asString() );
+	ret.key = intern( key );
+	
+	mScenes[index] = move( ret );
+}
+	
+void File::addSkinInfoV2( uint32_t index, const std::string &key, const Json::Value &skinInfo )
+{
+	CI_ASSERT( skinInfo["joints"].isArray() );
+	
+	Skin ret;
+	ret.inverseBindMatrices = resolveIndex( mAccessors, skinInfo["inverseBindMatrices"] );
+	ret.skeleton = resolveIndex( mNodes, skinInfo["skeleton"] );
+	auto &joints = skinInfo["joints"];
+	ret.joints.reserve( joints.size() );
+	for( auto &joint : joints )
+		ret.joints.push_back( resolveIndex( mNodes, joint ) );
+	
+	ret.name = intern( skinInfo["name"].asString() );
+	ret.key = intern( key );
+	
+	mSkins[index] = move( ret );
+}
+	
+void File::addTextureInfoV2( uint32_t index, const std::string &key, const Json::Value &textureInfo )
+{
+	Texture ret;
+	ret.image = resolveIndex( mImages, textureInfo["source"] );
+	ret.sampler = resolveIndex( mSamplers, textureInfo["sampler"] );
+	ret.name = intern( textureInfo["name"].asString() );
+	ret.key = intern( key );
+	
+	mTextures[index] = move( ret );
+}
+	
+void File::linkV2()
+{
+	// byteStride moved from the Accessor to its BufferView.
+	for( auto &accessor : mAccessors ) {
+		if( accessor.bufferView && ! accessor.byteStride )
+			accessor.byteStride = accessor.bufferView->byteStride;
+	}
+	// joints don't have a jointName in 2.0, Skeletons and Animations know them by key instead.
+	for( auto &skin : mSkins ) {
+		for( auto joint : skin.joints ) {
+			if( joint && joint->jointName.empty() )
+				joint->jointName = joint->key;
+		}
+	}
+	for( auto &node : mNodes ) {
+		if( node.skin && node.skeletons.empty() ) {
+			if( node.skin->skeleton )
+				node.skeletons.push_back( node.skin->skeleton );
+			else if( ! node.skin->joints.empty() && node.skin->joints.front() )
+				node.skeletons.push_back( node.skin->joints.front() );
+		}
+	}
+	
+	// nothing references an Animation, so the split ones can replace the slots.
+	size_t numAnimations = 0;
+	for( auto &targets : mAnimationTargets )
+		numAnimations += targets.size();
+	Collection<Animation> animations;
+	animations.reserve( numAnimations );
+	for( auto &targets : mAnimationTargets ) {
+		for( auto &animation : targets ) {
+			auto handle = animations.allocate( animation.key );
+			animations[handle] = move( animation );
+		}
+	}
+	mAnimations = std::move( animations );
+	std::vector<std::vector<Animation>>().swap( mAnimationTargets );
+}
+	
 Skeleton::AnimRef File::createSkeletonAnim( const SkeletonRef &skeleton ) const
 {
 	return make_shared<Skeleton::Anim>( std::move( createSkeletonTransformClip( skeleton ) ) );
@@ -1178,12 +2232,14 @@ std::vector<TransformClip> File::createSkeletonTransformClip( const SkeletonRef
 	std::vector<TransformClip> skeletonClips;
 	skeletonClips.reserve( skeleton->getNumJoints() );
 	for( auto &boneName : skeleton->getJointNames() ) {
+		// a name that was never interned can't be the target of any animation.
+		auto boneSymbol = mSymbols.find( boneName );
 		auto found = std::find_if( mAnimations.begin(), mAnimations.end(),
-		[boneName]( const std::pair<std::string, gltf::Animation> &animation ){
-			return animation.second.target == boneName;
+		[boneSymbol]( const gltf::Animation &animation ){
+			return ! boneSymbol.empty() && animation.target == boneSymbol;
 		});
 		if( found != mAnimations.end() ) {
-			auto params = found->second.getParameters();
+			auto params = found->getParameters();
 			skeletonClips.emplace_back( gltf::Animation::createTransformClip( params ) );
 		}
 		else {
@@ -1200,8 +2256,7 @@ TransformClip File::collectTransformClipFor( const cinder::gltf::Node *node ) co
 	Clip<ci::quat> rotationClip;
 	Clip<ci::vec3> scaleClip;
 	
-	for( auto &animationInfo : mAnimations ) {
-		auto &animation = animationInfo.second;
+	for( auto &animation : mAnimations ) {
 		// TODO: this is no bueno but works, but probably not for long
 		if( animation.target == node->key ) {
 			auto params = animation.getParameters();
@@ -9,41 +9,241 @@
 #pragma once
 
 #include <math.h>
+#include <atomic>
 #include <queue>
 #include <stack>
+#include <mutex>
+#include <unordered_map>
 
 #include "jsoncpp/json.h"
 #include "cinder/Utilities.h"
+#include "cinder/Log.h"
 #include "cinder/gl/gl.h"
 #include "cinder/Skeleton.h"
 
 #include "cinder/gltf/Types.h"
+#include "cinder/gltf/Collection.h"
+#include "cinder/gltf/JsonStreamReader.h"
+#include "cinder/gltf/LoadStats.h"
+#include "cinder/gltf/ThreadPool.h"
 
 namespace cinder {
 namespace gltf {
 	
 using FileRef = std::shared_ptr<class File>;
+using LoadRequestRef = std::shared_ptr<class LoadRequest>;
+	
+//! Handle to a File loading on the shared ThreadPool, see File::createAsync().
+class LoadRequest {
+public:
+	//! Phases of a load, in the order they run.
+	enum class Phase { QUEUED, JSON, BUFFERS, IMAGES, DONE, CANCELED, FAILED };
+	
+	//! Returns the phase the load is in.
+	Phase	getPhase() const { return static_cast<Phase>( mPhase.load() ); }
+	//! Returns the progress of the current phase from 0 to 1. Approximate while the phase changes.
+	float	getPhaseProgress() const;
+	//! Returns the priority the load's tasks are queued with.
+	ThreadPool::Priority getPriority() const { return mPriority; }
+	
+	//! Requests the load to stop. Work already started finishes, everything else is skipped and
+	//! getFile() returns a null FileRef.
+	void	cancel() { mCanceled = true; }
+	//! Returns whether cancel() was called.
+	bool	isCanceled() const { return mCanceled; }
+	//! Returns whether the load finished, was canceled or failed, so that getFile() won't block.
+	bool	isReady() const;
+	//! Returns the loaded File, blocking until it's ready. Null if the load was canceled or failed.
+	FileRef	getFile();
+	
+private:
+	explicit LoadRequest( ThreadPool::Priority priority );
+	//! Moves to /a phase, which has /a total units of work.
+	void	beginPhase( Phase phase, size_t total );
+	//! Marks /a count units of work of the current phase as done.
+	void	advance( size_t count = 1 ) { mDone += count; }
+	
+	ThreadPool::Priority		mPriority;
+	std::atomic<int>			mPhase;
+	std::atomic<size_t>			mDone, mTotal;
+	std::atomic<bool>			mCanceled;
+	std::shared_future<FileRef>	mFile;
+	
+	friend class File;
+	friend class BatchLoader;
+};
 	
 class File {
 public:
-	//! Creates a FileRef from /a gltfFile.
-	static FileRef create( const ci::DataSourceRef &gltfFile );
+	//! Options used to configure how a File is loaded.
+	class Options {
+	public:
+		Options() : mStreamJson( false ), mMapBinary( false ), mParallel( false ), mPrefetchBuffers( false ), mShareResources( true ),
+			mDiscardJson( false ) {}
+		
+		//! Streams the JSON into the typed collections one entry at a time instead of parsing the
+		//! whole document into a Json::Value tree. getTree() returns a null value for these Files.
+		Options&	streamJson( bool stream = true ) { mStreamJson = stream; return *this; }
+		//! Returns whether the JSON will be streamed.
+		bool		getStreamJson() const { return mStreamJson; }
+		//! Memory maps .glb files instead of reading them, the binary body and every Buffer and
+		//! Accessor referencing it point straight into the mapping. Only applies to file paths.
+		Options&	mapBinary( bool map = true ) { mMapBinary = map; return *this; }
+		//! Returns whether .glb files will be memory mapped.
+		bool		getMapBinary() const { return mMapBinary; }
+		//! Adds the entries of every collection in parallel on the shared ThreadPool.
+		Options&	parallel( bool parallel = true ) { mParallel = parallel; return *this; }
+		//! Returns whether the collections will be added in parallel.
+		bool		getParallel() const { return mParallel; }
+		//! Loads every external buffer while the File is created rather than on first use.
+		Options&	prefetchBuffers( bool prefetch = true ) { mPrefetchBuffers = prefetch; return *this; }
+		//! Returns whether external buffers will be loaded while the File is created.
+		bool		getPrefetchBuffers() const { return mPrefetchBuffers; }
+		//! Shares external buffers and images with every other File through the ResourceCache, so
+		//! a file referenced again while still alive isn't read or decoded twice. On by default.
+		Options&	shareResources( bool share = true ) { mShareResources = share; return *this; }
+		//! Returns whether external buffers and images are shared through the ResourceCache.
+		bool		getShareResources() const { return mShareResources; }
+		//! Releases the Json::Value tree once the typed collections are built, getTree() then
+		//! returns a null value. Extras and extensions stay available, see getExtrasFrom().
+		Options&	discardJson( bool discard = true ) { mDiscardJson = discard; return *this; }
+		//! Returns whether the Json::Value tree will be released after loading.
+		bool		getDiscardJson() const { return mDiscardJson; }
+		//! Only loads the scene /a key and everything it references, transitively: nodes, meshes,
+		//! accessors, bufferViews, buffers, materials, textures, images and the animations of the
+		//! loaded nodes. getDefaultScene() returns this scene. Combines with the other selections.
+		Options&	selectScene( const std::string &key ) { mSelectedScene = key; return *this; }
+		//! Returns the key of the selected scene, empty if none.
+		const std::string&	getSelectedScene() const { return mSelectedScene; }
+		//! Only loads the subtrees of the nodes /a keys and everything they reference.
+		Options&	selectNodes( const std::vector<std::string> &keys ) { mSelectedNodes = keys; return *this; }
+		//! Returns the keys of the selected root nodes.
+		const std::vector<std::string>&	getSelectedNodes() const { return mSelectedNodes; }
+		//! Only loads the meshes /a keys and everything they reference.
+		Options&	selectMeshes( const std::vector<std::string> &keys ) { mSelectedMeshes = keys; return *this; }
+		//! Returns the keys of the selected meshes.
+		const std::vector<std::string>&	getSelectedMeshes() const { return mSelectedMeshes; }
+		//! Returns whether only part of the File will be loaded. For glTF 2.0 the unselected entries
+		//! keep a default constructed slot, so that every index still resolves to its handle. Scenes
+		//! are only loaded when selected, getDefaultScene() needs a selected scene.
+		bool		hasSelection() const { return ! mSelectedScene.empty() || ! mSelectedNodes.empty() || ! mSelectedMeshes.empty(); }
+		
+	private:
+		bool	mStreamJson, mMapBinary, mParallel, mPrefetchBuffers, mShareResources, mDiscardJson;
+		std::string					mSelectedScene;
+		std::vector<std::string>	mSelectedNodes, mSelectedMeshes;
+	};
+	
+	//! Time and memory spent turning the JSON document into the typed collections.
+	struct ParseStats {
+		//! Whether the document was streamed rather than parsed into a tree.
+		bool	streamed{false};
+		//! Wall time of the JSON parse plus ingestion of every collection.
+		double	parseSeconds{0.0};
+		//! Size of the JSON text.
+		size_t	jsonBytes{0};
+		//! Estimated peak bytes held in Json::Values while parsing.
+		size_t	peakJsonBytes{0};
+		//! Number of collection entries added.
+		size_t	numEntries{0};
+	};
+	
+	//! Estimated bytes held by a File, see getMemoryStats().
+	struct MemoryStats {
+		//! Bytes held by one Buffer or Image.
+		struct Resource {
+			std::string	key;
+			size_t		bytes{0};
+			//! Whether it's shared with other Files through the ResourceCache.
+			bool		shared{false};
+		};
+		
+		//! The retained Json::Value tree, 0 if the File was streamed.
+		size_t	jsonTreeBytes{0};
+		//! The binary body of a .glb, memory mapped unless Options::mapBinary() was off.
+		size_t	binaryBodyBytes{0};
+		//! Resident Buffer data, not counting buffers that are the binary body.
+		size_t	bufferBytes{0};
+		//! Decoded pixels of the images that finished decoding.
+		size_t	imageBytes{0};
+		//! Shader sources.
+		size_t	shaderBytes{0};
+		//! The typed objects of every collection and their key lookups, not counting what the
+		//! objects own on the heap.
+		size_t	collectionBytes{0};
+		//! Interned keys and names.
+		size_t	symbolBytes{0};
+		//! Extras and extensions kept as JSON text, see getExtrasFrom().
+		size_t	rawJsonBytes{0};
+		//! Estimated peak during load: the JSON text and the Json::Values held at their peak, plus
+		//! everything held now. Buffers and images loaded since count too, so it's an upper bound.
+		//! Never less than getTotalBytes().
+		size_t	peakLoadBytes{0};
+		
+		//! Every resident Buffer and decoded Image.
+		std::vector<Resource>	buffers, images;
+		
+		//! Returns the bytes held by every category.
+		size_t	getTotalBytes() const { return jsonTreeBytes + binaryBodyBytes + bufferBytes + imageBytes + shaderBytes + collectionBytes + symbolBytes + rawJsonBytes; }
+	};
+	
+	//! Creates a FileRef from /a gltfFile. Throws if the file can't be read or its JSON is malformed.
+	static FileRef create( const ci::DataSourceRef &gltfFile, const Options &options = Options() );
+	//! Loads /a gltfFile on the shared ThreadPool without blocking the calling thread. Every buffer
+	//! is prefetched and every image decoded before the File is handed out. Tasks are queued with
+	//! /a priority.
+	static LoadRequestRef createAsync( const ci::DataSourceRef &gltfFile, const Options &options = Options(),
+									   ThreadPool::Priority priority = ThreadPool::Priority::NORMAL );
 	~File() = default;
 	//! Returns a const ref to the fs::path of this gltf File.
 	const ci::fs::path&	getGltfPath() const { return mGltfPath; }
-	//! Returns a const ref to the Json::Value of this gltf File.
+	//! Returns a const ref to the Json::Value of this gltf File. Null if the File was streamed or
+	//! its tree discarded.
 	const Json::Value&	getTree() const { return mGltfTree; }
+	//! Returns the time and memory spent parsing the JSON of this File.
+	const ParseStats&	getParseStats() const { return mParseStats; }
+	//! Returns where the time of loading this File went, by phase and by collection. Buffers loaded
+	//! on first use and images decoded since are added as they finish.
+	LoadStats			getLoadStats() const { return mLoadCounters->getStats(); }
+	//! Returns the bytes this File holds, by category and by Buffer and Image. Doesn't block on
+	//! buffers or images still loading, they're counted once done. Walks every collection, so
+	//! it's meant for budgeting rather than per frame use.
+	MemoryStats			getMemoryStats() const;
+	//! Loads every external buffer that isn't resident yet. Buffers otherwise load on first use.
+	//! When /a parallel the buffers are loaded on the shared ThreadPool.
+	void				prefetchBuffers( bool parallel = true ) const;
+	
+	//! Writes every collection of this File, with its buffer payloads and decoded images, to a
+	//! binary snapshot at /a path. Returns false if the snapshot couldn't be written.
+	bool				saveSnapshot( const ci::fs::path &path ) const;
+	//! Creates a FileRef from the snapshot at /a path without parsing any JSON. The snapshot is
+	//! memory mapped and buffers point straight into it. Returns a null ref if /a path isn't a
+	//! snapshot of the current format version, in which case the glTF should be loaded instead.
+	static FileRef		loadSnapshot( const ci::fs::path &path );
 
 	//! Returns whether or not this glTF File has /a extension.
 	bool							hasExtension( const std::string &extension ) const;
 	//! Returns the list of glTF extensions associated with this glTF File.
 	const std::vector<std::string>& getExtensions() const { return mExtensions; }
+	//! Returns whether this is a glTF 2.0 File. Its keys are the decimal indices of the entries,
+	//! e.g. getNodeInfo( "3" ), and its Collections are ordered by index. An animation driving several
+	//! nodes is split into one Animation per node, keyed "<animation>:<node>", e.g. "0:3".
+	bool				isVersion2() const { return mVersion2; }
+	//! Returns the table owning every key and name of this File. Symbols are only valid while the
+	//! File is alive and only compare equal to Symbols of the same File.
+	const SymbolTable&	getSymbols() const { return mSymbols; }
 
 	//! Templated helper which copies T
 	template<typename T>
 	void				get( const std::string &key, T &type );
+	//! Returns the extras of the T associated with /a key, null if it has none. Kept as compact
+	//! JSON text and only parsed here, so this works whether or not the tree was kept.
+	template<typename T>
+	Json::Value			getExtrasFrom( const std::string &key ) const;
+	//! Returns the extensions of the T associated with /a key that this File doesn't interpret
+	//! itself, as an object keyed by extension name. Null if there are none.
 	template<typename T>
-	Json::Value			getExtrasFrom( const std::string &key );
+	Json::Value			getExtensionsFrom( const std::string &key ) const;
 	
 	//! Returns the Asset info associated with this glTF File.
 	const Asset&		getAssetInfo() const;
@@ -85,9 +285,13 @@ public:
 	//! Returns a cons ref to the Texture associated with /a key.
 	const Texture&		getTextureInfo( const std::string &key ) const;
 	
-	//! Returns a const ref to the Collection of T, which can be any of the types listed above.
+	//! Returns a const ref to the Collection of T, which can be any of the types listed above. The
+	//! objects are contiguous and ordered by key, or by index for glTF 2.0.
 	template<typename T>
-	const std::map<std::string, T>& getCollectionOf() const;
+	const Collection<T>& getCollectionOf() const;
+	//! Returns every Node reachable from a root, each after its parent, so world transforms can be
+	//! accumulated in one linear pass. Roots are in Collection order, children in document order.
+	const std::vector<const Node*>&	getNodesParentFirst() const { return mNodesParentFirst; }
 	//! Creates and returns a Skeleton::AnimRef based on /a skeleton.
 	Skeleton::AnimRef			createSkeletonAnim( const SkeletonRef &skeleton ) const;
 	//! Creates and returns a vector of TransformClips based on /a skeleton.
@@ -96,18 +300,87 @@ public:
 	TransformClip collectTransformClipFor( const Node *node ) const;
 	
 private:
-	//! Constructor.
-	File( const ci::DataSourceRef &gltfFile );
-	//! Loads the glTF into this File.
-	void load();
-	//! Loads the associated extionsions from this File.
-	void loadExtensions();
+	//! Location of a single collection entry, either in the Json::Value tree or in the streamed JSON.
+	struct Entry {
+		std::string				key;
+		const Json::Value		*value{nullptr};
+		JsonStreamReader::Range	range;
+		// false for glTF 2.0 entries outside the selection, their slot is allocated but never added.
+		bool					selected{true};
+	};
+	//! Every entry of a collection, gathered before any of them are added.
+	struct EntryList {
+		std::string			typeName;
+		std::vector<Entry>	entries;
+	};
+	
+	//! Constructor. /a request is only set when loading asynchronously.
+	File( const ci::DataSourceRef &gltfFile, const Options &options, const LoadRequestRef &request = LoadRequestRef() );
+	//! Constructs an empty File, filled by loadSnapshot().
+	File();
+	//! Loads /a gltfFile on the calling thread the way createAsync() does, moving /a request through
+	//! its phases. Returns a null ref if the load failed or was canceled.
+	static FileRef createForRequest( const ci::DataSourceRef &gltfFile, const Options &options, const LoadRequestRef &request );
+	//! Blocks until every image is decoded.
+	void waitForImages() const;
+	//! Throws if the asynchronous load of this File was canceled.
+	void checkCanceled() const;
+	//! Returns the priority of tasks queued while loading.
+	ThreadPool::Priority getPriority() const;
+	//! Loads the glTF into this File from the parsed Json::Value tree.
+	void load( bool parallel );
+	//! Loads the glTF into this File by streaming /a gltfJson, one collection entry at a time.
+	void loadStreamed( const std::string &gltfJson, bool parallel );
+	//! Returns an EntryList with the entries of the object /a typeObj.
+	static EntryList indexTree( const std::string &typeName, const Json::Value &typeObj );
+	//! Allocates a slot for every entry of /a collections, adds the entries in parallel if
+	//! /a parallel is true and finally links the pointers that span collections.
+	void ingest( std::vector<EntryList> &collections, bool parallel );
+	//! Narrows /a collections down to the transitive closure of the selection, see Selection.cpp.
+	void selectEntries( std::vector<EntryList> &collections );
+	//! Allocates a default constructed slot for every entry of /a collection.
+	void allocateSlots( const EntryList &collection );
+	//! Adds the entries [/a begin, /a end) of /a collection.
+	void addEntries( const EntryList &collection, size_t begin, size_t end );
+	//! Dispatches the entry /a val associated with /a key to the add function of /a typeName.
+	void addInfo( const std::string &typeName, const std::string &key, const Json::Value &val );
+	//! Dispatches the glTF 2.0 entry /a val at /a index to the add function of /a typeName.
+	void addInfoV2( const std::string &typeName, uint32_t index, const std::string &key, const Json::Value &val );
+	//! Keeps the extras and uninterpreted extensions of the entry /a val of /a typeName as JSON text.
+	void keepRawJson( const std::string &typeName, const std::string &key, const Json::Value &val );
+	//! Parses the extras, or the extensions if not /a extras, kept for /a key of /a typeName.
+	Json::Value readRawJson( const char *typeName, const std::string &key, bool extras ) const;
+	//! Returns the name of the collection of T in the document, e.g. "accessors".
+	template<typename T>
+	static const char* getCollectionName();
+	//! Links the pointers that can only be set once every collection is added.
+	void link();
+	//! Links every Node to its parent and every Camera to its Node, then orders the Nodes
+	//! parent first. Iterative, so the depth of the hierarchy doesn't matter.
+	void linkNodes();
+	//! Links what glTF 2.0 leaves implicit and splits its animations into one per target node.
+	void linkV2();
+	//! Loads the extensions listed in /a extensionsUsed.
+	void loadExtensions( const Json::Value &extensionsUsed );
 	//! Caches the Asset Info for this glTF file.
 	void setAssetInfo( const Json::Value &val );
 	//! Verifies whether the glTF File is binary or regular json and loads it.
-	void verifyFile( const ci::DataSourceRef &data, std::string &gltfJson );
-	//! Recursive function for adding nodes to a parent. Called after all nodes are loaded.
-	void setParentForChildren( Node *parent, const std::string &childKey );
+	void verifyFile( const ci::DataSourceRef &data, std::string &gltfJson, bool mapBinary );
+	//! Returns the Symbol of /a str in this File's SymbolTable, adding it if needed.
+	Symbol intern( const std::string &str ) { return mSymbols.intern( str ); }
+	//! Returns a pointer to the slot of /a key in /a collection, or nullptr if it doesn't exist.
+	//! Never inserts, so it's safe to call while collections are added in parallel.
+	template<typename T>
+	T*	 resolve( Collection<T> &collection, const std::string &key );
+	//! Returns a pointer to the slot at the glTF 2.0 /a index in /a collection, or nullptr if /a index
+	//! is null or out of range. A glTF 2.0 index is the handle of its slot, nothing is looked up.
+	template<typename T>
+	T*	 resolveIndex( Collection<T> &collection, const Json::Value &index );
+	//! Writes or reads every collection of this File through /a archive, see Snapshot.cpp.
+	template<typename Archive>
+	void transferSnapshot( Archive &archive );
+	//! Decodes /a source into /a image on the ThreadPool. /a extension hints at the format.
+	void decodeImage( Image &image, const ci::DataSourceRef &source, const std::string &extension );
 	
 	//! Appends Accessor Info associated with /a key.
 	void addAccessorInfo( const std::string &key, const Json::Value &val );
@@ -147,54 +420,158 @@ private:
 	template<typename T>
 	void				add( const std::string &key, T type );
 	
+	//! Adds the glTF 2.0 Accessor at /a index.
+	void addAccessorInfoV2( uint32_t index, const std::string &key, const Json::Value &val );
+	//! Adds the glTF 2.0 Animation at /a index, see linkV2().
+	void addAnimationInfoV2( uint32_t index, const std::string &key, const Json::Value &val );
+	//! Adds the glTF 2.0 Buffer at /a index. A Buffer without uri is the BIN chunk of a .glb.
+	void addBufferInfoV2( uint32_t index, const std::string &key, const Json::Value &val );
+	//! Adds the glTF 2.0 BufferView at /a index.
+	void addBufferViewInfoV2( uint32_t index, const std::string &key, const Json::Value &val );
+	//! Adds the glTF 2.0 Image at /a index.
+	void addImageInfoV2( uint32_t index, const std::string &key, const Json::Value &val );
+	//! Adds the KHR_lights_punctual Light at /a index.
+	void addLightInfoV2( uint32_t index, const std::string &key, const Json::Value &val );
+	//! Adds the glTF 2.0 Material at /a index. The metallic-roughness model maps onto the diffuse and
+	//! emission Sources, everything else is kept in Material::values.
+	void addMaterialInfoV2( uint32_t index, const std::string &key, const Json::Value &val );
+	//! Adds the glTF 2.0 Mesh at /a index.
+	void addMeshInfoV2( uint32_t index, const std::string &key, const Json::Value &val );
+	//! Adds the glTF 2.0 Node at /a index.
+	void addNodeInfoV2( uint32_t index, const std::string &key, const Json::Value &val );
+	//! Adds the glTF 2.0 Scene at /a index.
+	void addSceneInfoV2( uint32_t index, const std::string &key, const Json::Value &val );
+	//! Adds the glTF 2.0 Skin at /a index.
+	void addSkinInfoV2( uint32_t index, const std::string &key, const Json::Value &val );
+	//! Adds the glTF 2.0 Texture at /a index.
+	void addTextureInfoV2( uint32_t index, const std::string &key, const Json::Value &val );
+	
 	Json::Value			mGltfTree;
 	cinder::fs::path	mGltfPath;
+	SymbolTable			mSymbols;
 	
 	std::vector<std::string> mExtensions;
 	
+	//! Byte ranges into mRawJson, empty if absent.
+	struct RawJson {
+		uint32_t	extrasBegin{0}, extrasEnd{0};
+		uint32_t	extensionsBegin{0}, extensionsEnd{0};
+	};
+	// extras and uninterpreted extensions of every entry, keyed "<typeName>/<key>".
+	std::string								mRawJson;
+	std::unordered_map<std::string, RawJson>	mRawJsonEntries;
+	mutable std::mutex						mRawJsonMutex;
+	ParseStats				 mParseStats;
+	std::shared_ptr<LoadCounters>	mLoadCounters;
+	std::atomic<size_t>		 mLiveJsonBytes;
+	std::atomic<size_t>		 mPeakJsonBytes;
+	size_t					 mLoadJsonBytes; // JSON text and streamed Json::Values held while loading
+	
 	Asset				mAssetInfo;
 	std::string			mDefaultScene;
+	bool				mVersion2;
+	bool				mShareResources;
+	// see Options::selectScene(), selectNodes() and selectMeshes().
+	std::string					mSelectedScene;
+	std::vector<std::string>	mSelectedNodes, mSelectedMeshes;
 	
-	std::map<std::string, Accessor>		mAccessors;
-	std::map<std::string, Animation>	mAnimations;
-	std::map<std::string, BufferView>	mBufferViews;
-	std::map<std::string, gltf::Buffer> mBuffers;
-	std::map<std::string, Camera>		mCameras;
-	std::map<std::string, Image>		mImages;
-	std::map<std::string, Light>		mLights;
-	std::map<std::string, Material>		mMaterials;
-	std::map<std::string, Mesh>			mMeshes;
-	std::map<std::string, Node>			mNodes;
-	std::map<std::string, Program>		mPrograms;
-	std::map<std::string, Sampler>		mSamplers;
-	std::map<std::string, Scene>		mScenes;
-	std::map<std::string, Shader>		mShaders;
-	std::map<std::string, Skin>			mSkins;
-	std::map<std::string, Technique>	mTechniques;
-	std::map<std::string, Texture>		mTextures;
+	Collection<Accessor>		mAccessors;
+	Collection<Animation>		mAnimations;
+	Collection<BufferView>		mBufferViews;
+	Collection<gltf::Buffer>	mBuffers;
+	Collection<Camera>			mCameras;
+	Collection<Image>			mImages;
+	Collection<Light>			mLights;
+	Collection<Material>		mMaterials;
+	Collection<Mesh>			mMeshes;
+	Collection<Node>			mNodes;
+	Collection<Program>			mPrograms;
+	Collection<Sampler>			mSamplers;
+	Collection<Scene>			mScenes;
+	Collection<Shader>			mShaders;
+	Collection<Skin>			mSkins;
+	Collection<Technique>		mTechniques;
+	Collection<Texture>			mTextures;
+	// glTF 2.0 Animations split per target node, one list per animation until linkV2() adopts them.
+	std::vector<std::vector<Animation>>	mAnimationTargets;
+	std::vector<const Node*>			mNodesParentFirst;
 	
 	ci::BufferRef	mBuffer;
+	LoadRequestRef	mRequest; // only set while loading asynchronously
 	
+	friend class BatchLoader;
 	friend std::ostream& operator<<( std::ostream &lhs, const File &rhs );
 };
 	
-template<> inline const std::map<std::string, Animation>& File::getCollectionOf() const { return mAnimations; }
-template<> inline const std::map<std::string, Accessor>& File::getCollectionOf() const { return mAccessors; }
-template<> inline const std::map<std::string, BufferView>& File::getCollectionOf() const { return mBufferViews; }
-template<> inline const std::map<std::string, Buffer>& File::getCollectionOf() const { return mBuffers; }
-template<> inline const std::map<std::string, Camera>& File::getCollectionOf() const { return mCameras; }
-template<> inline const std::map<std::string, Image>& File::getCollectionOf() const { return mImages; }
-template<> inline const std::map<std::string, Light>& File::getCollectionOf() const { return mLights; }
-template<> inline const std::map<std::string, Material>& File::getCollectionOf() const { return mMaterials; }
-template<> inline const std::map<std::string, Mesh>& File::getCollectionOf() const { return mMeshes; }
-template<> inline const std::map<std::string, Node>& File::getCollectionOf() const { return mNodes; }
-template<> inline const std::map<std::string, Program>& File::getCollectionOf() const { return mPrograms; }
-template<> inline const std::map<std::string, Sampler>& File::getCollectionOf() const { return mSamplers; }
-template<> inline const std::map<std::string, Scene>& File::getCollectionOf() const { return mScenes; }
-template<> inline const std::map<std::string, Shader>& File::getCollectionOf() const { return mShaders; }
-template<> inline const std::map<std::string, Skin>& File::getCollectionOf() const { return mSkins; }
-template<> inline const std::map<std::string, Technique>& File::getCollectionOf() const { return mTechniques; }
-template<> inline const std::map<std::string, Texture>& File::getCollectionOf() const { return mTextures; }
+template<typename T>
+T* File::resolve( Collection<T> &collection, const std::string &key )
+{
+	auto ret = collection.get( key );
+	if( ! ret )
+		CI_LOG_W( "Reference to unknown key " << key );
+	return ret;
+}
+	
+template<typename T>
+T* File::resolveIndex( Collection<T> &collection, const Json::Value &index )
+{
+	if( ! index.isNumeric() )
+		return nullptr;
+	auto handle = index.asUInt();
+	if( handle >= collection.size() ) {
+		CI_LOG_W( "Reference to unknown index " << handle );
+		return nullptr;
+	}
+	return &collection[handle];
+}
+	
+template<> inline const Collection<Animation>& File::getCollectionOf() const { return mAnimations; }
+template<> inline const Collection<Accessor>& File::getCollectionOf() const { return mAccessors; }
+template<> inline const Collection<BufferView>& File::getCollectionOf() const { return mBufferViews; }
+template<> inline const Collection<Buffer>& File::getCollectionOf() const { return mBuffers; }
+template<> inline const Collection<Camera>& File::getCollectionOf() const { return mCameras; }
+template<> inline const Collection<Image>& File::getCollectionOf() const { return mImages; }
+template<> inline const Collection<Light>& File::getCollectionOf() const { return mLights; }
+template<> inline const Collection<Material>& File::getCollectionOf() const { return mMaterials; }
+template<> inline const Collection<Mesh>& File::getCollectionOf() const { return mMeshes; }
+template<> inline const Collection<Node>& File::getCollectionOf() const { return mNodes; }
+template<> inline const Collection<Program>& File::getCollectionOf() const { return mPrograms; }
+template<> inline const Collection<Sampler>& File::getCollectionOf() const { return mSamplers; }
+template<> inline const Collection<Scene>& File::getCollectionOf() const { return mScenes; }
+template<> inline const Collection<Shader>& File::getCollectionOf() const { return mShaders; }
+template<> inline const Collection<Skin>& File::getCollectionOf() const { return mSkins; }
+template<> inline const Collection<Technique>& File::getCollectionOf() const { return mTechniques; }
+template<> inline const Collection<Texture>& File::getCollectionOf() const { return mTextures; }
+	
+template<> inline const char* File::getCollectionName<Animation>() { return "animations"; }
+template<> inline const char* File::getCollectionName<Accessor>() { return "accessors"; }
+template<> inline const char* File::getCollectionName<BufferView>() { return "bufferViews"; }
+template<> inline const char* File::getCollectionName<Buffer>() { return "buffers"; }
+template<> inline const char* File::getCollectionName<Camera>() { return "cameras"; }
+template<> inline const char* File::getCollectionName<Image>() { return "images"; }
+template<> inline const char* File::getCollectionName<Light>() { return "lights"; }
+template<> inline const char* File::getCollectionName<Material>() { return "materials"; }
+template<> inline const char* File::getCollectionName<Mesh>() { return "meshes"; }
+template<> inline const char* File::getCollectionName<Node>() { return "nodes"; }
+template<> inline const char* File::getCollectionName<Program>() { return "programs"; }
+template<> inline const char* File::getCollectionName<Sampler>() { return "samplers"; }
+template<> inline const char* File::getCollectionName<Scene>() { return "scenes"; }
+template<> inline const char* File::getCollectionName<Shader>() { return "shaders"; }
+template<> inline const char* File::getCollectionName<Skin>() { return "skins"; }
+template<> inline const char* File::getCollectionName<Technique>() { return "techniques"; }
+template<> inline const char* File::getCollectionName<Texture>() { return "textures"; }
+	
+template<typename T>
+Json::Value File::getExtrasFrom( const std::string &key ) const
+{
+	return readRawJson( getCollectionName<T>(), key, true );
+}
+	
+template<typename T>
+Json::Value File::getExtensionsFrom( const std::string &key ) const
+{
+	return readRawJson( getCollectionName<T>(), key, false );
+}
 
 }  // namespace gltf
 }
@@ -0,0 +1,254 @@
+//
+//  InterleavedMesh.cpp
+//  gltf
+//
+
+#include "InterleavedMesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <type_traits>
+
+#include "cinder/Log.h"
+
+#include "cinder/gltf/ThreadPool.h"
+
+namespace cinder {
+namespace gltf {
+
+namespace {
+
+uint32_t getComponentSize( Accessor::ComponentType componentType )
+{
+	switch( componentType ) {
+		case Accessor::ComponentType::BYTE:
+		case Accessor::ComponentType::UNSIGNED_BYTE: return 1;
+		case Accessor::ComponentType::SHORT:
+		case Accessor::ComponentType::UNSIGNED_SHORT: return 2;
+		default: return 4;
+	}
+}
+
+const Accessor* findAccessor( const Mesh::Primitive &primitive, ci::geom::Attrib attrib )
+{
+	for( auto &attribAccessor : primitive.attributes ) {
+		if( attribAccessor.attrib == attrib )
+			return attribAccessor.accessor;
+	}
+	return nullptr;
+}
+
+bool hasSameAttributes( const Mesh::Primitive &lhs, const Mesh::Primitive &rhs )
+{
+	if( lhs.attributes.size() != rhs.attributes.size() )
+		return false;
+	for( size_t i = 0; i < lhs.attributes.size(); i++ ) {
+		if( lhs.attributes[i].attrib != rhs.attributes[i].attrib || lhs.attributes[i].accessor != rhs.attributes[i].accessor )
+			return false;
+	}
+	return true;
+}
+
+//! Writes /a dims of every /a srcDims floats at /a src as C, /a stride bytes apart. Normalized
+//! integers map [0, 1], or [-1, 1] if signed, to their whole range as glTF defines them. Other
+//! integers are clamped to the range of C, converting a float outside it is undefined.
+template<typename C>
+void writeComponents( const float *src, uint32_t srcDims, uint32_t dims, uint32_t count, bool normalized, uint8_t *dst, uint32_t stride )
+{
+	const bool integral = std::is_integral<C>::value;
+	normalized = normalized && integral;
+	const float minValue = std::is_signed<C>::value ? -1.0f : 0.0f;
+	const float maxValue = static_cast<float>( std::numeric_limits<C>::max() );
+	// doubles hold the limits of every C exactly, NaN clamps to the lowest.
+	const double lowest = static_cast<double>( std::numeric_limits<C>::lowest() );
+	const double highest = static_cast<double>( std::numeric_limits<C>::max() );
+	for( uint32_t i = 0; i < count; i++, src += srcDims, dst += stride ) {
+		for( uint32_t component = 0; component < dims; component++ ) {
+			double value = normalized ? std::round( std::min( std::max( src[component], minValue ), 1.0f ) * maxValue ) : src[component];
+			if( integral )
+				value = std::min( std::max( lowest, value ), highest );
+			auto converted = static_cast<C>( value );
+			memcpy( dst + component * sizeof( C ), &converted, sizeof( C ) );
+		}
+	}
+}
+
+} // anonymous namespace
+
+InterleavedMesh::Options& InterleavedMesh::Options::attrib( ci::geom::Attrib attrib, Accessor::ComponentType componentType, bool normalized,
+															uint8_t dims )
+{
+	Attrib added;
+	added.attrib = attrib;
+	added.dims = dims;
+	added.componentType = componentType;
+	added.normalized = normalized;
+	mAttribs.push_back( added );
+	return *this;
+}
+
+const InterleavedMesh::Attrib* InterleavedMesh::Layout::find( ci::geom::Attrib attrib ) const
+{
+	for( auto &layoutAttrib : attribs ) {
+		if( layoutAttrib.attrib == attrib )
+			return &layoutAttrib;
+	}
+	return nullptr;
+}
+
+ci::geom::BufferLayout InterleavedMesh::Layout::getBufferLayout() const
+{
+	ci::geom::BufferLayout ret;
+	for( auto &attrib : attribs ) {
+		if( attrib.componentType == Accessor::ComponentType::FLOAT )
+			ret.append( attrib.attrib, ci::geom::FLOAT, attrib.dims, stride, attrib.offset );
+	}
+	return ret;
+}
+
+InterleavedMeshRef InterleavedMesh::create( const Mesh *mesh, const Options &options )
+{
+	InterleavedMeshRef ret( new InterleavedMesh( mesh, options ) );
+	if( ret->mLayout.attribs.empty() ) {
+		CI_LOG_W( "Mesh " << mesh->key << " has none of the attributes to interleave" );
+		return InterleavedMeshRef();
+	}
+
+	// ranges sharing vertices are packed by the first of them.
+	std::vector<const Range*> toPack;
+	uint32_t nextVertex = 0;
+	for( auto &range : ret->mRanges ) {
+		if( range.numVertices && range.firstVertex == nextVertex ) {
+			toPack.push_back( &range );
+			nextVertex += range.numVertices;
+		}
+	}
+	if( ! options.getParallel() || toPack.size() < 2 ) {
+		for( auto range : toPack )
+			ret->pack( *range );
+		return ret;
+	}
+
+	// every range writes its own vertices.
+	auto &pool = ThreadPool::get();
+	const InterleavedMesh *packer = ret.get();
+	std::vector<std::future<void>> tasks;
+	for( auto range : toPack )
+		tasks.emplace_back( pool.submit( [packer, range] { packer->pack( *range ); } ) );
+	for( auto &task : tasks )
+		pool.wait( task );
+	return ret;
+}
+
+InterleavedMesh::InterleavedMesh( const Mesh *mesh, const Options &options )
+: mNumVertices( 0 )
+{
+	auto attribs = options.getAttribs();
+	if( attribs.empty() ) {
+		for( auto &primitive : mesh->primitives ) {
+			for( auto &attribAccessor : primitive.attributes ) {
+				if( std::none_of( attribs.begin(), attribs.end(), [&]( const Attrib &attrib ) { return attrib.attrib == attribAccessor.attrib; } ) ) {
+					Attrib added;
+					added.attrib = attribAccessor.attrib;
+					attribs.push_back( added );
+				}
+			}
+		}
+	}
+
+	auto alignment = std::max<uint32_t>( options.getAlignment(), 1 );
+	auto alignUp = [alignment]( uint32_t offset ) { return ( offset + alignment - 1 ) / alignment * alignment; };
+	uint32_t offset = 0;
+	for( auto &attrib : attribs ) {
+		const Accessor *accessor = nullptr;
+		for( auto &primitive : mesh->primitives ) {
+			if( ( accessor = findAccessor( primitive, attrib.attrib ) ) )
+				break;
+		}
+		if( ! accessor ) {
+			CI_LOG_W( "Mesh " << mesh->key << " has no " << ci::geom::attribToString( attrib.attrib ) << " attribute" );
+			continue;
+		}
+		if( attrib.dims == 0 )
+			attrib.dims = accessor->getNumComponents();
+		attrib.offset = offset;
+		offset = alignUp( offset + attrib.dims * getComponentSize( attrib.componentType ) );
+		mLayout.attribs.push_back( attrib );
+	}
+	mLayout.stride = offset;
+	if( mLayout.attribs.empty() )
+		return;
+
+	for( auto &primitive : mesh->primitives ) {
+		Range range;
+		range.primitive = &primitive;
+		for( auto &attribAccessor : primitive.attributes ) {
+			if( attribAccessor.accessor ) {
+				range.numVertices = attribAccessor.accessor->count;
+				break;
+			}
+		}
+		auto shared = std::find_if( mRanges.begin(), mRanges.end(), [&]( const Range &other ) {
+			return hasSameAttributes( *other.primitive, primitive );
+		} );
+		if( shared != mRanges.end() )
+			range.firstVertex = shared->firstVertex;
+		else {
+			range.firstVertex = static_cast<uint32_t>( mNumVertices );
+			mNumVertices += range.numVertices;
+		}
+		mRanges.push_back( range );
+	}
+
+	// attributes a primitive doesn't have are left zeros.
+	mBuffer = ci::Buffer::create( mNumVertices * mLayout.stride );
+	memset( mBuffer->getData(), 0, mBuffer->getSize() );
+}
+
+void InterleavedMesh::pack( const Range &range ) const
+{
+	auto stride = mLayout.stride;
+	auto vertices = reinterpret_cast<uint8_t*>( mBuffer->getData() ) + size_t( range.firstVertex ) * stride;
+	std::vector<float> converted;
+	for( auto &attrib : mLayout.attribs ) {
+		auto accessor = findAccessor( *range.primitive, attrib.attrib );
+		if( ! accessor )
+			continue;
+		auto dst = vertices + attrib.offset;
+		auto count = std::min( accessor->count, range.numVertices );
+		uint32_t srcDims = accessor->getNumComponents();
+		uint32_t dims = std::min<uint32_t>( srcDims, attrib.dims );
+
+		// stored as the layout asks, copied vertex by vertex.
+		if( accessor->componentType == attrib.componentType && accessor->normalized == attrib.normalized && accessor->bufferView
+		   && ! accessor->isSparse() ) {
+			auto src = reinterpret_cast<const uint8_t*>( accessor->getDataPtr() );
+			if( ! src )
+				continue;
+			auto srcStride = accessor->getByteStride();
+			auto size = dims * getComponentSize( attrib.componentType );
+			for( uint32_t i = 0; i < count; i++ )
+				memcpy( dst + size_t( i ) * stride, src + size_t( i ) * srcStride, size );
+			continue;
+		}
+
+		converted.resize( size_t( accessor->count ) * srcDims );
+		if( ! accessor->copyTo( converted.data() ) )
+			continue;
+		auto src = converted.data();
+		switch( attrib.componentType ) {
+			case Accessor::ComponentType::BYTE: writeComponents<int8_t>( src, srcDims, dims, count, attrib.normalized, dst, stride ); break;
+			case Accessor::ComponentType::UNSIGNED_BYTE: writeComponents<uint8_t>( src, srcDims, dims, count, attrib.normalized, dst, stride ); break;
+			case Accessor::ComponentType::SHORT: writeComponents<int16_t>( src, srcDims, dims, count, attrib.normalized, dst, stride ); break;
+			case Accessor::ComponentType::UNSIGNED_SHORT: writeComponents<uint16_t>( src, srcDims, dims, count, attrib.normalized, dst, stride ); break;
+			case Accessor::ComponentType::UNSIGNED_INT: writeComponents<uint32_t>( src, srcDims, dims, count, attrib.normalized, dst, stride ); break;
+			case Accessor::ComponentType::FLOAT: writeComponents<float>( src, srcDims, dims, count, attrib.normalized, dst, stride ); break;
+		}
+	}
+}
+
+} // namespace gltf
+} // namespace cinder
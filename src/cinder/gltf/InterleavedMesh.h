@@ -0,0 +1,108 @@
+//
+//  InterleavedMesh.h
+//  gltf
+//
+//  Packs the attributes of a Mesh's primitives into one interleaved vertex buffer.
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "cinder/GeomIo.h"
+
+#include "cinder/gltf/Types.h"
+
+namespace cinder {
+namespace gltf {
+
+using InterleavedMeshRef = std::shared_ptr<class InterleavedMesh>;
+
+//! The vertices of a Mesh's primitives packed attribute by attribute into one buffer, laid out
+//! as its Layout describes. Built on the CPU, the buffer can be uploaded as is. Note: indices
+//! aren't repacked, a primitive's indices are relative to the firstVertex of its Range.
+class InterleavedMesh {
+public:
+	//! An attribute of the vertex, bindable as glVertexAttribPointer( location, dims,
+	//! componentType, normalized, stride, offset ).
+	struct Attrib {
+		ci::geom::Attrib		attrib;
+		uint8_t					dims{0};
+		Accessor::ComponentType	componentType{Accessor::ComponentType::FLOAT};
+		bool					normalized{false};
+		uint32_t				offset{0};
+	};
+
+	//! Describes the interleaved vertex.
+	struct Layout {
+		std::vector<Attrib>	attribs;
+		uint32_t			stride{0};
+
+		//! Returns the Attrib for /a attrib, null if it isn't part of the vertex.
+		const Attrib*			find( ci::geom::Attrib attrib ) const;
+		//! Returns a geom::BufferLayout of the float attributes, for a gl::VboMesh. geom::DataType
+		//! has no normalized integers, bind the others from their Attrib.
+		ci::geom::BufferLayout	getBufferLayout() const;
+	};
+
+	//! The vertices of a Mesh::Primitive. Primitives sharing their attribute accessors, as glTF 1.0
+	//! exporters often write them, share their vertices too.
+	struct Range {
+		const Mesh::Primitive	*primitive{nullptr};
+		uint32_t				firstVertex{0}, numVertices{0};
+	};
+
+	class Options {
+	public:
+		Options() : mAlignment( 4 ), mParallel( true ) {}
+
+		//! Adds /a attrib to the vertex as /a dims components of /a componentType, normalized
+		//! integers if /a normalized. Attributes are laid out in the order they're added. 0 /a dims
+		//! takes the accessor's, extra components are zeros. Without any, every attribute of the
+		//! Mesh is added as floats.
+		Options&	attrib( ci::geom::Attrib attrib, Accessor::ComponentType componentType = Accessor::ComponentType::FLOAT,
+						    bool normalized = false, uint8_t dims = 0 );
+		//! Returns the attributes added, with offset left to be laid out.
+		const std::vector<Attrib>&	getAttribs() const { return mAttribs; }
+		//! Starts every attribute and vertex on a multiple of /a alignment bytes, 4 by default.
+		Options&	alignment( uint32_t alignment ) { mAlignment = alignment; return *this; }
+		//! Returns the alignment of the attributes and vertices.
+		uint32_t	getAlignment() const { return mAlignment; }
+		//! Packs the primitives in parallel on the shared ThreadPool. On by default.
+		Options&	parallel( bool parallel = true ) { mParallel = parallel; return *this; }
+		//! Returns whether the primitives are packed in parallel.
+		bool		getParallel() const { return mParallel; }
+
+	private:
+		std::vector<Attrib>	mAttribs;
+		uint32_t			mAlignment;
+		bool				mParallel;
+	};
+
+	//! Packs the primitives of /a mesh. Returns null if none of the attributes are part of it.
+	static InterleavedMeshRef create( const Mesh *mesh, const Options &options = Options() );
+
+	//! Returns the layout of a vertex.
+	const Layout&				getLayout() const { return mLayout; }
+	//! Returns the vertices of each primitive, in the Mesh's order.
+	const std::vector<Range>&	getRanges() const { return mRanges; }
+	//! Returns the number of vertices packed.
+	size_t						getNumVertices() const { return mNumVertices; }
+	//! Returns the packed vertices, getNumVertices() times the stride.
+	const ci::BufferRef&		getBuffer() const { return mBuffer; }
+
+private:
+	InterleavedMesh( const Mesh *mesh, const Options &options );
+
+	//! Packs the vertices of /a range.
+	void	pack( const Range &range ) const;
+
+	Layout				mLayout;
+	std::vector<Range>	mRanges;
+	size_t				mNumVertices;
+	ci::BufferRef		mBuffer;
+};
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,381 @@
+//
+//  JsonStreamReader.cpp
+//  gltf
+//
+
+#include "JsonStreamReader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace cinder {
+namespace gltf {
+
+JsonStreamReader::JsonStreamReader( const char *begin, const char *end )
+: mBegin( begin ), mCurrent( begin ), mEnd( end )
+{
+}
+
+JsonStreamReader::JsonStreamReader( const Range &range )
+: JsonStreamReader( range.begin, range.end )
+{
+}
+
+void JsonStreamReader::error( const std::string &message ) const
+{
+	throw std::runtime_error( message + " at offset " + std::to_string( getOffset() ) );
+}
+
+void JsonStreamReader::skipWhitespace()
+{
+	while( mCurrent < mEnd ) {
+		auto c = *mCurrent;
+		if( c == ' ' || c == '\t' || c == '\n' || c == '\r' )
+			++mCurrent;
+		// comments are allowed to match the features used by the Json::Reader path.
+		else if( c == '/' && mCurrent + 1 < mEnd && mCurrent[1] == '/' ) {
+			while( mCurrent < mEnd && *mCurrent != '\n' )
+				++mCurrent;
+		}
+		else if( c == '/' && mCurrent + 1 < mEnd && mCurrent[1] == '*' ) {
+			mCurrent += 2;
+			while( mCurrent + 1 < mEnd && ! ( mCurrent[0] == '*' && mCurrent[1] == '/' ) )
+				++mCurrent;
+			mCurrent = std::min( mCurrent + 2, mEnd );
+		}
+		else
+			break;
+	}
+}
+
+char JsonStreamReader::peek()
+{
+	skipWhitespace();
+	return mCurrent < mEnd ? *mCurrent : '\0';
+}
+
+void JsonStreamReader::expect( char c )
+{
+	if( peek() != c )
+		error( std::string( "Expected '" ) + c + "'" );
+	++mCurrent;
+}
+
+bool JsonStreamReader::beginObject()
+{
+	if( peek() != '{' )
+		return false;
+	++mCurrent;
+	return true;
+}
+
+bool JsonStreamReader::nextMember( std::string *name )
+{
+	auto c = peek();
+	if( c == ',' ) {
+		++mCurrent;
+		c = peek();
+	}
+	if( c == '}' ) {
+		++mCurrent;
+		return false;
+	}
+	if( c != '"' )
+		error( "Expected member name" );
+	readString( name );
+	expect( ':' );
+	return true;
+}
+
+bool JsonStreamReader::beginArray()
+{
+	if( peek() != '[' )
+		return false;
+	++mCurrent;
+	return true;
+}
+
+bool JsonStreamReader::nextElement()
+{
+	auto c = peek();
+	if( c == ',' ) {
+		++mCurrent;
+		c = peek();
+	}
+	if( c == ']' ) {
+		++mCurrent;
+		return false;
+	}
+	if( c == '\0' )
+		error( "Unterminated array" );
+	return true;
+}
+
+// Explicit compares, so neither the terminating '\0' nor bytes above 0x7F can match.
+static bool isNumberChar( char c )
+{
+	return ( c >= '0' && c <= '9' ) || c == '+' || c == '-' || c == '.' || c == 'e' || c == 'E';
+}
+
+static int hexValue( char c )
+{
+	if( c >= '0' && c <= '9' )
+		return c - '0';
+	if( c >= 'a' && c <= 'f' )
+		return c - 'a' + 10;
+	if( c >= 'A' && c <= 'F' )
+		return c - 'A' + 10;
+	return -1;
+}
+
+static void appendUtf8( std::string *str, uint32_t codepoint )
+{
+	if( codepoint < 0x80 )
+		str->push_back( static_cast<char>( codepoint ) );
+	else if( codepoint < 0x800 ) {
+		str->push_back( static_cast<char>( 0xC0 | ( codepoint >> 6 ) ) );
+		str->push_back( static_cast<char>( 0x80 | ( codepoint & 0x3F ) ) );
+	}
+	else if( codepoint < 0x10000 ) {
+		str->push_back( static_cast<char>( 0xE0 | ( codepoint >> 12 ) ) );
+		str->push_back( static_cast<char>( 0x80 | ( ( codepoint >> 6 ) & 0x3F ) ) );
+		str->push_back( static_cast<char>( 0x80 | ( codepoint & 0x3F ) ) );
+	}
+	else {
+		str->push_back( static_cast<char>( 0xF0 | ( codepoint >> 18 ) ) );
+		str->push_back( static_cast<char>( 0x80 | ( ( codepoint >> 12 ) & 0x3F ) ) );
+		str->push_back( static_cast<char>( 0x80 | ( ( codepoint >> 6 ) & 0x3F ) ) );
+		str->push_back( static_cast<char>( 0x80 | ( codepoint & 0x3F ) ) );
+	}
+}
+
+void JsonStreamReader::readString( std::string *str )
+{
+	expect( '"' );
+	str->clear();
+	auto runBegin = mCurrent;
+	while( mCurrent < mEnd && *mCurrent != '"' ) {
+		if( *mCurrent != '\\' ) {
+			++mCurrent;
+			continue;
+		}
+		// flush the unescaped run before handling the escape sequence.
+		str->append( runBegin, mCurrent );
+		if( ++mCurrent >= mEnd )
+			break;
+		auto escape = *mCurrent++;
+		switch( escape ) {
+			case '"': str->push_back( '"' ); break;
+			case '\\': str->push_back( '\\' ); break;
+			case '/': str->push_back( '/' ); break;
+			case 'b': str->push_back( '\b' ); break;
+			case 'f': str->push_back( '\f' ); break;
+			case 'n': str->push_back( '\n' ); break;
+			case 'r': str->push_back( '\r' ); break;
+			case 't': str->push_back( '\t' ); break;
+			case 'u': {
+				auto readHex = [this]() -> uint32_t {
+					if( mEnd - mCurrent < 4 )
+						error( "Bad unicode escape" );
+					uint32_t ret = 0;
+					for( int i = 0; i < 4; ++i ) {
+						auto digit = hexValue( *mCurrent++ );
+						if( digit < 0 )
+							error( "Bad unicode escape" );
+						ret = ( ret << 4 ) | static_cast<uint32_t>( digit );
+					}
+					return ret;
+				};
+				auto codepoint = readHex();
+				// combine surrogate pairs.
+				if( codepoint >= 0xD800 && codepoint <= 0xDBFF && mEnd - mCurrent >= 6 &&
+					mCurrent[0] == '\\' && mCurrent[1] == 'u' ) {
+					mCurrent += 2;
+					auto low = readHex();
+					if( low < 0xDC00 || low > 0xDFFF )
+						error( "Bad surrogate pair" );
+					codepoint = 0x10000 + ( ( codepoint - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+				}
+				appendUtf8( str, codepoint );
+			}
+			break;
+			default: error( "Bad escape sequence" ); break;
+		}
+		runBegin = mCurrent;
+	}
+	if( mCurrent >= mEnd )
+		error( "Unterminated string" );
+	str->append( runBegin, mCurrent );
+	++mCurrent;
+}
+
+void JsonStreamReader::skipString()
+{
+	expect( '"' );
+	while( mCurrent < mEnd && *mCurrent != '"' ) {
+		if( *mCurrent == '\\' )
+			++mCurrent;
+		++mCurrent;
+	}
+	if( mCurrent >= mEnd )
+		error( "Unterminated string" );
+	++mCurrent;
+}
+
+void JsonStreamReader::readNumber( Json::Value *value )
+{
+	auto numberBegin = mCurrent;
+	bool isInteger = true;
+	if( mCurrent < mEnd && ( *mCurrent == '-' || *mCurrent == '+' ) )
+		++mCurrent;
+	while( mCurrent < mEnd ) {
+		auto c = *mCurrent;
+		if( ! isNumberChar( c ) )
+			break;
+		if( c < '0' || c > '9' )
+			isInteger = false;
+		++mCurrent;
+	}
+	std::string number( numberBegin, mCurrent );
+	if( number.empty() )
+		error( "Expected value" );
+	char *parsedEnd = nullptr;
+	if( isInteger ) {
+		errno = 0;
+		if( number[0] == '-' ) {
+			auto integer = strtoll( number.c_str(), &parsedEnd, 10 );
+			if( errno == 0 ) {
+				*value = Json::Value( static_cast<Json::Int64>( integer ) );
+				return;
+			}
+		}
+		else {
+			// matches Json::Reader, which only falls back to unsigned when the value doesn't fit.
+			auto integer = strtoull( number.c_str(), &parsedEnd, 10 );
+			if( errno == 0 ) {
+				if( integer <= static_cast<unsigned long long>( Json::Value::maxInt64 ) )
+					*value = Json::Value( static_cast<Json::Int64>( integer ) );
+				else
+					*value = Json::Value( static_cast<Json::UInt64>( integer ) );
+				return;
+			}
+		}
+	}
+	*value = Json::Value( strtod( number.c_str(), &parsedEnd ) );
+}
+
+void JsonStreamReader::skipLiteral( const char *literal )
+{
+	auto length = strlen( literal );
+	if( static_cast<size_t>( mEnd - mCurrent ) < length || strncmp( mCurrent, literal, length ) != 0 )
+		error( "Unknown literal" );
+	mCurrent += length;
+}
+
+void JsonStreamReader::readValue( Json::Value *value )
+{
+	switch( peek() ) {
+		case '{': {
+			++mCurrent;
+			*value = Json::Value( Json::objectValue );
+			std::string name;
+			while( nextMember( &name ) )
+				readValue( &(*value)[name] );
+		}
+		break;
+		case '[': {
+			++mCurrent;
+			*value = Json::Value( Json::arrayValue );
+			Json::ArrayIndex index = 0;
+			while( nextElement() )
+				readValue( &(*value)[index++] );
+		}
+		break;
+		case '"': {
+			std::string str;
+			readString( &str );
+			*value = Json::Value( str );
+		}
+		break;
+		case 't': skipLiteral( "true" ); *value = Json::Value( true ); break;
+		case 'f': skipLiteral( "false" ); *value = Json::Value( false ); break;
+		case 'n': skipLiteral( "null" ); *value = Json::Value(); break;
+		case '\0': error( "Unexpected end of input" ); break;
+		default: readNumber( value ); break;
+	}
+}
+
+JsonStreamReader::Range JsonStreamReader::skipValue()
+{
+	auto c = peek();
+	auto valueBegin = mCurrent;
+	if( c == '"' )
+		skipString();
+	else if( c == '{' || c == '[' ) {
+		// Only track nesting depth, strings are skipped so their brackets don't count.
+		size_t depth = 0;
+		while( mCurrent < mEnd ) {
+			auto current = *mCurrent;
+			if( current == '"' ) {
+				skipString();
+				continue;
+			}
+			if( current == '/' ) {
+				auto commentBegin = mCurrent;
+				skipWhitespace();
+				if( mCurrent == commentBegin )
+					error( "Unexpected character" );
+				continue;
+			}
+			++mCurrent;
+			if( current == '{' || current == '[' )
+				++depth;
+			else if( ( current == '}' || current == ']' ) && --depth == 0 )
+				break;
+		}
+		if( depth != 0 )
+			error( "Unterminated container" );
+	}
+	else if( c == 't' )
+		skipLiteral( "true" );
+	else if( c == 'f' )
+		skipLiteral( "false" );
+	else if( c == 'n' )
+		skipLiteral( "null" );
+	else if( c == '\0' )
+		error( "Unexpected end of input" );
+	else {
+		while( mCurrent < mEnd && isNumberChar( *mCurrent ) )
+			++mCurrent;
+		if( mCurrent == valueBegin )
+			error( "Expected value" );
+	}
+	return Range( valueBegin, mCurrent );
+}
+
+size_t estimateJsonBytes( const Json::Value &value )
+{
+	// Approximates the allocator overhead of a tree node and its member key.
+	static const size_t kNodeOverhead = 48;
+	size_t ret = sizeof( Json::Value );
+	switch( value.type() ) {
+		case Json::stringValue:
+			ret += strlen( value.asCString() ) + 1;
+		break;
+		case Json::arrayValue:
+		case Json::objectValue:
+			for( auto it = value.begin(); it != value.end(); ++it ) {
+				ret += kNodeOverhead + estimateJsonBytes( *it );
+				if( value.isObject() )
+					ret += it.key().asString().size() + 1;
+			}
+		break;
+		default: break;
+	}
+	return ret;
+}
+
+} // namespace gltf
+} // namespace cinder
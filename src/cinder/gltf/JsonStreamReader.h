@@ -0,0 +1,71 @@
+//
+//  JsonStreamReader.h
+//  gltf
+//
+//  Pull style JSON tokenizer used to stream glTF documents straight into the
+//  typed collections, without building a Json::Value tree for the whole file.
+//
+
+#pragma once
+
+#include <string>
+#include <stdexcept>
+
+#include "jsoncpp/json.h"
+
+namespace cinder {
+namespace gltf {
+
+class JsonStreamReader {
+public:
+	//! Represents the raw bytes [begin, end) of a single JSON value.
+	struct Range {
+		Range() : begin( nullptr ), end( nullptr ) {}
+		Range( const char *begin, const char *end ) : begin( begin ), end( end ) {}
+		size_t size() const { return static_cast<size_t>( end - begin ); }
+		bool empty() const { return begin == end; }
+
+		const char *begin, *end;
+	};
+
+	//! Constructs a reader over the bytes [/a begin, /a end). The bytes must outlive the reader.
+	JsonStreamReader( const char *begin, const char *end );
+	//! Constructs a reader over /a range.
+	explicit JsonStreamReader( const Range &range );
+
+	//! Consumes the opening brace of an object. Returns false if the next value isn't an object.
+	bool	beginObject();
+	//! Advances to the next member of the current object and stores its name in /a name. Returns
+	//! false, consuming the closing brace, once the object has no more members.
+	bool	nextMember( std::string *name );
+	//! Consumes the opening bracket of an array. Returns false if the next value isn't an array.
+	bool	beginArray();
+	//! Advances to the next element of the current array. Returns false, consuming the closing
+	//! bracket, once the array has no more elements.
+	bool	nextElement();
+	//! Materializes only the next value into /a value.
+	void	readValue( Json::Value *value );
+	//! Skips over the next value and returns the Range it occupied.
+	Range	skipValue();
+
+	//! Returns the byte offset of the reader from the beginning of its input.
+	size_t	getOffset() const { return static_cast<size_t>( mCurrent - mBegin ); }
+
+private:
+	void	skipWhitespace();
+	char	peek();
+	void	expect( char c );
+	void	readString( std::string *str );
+	void	skipString();
+	void	readNumber( Json::Value *value );
+	void	skipLiteral( const char *literal );
+	void	error( const std::string &message ) const;
+
+	const char	*mBegin, *mCurrent, *mEnd;
+};
+
+//! Returns an estimate of the heap bytes held by /a value and all of its children.
+size_t estimateJsonBytes( const Json::Value &value );
+
+} // namespace gltf
+} // namespace cinder
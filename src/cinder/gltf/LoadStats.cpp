@@ -0,0 +1,52 @@
+//
+//  LoadStats.cpp
+//  gltf
+//
+
+#include "LoadStats.h"
+
+namespace cinder {
+namespace gltf {
+
+static double toSeconds( int64_t nanos )
+{
+	return static_cast<double>( nanos ) * 1e-9;
+}
+
+LoadCounters::LoadCounters()
+: readNanos( 0 ), parseNanos( 0 ), ingestNanos( 0 ), linkNanos( 0 ), bufferNanos( 0 ), base64Nanos( 0 ), imageDecodeNanos( 0 ),
+	fileBytes( 0 ), bufferBytes( 0 ), base64Bytes( 0 ), numImagesDecoded( 0 )
+{
+}
+
+void LoadCounters::addCollection( const std::string &typeName, size_t numObjects, size_t jsonBytes, int64_t nanos )
+{
+	std::lock_guard<std::mutex> lock( mCollectionsMutex );
+	auto &collection = mCollections[typeName];
+	collection.numObjects += numObjects;
+	collection.jsonBytes += jsonBytes;
+	collection.seconds += toSeconds( nanos );
+}
+
+LoadStats LoadCounters::getStats() const
+{
+	LoadStats ret;
+	ret.readSeconds = toSeconds( readNanos );
+	ret.parseSeconds = toSeconds( parseNanos );
+	ret.ingestSeconds = toSeconds( ingestNanos );
+	ret.linkSeconds = toSeconds( linkNanos );
+	ret.bufferSeconds = toSeconds( bufferNanos );
+	ret.base64Seconds = toSeconds( base64Nanos );
+	ret.imageDecodeSeconds = toSeconds( imageDecodeNanos );
+	ret.fileBytes = fileBytes;
+	ret.bufferBytes = bufferBytes;
+	ret.base64Bytes = base64Bytes;
+	ret.numImagesDecoded = numImagesDecoded;
+
+	std::lock_guard<std::mutex> lock( mCollectionsMutex );
+	ret.collections = mCollections;
+	return ret;
+}
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,95 @@
+//
+//  LoadStats.h
+//  gltf
+//
+//  Where the time of loading a File goes. Cheap enough to always be collected.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace cinder {
+namespace gltf {
+
+//! Times and counts of loading a File. Work spread over the ThreadPool is summed over every thread
+//! that did it, so those times can add up to more than the wall time of the load.
+struct LoadStats {
+	struct CollectionStats {
+		//! Number of entries added.
+		size_t	numObjects{0};
+		//! Bytes of JSON text of the entries, only known when streamed.
+		size_t	jsonBytes{0};
+		//! Time spent in the add functions of this collection, summed over threads.
+		double	seconds{0.0};
+	};
+
+	//! Wall time of reading, or mapping, the file.
+	double	readSeconds{0.0};
+	//! Wall time of parsing the JSON into a tree, or of indexing it when streamed.
+	double	parseSeconds{0.0};
+	//! Wall time of adding every collection.
+	double	ingestSeconds{0.0};
+	//! Wall time of linking the node hierarchy and the references between collections.
+	double	linkSeconds{0.0};
+	//! Time spent reading external buffers, summed over threads. Includes buffers loaded on first
+	//! use after the File was created.
+	double	bufferSeconds{0.0};
+	//! Time spent decoding base64 data: URIs, summed over threads.
+	double	base64Seconds{0.0};
+	//! Time spent decoding images, summed over threads. Images still decoding aren't counted yet.
+	double	imageDecodeSeconds{0.0};
+
+	//! Size of the file, JSON plus binary body.
+	size_t	fileBytes{0};
+	//! Bytes of external buffers read.
+	size_t	bufferBytes{0};
+	//! Bytes decoded from base64.
+	size_t	base64Bytes{0};
+	//! Number of images decoded.
+	size_t	numImagesDecoded{0};
+
+	//! Stats of every collection, by name, e.g. "accessors".
+	std::map<std::string, CollectionStats>	collections;
+};
+
+//! Thread safe accumulators behind LoadStats, shared with the Buffers and decode tasks of a File
+//! so that work finishing after the File is created is still counted.
+class LoadCounters {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	//! Adds the time from construction to destruction to a counter.
+	class ScopedTimer {
+	public:
+		explicit ScopedTimer( std::atomic<int64_t> &nanos ) : mNanos( nanos ), mStart( Clock::now() ) {}
+		~ScopedTimer() { mNanos += nanosSince( mStart ); }
+	private:
+		std::atomic<int64_t>	&mNanos;
+		Clock::time_point		mStart;
+	};
+
+	LoadCounters();
+	
+	//! Returns the nanoseconds elapsed since /a start.
+	static int64_t	nanosSince( Clock::time_point start ) { return std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - start ).count(); }
+
+	//! Adds /a numObjects entries of /a jsonBytes that took /a nanos to the collection /a typeName.
+	void		addCollection( const std::string &typeName, size_t numObjects, size_t jsonBytes, int64_t nanos );
+	//! Returns the current totals.
+	LoadStats	getStats() const;
+
+	std::atomic<int64_t>	readNanos, parseNanos, ingestNanos, linkNanos, bufferNanos, base64Nanos, imageDecodeNanos;
+	std::atomic<size_t>		fileBytes, bufferBytes, base64Bytes, numImagesDecoded;
+
+private:
+	mutable std::mutex								mCollectionsMutex;
+	std::map<std::string, LoadStats::CollectionStats>	mCollections;
+};
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,119 @@
+//
+//  MappedFile.cpp
+//  gltf
+//
+
+#include "MappedFile.h"
+
+#include "cinder/Log.h"
+#include "cinder/CinderAssert.h"
+
+#if defined( CINDER_MSW )
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace cinder {
+namespace gltf {
+
+MappedFileRef MappedFile::create( const ci::fs::path &path )
+{
+	MappedFileRef ret( new MappedFile );
+	if( ! ret->map( path ) )
+		return MappedFileRef();
+	return ret;
+}
+
+MappedFile::MappedFile()
+: mData( nullptr ), mSize( 0 )
+#if defined( CINDER_MSW )
+	, mFileHandle( INVALID_HANDLE_VALUE ), mMappingHandle( nullptr )
+#endif
+{
+}
+
+#if defined( CINDER_MSW )
+
+bool MappedFile::map( const ci::fs::path &path )
+{
+	mFileHandle = ::CreateFileW( path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+								 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+	if( mFileHandle == INVALID_HANDLE_VALUE ) {
+		CI_LOG_E( "Couldn't open " << path << " for mapping" );
+		return false;
+	}
+	LARGE_INTEGER size;
+	if( ! ::GetFileSizeEx( mFileHandle, &size ) || size.QuadPart == 0 )
+		return false;
+	mMappingHandle = ::CreateFileMappingW( mFileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	if( ! mMappingHandle ) {
+		CI_LOG_E( "Couldn't map " << path );
+		return false;
+	}
+	// read only, pages are shared with every other reader.
+	mData = static_cast<const uint8_t*>( ::MapViewOfFile( mMappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+	mSize = static_cast<size_t>( size.QuadPart );
+	return mData != nullptr;
+}
+
+MappedFile::~MappedFile()
+{
+	if( mData )
+		::UnmapViewOfFile( mData );
+	if( mMappingHandle )
+		::CloseHandle( mMappingHandle );
+	if( mFileHandle != INVALID_HANDLE_VALUE )
+		::CloseHandle( mFileHandle );
+}
+
+#else
+
+bool MappedFile::map( const ci::fs::path &path )
+{
+	auto fd = ::open( path.string().c_str(), O_RDONLY );
+	if( fd < 0 ) {
+		CI_LOG_E( "Couldn't open " << path << " for mapping" );
+		return false;
+	}
+	struct stat info;
+	if( ::fstat( fd, &info ) != 0 || info.st_size == 0 ) {
+		::close( fd );
+		return false;
+	}
+	// read only, pages are shared with every other reader.
+	auto data = ::mmap( nullptr, static_cast<size_t>( info.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+	::close( fd );
+	if( data == MAP_FAILED ) {
+		CI_LOG_E( "Couldn't map " << path );
+		return false;
+	}
+	mData = static_cast<const uint8_t*>( data );
+	mSize = static_cast<size_t>( info.st_size );
+	return true;
+}
+
+MappedFile::~MappedFile()
+{
+	if( mData )
+		::munmap( const_cast<uint8_t*>( mData ), mSize );
+}
+
+#endif
+
+ci::BufferRef MappedFile::createBuffer( size_t offset, size_t size )
+{
+	CI_ASSERT( offset + size <= mSize );
+	// The Buffer doesn't own the memory, the deleter keeps the mapping alive instead. Writing
+	// through it faults, the pages are read only.
+	auto mapping = shared_from_this();
+	return ci::BufferRef( new ci::Buffer( const_cast<uint8_t*>( mData + offset ), size ), [mapping]( ci::Buffer *buffer ) {
+		delete buffer;
+	} );
+}
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,48 @@
+//
+//  MappedFile.h
+//  gltf
+//
+//  Read only memory mapping of a file on disk.
+//
+
+#pragma once
+
+#include <memory>
+
+#include "cinder/Filesystem.h"
+#include "cinder/Buffer.h"
+
+namespace cinder {
+namespace gltf {
+
+using MappedFileRef = std::shared_ptr<class MappedFile>;
+
+class MappedFile : public std::enable_shared_from_this<MappedFile> {
+public:
+	//! Maps the file at /a path. Returns a null ref if the file can't be mapped.
+	static MappedFileRef create( const ci::fs::path &path );
+	~MappedFile();
+
+	//! Returns a pointer to the beginning of the mapping. Pages are mapped read only, writing
+	//! through it faults.
+	const uint8_t*	getData() const { return mData; }
+	//! Returns the size of the mapping in bytes.
+	size_t		getSize() const { return mSize; }
+	//! Returns a ci::Buffer over [/a offset, /a offset + /a size) of the mapping, without copying.
+	//! The mapping stays alive for as long as the returned buffer does. The buffer is read only,
+	//! ci::Buffer has no const variant.
+	ci::BufferRef	createBuffer( size_t offset, size_t size );
+
+private:
+	MappedFile();
+	bool	map( const ci::fs::path &path );
+
+	const uint8_t	*mData;
+	size_t	mSize;
+#if defined( CINDER_MSW )
+	void	*mFileHandle, *mMappingHandle;
+#endif
+};
+
+} // namespace gltf
+} // namespace cinder
@@ -7,6 +7,10 @@
 //
 
 #include "MeshLoader.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <limits>
 
 using namespace std;
 
@@ -15,7 +19,7 @@ namespace gltf {
 	
  MeshLoader::MeshLoader( const Mesh *mesh )
 : mMesh( mesh ), mNumIndices( 0 ), mNumVertices( 0 ),
-mPrimitive( ci::geom::Primitive::NUM_PRIMITIVES )
+mPrimitive( ci::geom::Primitive::NUM_PRIMITIVES ), mVertexCacheSize( 0 ), mOverdrawThreshold( 0.0f ), mReorderVertices( false )
 {
 	bool primitiveSet = false;
 	bool verticesSet = false;
@@ -37,24 +41,22 @@ mPrimitive( ci::geom::Primitive::NUM_PRIMITIVES )
 				mNumVertices = vertAccessor->count;
 				verticesSet = true;
 			}
-			else
-				CI_ASSERT( mNumVertices == vertAccessor->count );
-			
-			if( prim.indices != nullptr ) {
-				auto count = prim.indices->count;
-				mIndexAccessors.emplace_back( prim.indices );
-				mMeshInstances.emplace_back( prim.material, static_cast<uint32_t>(mNumIndices), count );
-				mNumIndices += count;
-			}
-			else {
-				
-			}
+			// malformed, loadInto() skips it when the vertices are reordered.
+			else if( mNumVertices != vertAccessor->count )
+				CI_LOG_W( "Accessor " << vertAccessor->key << " has " << vertAccessor->count << " values, the mesh has " << mNumVertices << " vertices" );
 			
 			auto emplaced = mAttribAccessors.emplace( attribAccessors.attrib, vertAccessor );
 			if( ! emplaced.second )
 				CI_ASSERT( emplaced.first->second == vertAccessor );
 			mAvailableAttribs.insert( attribAccessors.attrib );
 		}
+		
+		if( prim.indices != nullptr ) {
+			auto count = prim.indices->count;
+			mIndexAccessors.emplace_back( prim.indices );
+			mMeshInstances.emplace_back( prim.material, static_cast<uint32_t>(mNumIndices), count );
+			mNumIndices += count;
+		}
 	}
 	verticesSet = true;
 }
@@ -68,55 +70,131 @@ mPrimitive( ci::geom::Primitive::NUM_PRIMITIVES )
 		return 0;
 }
 
-template<typename T>
- void MeshLoader::copyIndices( std::vector<uint32_t> &indices, const T *data, uint32_t count ) const
+uint8_t MeshLoader::getRequiredBytesPerIndex() const
 {
-	auto sizeOffset = static_cast<uint32_t>( indices.size() );
-	indices.resize( sizeOffset + count );
-	for( uint32_t i = 0; i < count; i++ ) {
-		indices[sizeOffset+i] = (*data++);
-	}
+	// the widest index type the accessors are stored as, unless the vertices fit a narrower one.
+	uint8_t storedBytes = 1;
+	for( auto index : mIndexAccessors )
+		storedBytes = std::max( storedBytes, index->getNumBytesForComponentType() );
+	uint8_t neededBytes = 4;
+	if( mNumVertices <= size_t( std::numeric_limits<uint8_t>::max() ) + 1 )
+		neededBytes = 1;
+	else if( mNumVertices <= size_t( std::numeric_limits<uint16_t>::max() ) + 1 )
+		neededBytes = 2;
+	return std::min( storedBytes, neededBytes );
 }
 
  void MeshLoader::loadInto( ci::geom::Target *target, const ci::geom::AttribSet &requestedAttribs ) const
 {
+	// the indices come first when they decide the order of the vertices.
+	std::vector<uint32_t> indices, vertexOrder;
+	bool indicesInPlace = false;
+	if( mIndexAccessors.size() == 1 && ! mVertexCacheSize && ! mReorderVertices ) {
+		auto index = mIndexAccessors.front();
+		indicesInPlace = index->componentType == Accessor::ComponentType::UNSIGNED_INT && index->getByteStride() == sizeof( uint32_t )
+						 && index->bufferView && ! index->isSparse();
+	}
+	if( ! mIndexAccessors.empty() && ! indicesInPlace )
+		indices = loadIndices( &vertexOrder );
+	
+	std::vector<float> converted, remapped;
 	for( auto & attrib : requestedAttribs ) {
 		auto found = mAttribAccessors.find( attrib );
-		if( found != mAttribAccessors.end() ) {
-			auto accessor = found->second;
-			auto dims = accessor->getNumComponents();
-			auto count = accessor->count;
-			auto dataPtr = reinterpret_cast<float*>(accessor->getDataPtr());
-			target->copyAttrib( found->first, dims,  0, dataPtr, count );
+		if( found == mAttribAccessors.end() )
+			continue;
+		auto accessor = found->second;
+		auto dims = accessor->getNumComponents();
+		auto count = accessor->count;
+		bool inPlace = accessor->componentType == Accessor::ComponentType::FLOAT && accessor->bufferView && ! accessor->isSparse();
+		auto dataPtr = inPlace ? reinterpret_cast<const float*>( accessor->getDataPtr() ) : nullptr;
+		if( ! vertexOrder.empty() ) {
+			// every attribute, skin joints and weights included, follows the same order.
+			if( count != vertexOrder.size() ) {
+				CI_LOG_E( "Accessor " << accessor->key << " doesn't have a value for every vertex" );
+				continue;
+			}
+			remapped.resize( size_t( count ) * dims );
+			if( dataPtr )
+				remapVertices( remapped.data(), dataPtr, dims * sizeof( float ), accessor->getByteStride(), vertexOrder );
+			else {
+				converted.resize( size_t( count ) * dims );
+				if( ! accessor->copyTo( converted.data() ) )
+					continue;
+				remapVertices( remapped.data(), converted.data(), dims * sizeof( float ), dims * sizeof( float ), vertexOrder );
+			}
+			target->copyAttrib( found->first, dims, 0, remapped.data(), count );
+			continue;
 		}
-	}
-	if( ! mIndexAccessors.empty() ) {
-		std::vector<uint32_t> indices;
-		for( auto index : mIndexAccessors ) {
-			auto byteLengthPerComponent = index->getNumBytesForComponentType();
-			auto dataPtr = reinterpret_cast<uint8_t*>(index->getDataPtr());
-			
-			if( byteLengthPerComponent == 1 )
-				copyIndices( indices, dataPtr, index->count );
-			else if( byteLengthPerComponent == 2 )
-				copyIndices( indices, reinterpret_cast<uint16_t*>( dataPtr ), index->count );
-			else if( byteLengthPerComponent == 4 )
-				copyIndices( indices, reinterpret_cast<uint32_t*>( dataPtr ), index->count );
+		// float data is handed over in place, interleaved or not.
+		if( inPlace ) {
+			if( dataPtr )
+				target->copyAttrib( found->first, dims, accessor->byteStride, dataPtr, count );
+			continue;
 		}
+		// quantized, sparse and bufferView-less data is converted first.
+		converted.resize( size_t( count ) * dims );
+		if( accessor->copyTo( converted.data() ) )
+			target->copyAttrib( found->first, dims, 0, converted.data(), count );
+	}
+	if( mIndexAccessors.empty() )
+		return;
+	
+	auto bytesRequired = getRequiredBytesPerIndex();
+	CI_ASSERT_MSG( mNumIndices <= std::numeric_limits<uint32_t>::max(), "Can't exceed uint32_t max amount of indices." );
+	// a single packed uint32 index accessor is handed over in place.
+	if( indicesInPlace ) {
+		auto dataPtr = reinterpret_cast<const uint32_t*>( mIndexAccessors.front()->getDataPtr() );
+		if( dataPtr )
+			target->copyIndices( mPrimitive, dataPtr, mNumIndices, bytesRequired );
+		return;
+	}
+	target->copyIndices( mPrimitive, indices.data(), mNumIndices, bytesRequired );
+}
+
+std::vector<uint32_t> MeshLoader::loadIndices() const
+{
+	std::vector<uint32_t> vertexOrder;
+	return loadIndices( &vertexOrder );
+}
+
+std::vector<uint32_t> MeshLoader::loadIndices( std::vector<uint32_t> *vertexOrder ) const
+{
+	std::vector<uint32_t> ret( mNumIndices );
+	auto indicesPtr = ret.data();
+	for( auto index : mIndexAccessors ) {
+		if( ! index->copyTo( indicesPtr ) )
+			std::fill( indicesPtr, indicesPtr + index->count, 0u );
+		indicesPtr += index->count;
+	}
+	// triangles are only reordered within their MeshInstance, so each keeps its material.
+	if( mVertexCacheSize && mPrimitive == ci::geom::Primitive::TRIANGLES ) {
+		for( auto &instance : mMeshInstances )
+			optimizeVertexCache( ret.data() + instance.first, instance.count, mVertexCacheSize );
 		
-		size_t totalNumIndices = indices.size();
-		uint8_t bytesRequired = 0;
-		if( totalNumIndices < std::numeric_limits<uint8_t>::max() )
-			bytesRequired = sizeof( uint8_t );
-		else if( totalNumIndices < std::numeric_limits<uint16_t>::max() )
-			bytesRequired = sizeof( uint16_t );
-		else if( totalNumIndices < std::numeric_limits<uint32_t>::max() )
-			bytesRequired = sizeof( uint32_t );
-		else
-			CI_ASSERT_MSG( totalNumIndices < std::numeric_limits<uint32_t>::max(), "Can't exceed uint32_t max amount of indices." );
-		
-		target->copyIndices( mPrimitive, indices.data(), totalNumIndices,  bytesRequired );
+		auto found = mAttribAccessors.find( ci::geom::Attrib::POSITION );
+		if( mOverdrawThreshold > 0.0f && found != mAttribAccessors.end() && found->second->getNumComponents() == 3 ) {
+			auto accessor = found->second;
+			std::vector<float> converted;
+			const float *positions = nullptr;
+			if( accessor->componentType == Accessor::ComponentType::FLOAT && accessor->bufferView && ! accessor->isSparse() )
+				positions = reinterpret_cast<const float*>( accessor->getDataPtr() );
+			else {
+				converted.resize( size_t( accessor->count ) * 3 );
+				if( accessor->copyTo( converted.data() ) )
+					positions = converted.data();
+			}
+			auto stride = converted.empty() ? accessor->getByteStride() : 3 * sizeof( float );
+			for( auto &instance : mMeshInstances ) {
+				if( positions )
+					optimizeOverdraw( ret.data() + instance.first, instance.count, positions, accessor->count, stride,
+									  mOverdrawThreshold, mVertexCacheSize );
+			}
+		}
 	}
+	// the vertices are shared by every primitive, they're ordered by first use across all of them.
+	if( mReorderVertices )
+		*vertexOrder = optimizeVertexFetch( ret.data(), ret.size(), mNumVertices );
+	return ret;
 }
 	
 } // namespace gltf
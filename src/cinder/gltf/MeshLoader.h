@@ -47,14 +47,35 @@ public:
 	//! Returns Mesh Instance for this mesh.
 	const std::vector<MeshInstance>& getMeshInstances() { return mMeshInstances; }
 	
+	//! Reorders the triangles of each MeshInstance for a post-transform vertex cache of
+	//! /a cacheSize entries when the indices are loaded, see optimizeVertexCache(). Off by default.
+	MeshLoader&	reorderForVertexCache( bool reorder = true, uint32_t cacheSize = 16 ) { mVertexCacheSize = reorder ? cacheSize : 0; return *this; }
+	//! Draws the clusters of each MeshInstance's triangles that occlude the most first, after
+	//! they're reordered for the vertex cache, see optimizeOverdraw(). Needs reorderForVertexCache()
+	//! and vec3 positions. Off by default.
+	MeshLoader&	reorderForOverdraw( bool reorder = true, float threshold = 1.05f ) { mOverdrawThreshold = reorder ? threshold : 0.0f; return *this; }
+	//! Renumbers the vertices in the order the indices first use them and loads every attribute in
+	//! that order, see optimizeVertexFetch(). Off by default.
+	MeshLoader&	reorderForVertexFetch( bool reorder = true ) { mReorderVertices = reorder; return *this; }
+	//! Returns the indices of every primitive as loadInto() hands them over, e.g. to measure them
+	//! with analyzeVertexCache().
+	std::vector<uint32_t>	loadIndices() const;
+	
 private:
-	template<typename T>
-	void copyIndices( std::vector<uint32_t> &indices, const T* data, uint32_t count ) const;
+	//! Returns the narrowest index type that holds every vertex index, no wider than the index
+	//! accessors are stored as.
+	uint8_t getRequiredBytesPerIndex() const;
+	//! Loads the indices, writing the original vertex of each new one to /a vertexOrder if the
+	//! vertices are reordered.
+	std::vector<uint32_t>	loadIndices( std::vector<uint32_t> *vertexOrder ) const;
 	
 	const Mesh			*mMesh;
 	ci::geom::AttribSet mAvailableAttribs;
 	size_t				mNumVertices, mNumIndices;
 	ci::geom::Primitive mPrimitive;
+	uint32_t			mVertexCacheSize;
+	float				mOverdrawThreshold;
+	bool				mReorderVertices;
 	
 	std::map<ci::geom::Attrib, const Accessor*> mAttribAccessors;
 	std::vector<const Accessor*>	mIndexAccessors;
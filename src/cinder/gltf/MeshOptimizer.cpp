@@ -0,0 +1,368 @@
+//
+//  MeshOptimizer.cpp
+//  gltf
+//
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace cinder {
+namespace gltf {
+
+VertexCacheStats analyzeVertexCache( const uint32_t *indices, size_t numIndices, size_t numVertices, uint32_t cacheSize )
+{
+	VertexCacheStats ret;
+	ret.numTriangles = numIndices / 3;
+	// the number of transforms when each vertex last entered the cache, 0 if it never did.
+	std::vector<size_t> entered( numVertices, 0 );
+	for( size_t i = 0; i < ret.numTriangles * 3; i++ ) {
+		auto vertex = indices[i];
+		if( vertex >= numVertices )
+			continue;
+		if( entered[vertex] && ret.numTransforms - entered[vertex] < cacheSize )
+			continue;
+		if( ! entered[vertex] )
+			ret.numVertices++;
+		entered[vertex] = ++ret.numTransforms;
+	}
+	return ret;
+}
+
+void optimizeVertexCache( uint32_t *indices, size_t numIndices, uint32_t cacheSize )
+{
+	size_t numTriangles = numIndices / 3;
+	if( numTriangles < 2 )
+		return;
+	// vertices are numbered from the lowest one referenced, ranges of a shared buffer start anywhere.
+	auto bounds = std::minmax_element( indices, indices + numTriangles * 3 );
+	uint32_t base = *bounds.first;
+	size_t numVertices = size_t( *bounds.second - base ) + 1;
+
+	// the triangles using each vertex, as ranges of one array.
+	std::vector<uint32_t> live( numVertices, 0 );
+	for( size_t i = 0; i < numTriangles * 3; i++ )
+		live[indices[i] - base]++;
+	std::vector<uint32_t> offsets( numVertices + 1, 0 );
+	for( size_t vertex = 0; vertex < numVertices; vertex++ )
+		offsets[vertex + 1] = offsets[vertex] + live[vertex];
+	std::vector<uint32_t> adjacency( numTriangles * 3 );
+	{
+		auto next = offsets;
+		for( size_t i = 0; i < numTriangles * 3; i++ )
+			adjacency[next[indices[i] - base]++] = static_cast<uint32_t>( i / 3 );
+	}
+
+	std::vector<int64_t> cacheTime( numVertices, 0 );
+	std::vector<bool> emitted( numTriangles, false );
+	std::vector<uint32_t> deadEnd, candidates, reordered;
+	deadEnd.reserve( numTriangles * 3 );
+	reordered.reserve( numTriangles * 3 );
+	int64_t time = cacheSize + 1;
+	size_t cursor = 0;
+
+	// the next vertex to fan around: the candidate staying longest in the cache after its
+	// remaining triangles are emitted, else the latest vertex with triangles left, else any.
+	auto getNextVertex = [&]() -> int64_t {
+		int64_t best = -1, bestPriority = -1;
+		for( auto vertex : candidates ) {
+			if( ! live[vertex] )
+				continue;
+			int64_t priority = 0;
+			if( time - cacheTime[vertex] + 2 * int64_t( live[vertex] ) <= int64_t( cacheSize ) )
+				priority = time - cacheTime[vertex];
+			if( priority > bestPriority ) {
+				bestPriority = priority;
+				best = vertex;
+			}
+		}
+		if( best >= 0 )
+			return best;
+		while( ! deadEnd.empty() ) {
+			auto vertex = deadEnd.back();
+			deadEnd.pop_back();
+			if( live[vertex] )
+				return vertex;
+		}
+		for( ; cursor < numVertices; cursor++ ) {
+			if( live[cursor] )
+				return static_cast<int64_t>( cursor );
+		}
+		return -1;
+	};
+
+	// the lowest vertex is always referenced.
+	int64_t fanning = 0;
+	while( fanning >= 0 ) {
+		candidates.clear();
+		for( auto i = offsets[fanning]; i < offsets[fanning + 1]; i++ ) {
+			auto triangle = adjacency[i];
+			if( emitted[triangle] )
+				continue;
+			emitted[triangle] = true;
+			for( size_t corner = 0; corner < 3; corner++ ) {
+				auto index = indices[triangle * 3 + corner];
+				auto vertex = index - base;
+				reordered.push_back( index );
+				deadEnd.push_back( vertex );
+				candidates.push_back( vertex );
+				live[vertex]--;
+				if( time - cacheTime[vertex] > int64_t( cacheSize ) )
+					cacheTime[vertex] = time++;
+			}
+		}
+		fanning = getNextVertex();
+	}
+	std::copy( reordered.begin(), reordered.end(), indices );
+}
+
+namespace {
+
+//! Reads vec3 positions /a stride bytes apart.
+struct Positions {
+	const uint8_t	*data;
+	size_t			stride;
+
+	const float*	operator[]( uint32_t vertex ) const { return reinterpret_cast<const float*>( data + size_t( vertex ) * stride ); }
+};
+
+//! Rasterizes the triangles at /a indices in order into /a depth, looking down the /a axis from
+//! the positive side if /a sign is 1, and counts the pixels that pass the depth test in /a stats.
+void rasterizeView( const uint32_t *indices, size_t numTriangles, const Positions &positions, const float *boundsMin, const float *boundsMax,
+					int axis, float sign, uint32_t resolution, std::vector<float> &depth, OverdrawStats *stats )
+{
+	int u = ( axis + 1 ) % 3, v = ( axis + 2 ) % 3;
+	float extent = std::max( boundsMax[u] - boundsMin[u], boundsMax[v] - boundsMin[v] );
+	if( extent <= 0.0f )
+		return;
+	float scale = resolution / extent;
+	std::fill( depth.begin(), depth.end(), std::numeric_limits<float>::max() );
+
+	for( size_t triangle = 0; triangle < numTriangles; triangle++ ) {
+		float x[3], y[3], z[3];
+		for( int corner = 0; corner < 3; corner++ ) {
+			auto position = positions[indices[triangle * 3 + corner]];
+			x[corner] = ( position[u] - boundsMin[u] ) * scale;
+			y[corner] = ( position[v] - boundsMin[v] ) * scale;
+			// closer to the viewer is smaller.
+			z[corner] = -sign * position[axis];
+		}
+		// counter-clockwise triangles face the viewer, back faces are culled.
+		float area = ( x[1] - x[0] ) * ( y[2] - y[0] ) - ( x[2] - x[0] ) * ( y[1] - y[0] );
+		if( area * sign <= 0.0f )
+			continue;
+
+		int minX = std::max( 0, int( std::floor( std::min( { x[0], x[1], x[2] } ) ) ) );
+		int maxX = std::min( int( resolution ) - 1, int( std::ceil( std::max( { x[0], x[1], x[2] } ) ) ) );
+		int minY = std::max( 0, int( std::floor( std::min( { y[0], y[1], y[2] } ) ) ) );
+		int maxY = std::min( int( resolution ) - 1, int( std::ceil( std::max( { y[0], y[1], y[2] } ) ) ) );
+		for( int py = minY; py <= maxY; py++ ) {
+			for( int px = minX; px <= maxX; px++ ) {
+				float cx = px + 0.5f, cy = py + 0.5f;
+				// barycentric weights, all positive inside the triangle whatever its winding.
+				float w0 = ( ( x[1] - cx ) * ( y[2] - cy ) - ( x[2] - cx ) * ( y[1] - cy ) ) / area;
+				float w1 = ( ( x[2] - cx ) * ( y[0] - cy ) - ( x[0] - cx ) * ( y[2] - cy ) ) / area;
+				float w2 = 1.0f - w0 - w1;
+				if( w0 < 0.0f || w1 < 0.0f || w2 < 0.0f )
+					continue;
+				float pixelDepth = w0 * z[0] + w1 * z[1] + w2 * z[2];
+				auto &stored = depth[size_t( py ) * resolution + px];
+				if( pixelDepth < stored ) {
+					if( stored == std::numeric_limits<float>::max() )
+						stats->numPixelsCovered++;
+					stored = pixelDepth;
+					stats->numPixelsShaded++;
+				}
+			}
+		}
+	}
+}
+
+} // anonymous namespace
+
+OverdrawStats analyzeOverdraw( const uint32_t *indices, size_t numIndices, const float *positions, size_t numVertices, size_t positionStride,
+							   uint32_t resolution )
+{
+	OverdrawStats ret;
+	Positions vertices{ reinterpret_cast<const uint8_t*>( positions ), positionStride };
+	size_t numTriangles = numIndices / 3;
+	for( size_t i = 0; i < numTriangles * 3; i++ ) {
+		if( indices[i] >= numVertices )
+			return ret;
+	}
+	if( ! numVertices || ! resolution )
+		return ret;
+
+	float boundsMin[3], boundsMax[3];
+	for( int axis = 0; axis < 3; axis++ )
+		boundsMin[axis] = boundsMax[axis] = vertices[0][axis];
+	for( uint32_t vertex = 1; vertex < numVertices; vertex++ ) {
+		for( int axis = 0; axis < 3; axis++ ) {
+			boundsMin[axis] = std::min( boundsMin[axis], vertices[vertex][axis] );
+			boundsMax[axis] = std::max( boundsMax[axis], vertices[vertex][axis] );
+		}
+	}
+
+	std::vector<float> depth( size_t( resolution ) * resolution );
+	for( int axis = 0; axis < 3; axis++ ) {
+		rasterizeView( indices, numTriangles, vertices, boundsMin, boundsMax, axis, 1.0f, resolution, depth, &ret );
+		rasterizeView( indices, numTriangles, vertices, boundsMin, boundsMax, axis, -1.0f, resolution, depth, &ret );
+	}
+	return ret;
+}
+
+void optimizeOverdraw( uint32_t *indices, size_t numIndices, const float *positions, size_t numVertices, size_t positionStride,
+					   float threshold, uint32_t cacheSize )
+{
+	size_t numTriangles = numIndices / 3;
+	if( numTriangles < 2 )
+		return;
+	for( size_t i = 0; i < numTriangles * 3; i++ ) {
+		if( indices[i] >= numVertices )
+			return;
+	}
+	Positions vertices{ reinterpret_cast<const uint8_t*>( positions ), positionStride };
+
+	// cache misses of each triangle in the current order, a FIFO cache as in analyzeVertexCache().
+	std::vector<uint8_t> misses( numTriangles, 0 );
+	{
+		std::vector<size_t> entered( numVertices, 0 );
+		size_t numTransforms = 0;
+		for( size_t i = 0; i < numTriangles * 3; i++ ) {
+			auto vertex = indices[i];
+			if( entered[vertex] && numTransforms - entered[vertex] < cacheSize )
+				continue;
+			entered[vertex] = ++numTransforms;
+			misses[i / 3]++;
+		}
+	}
+
+	// hard boundaries where every vertex of a triangle missed, the cache restarted there. Each run
+	// is split further wherever its miss ratio so far is within threshold of the whole run's. A
+	// cluster may be drawn after any other, so its misses are counted from an empty cache, and a
+	// split is only made while the clusters so far miss within threshold of the current order.
+	std::vector<size_t> clusters;
+	std::vector<size_t> entered( numVertices, 0 );
+	size_t numTransforms = 0, numMisses = 0, closedMisses = 0;
+	size_t clusterBegin = 0, clusterMisses = 0, clusterTransforms = 0;
+	for( size_t begin = 0; begin < numTriangles; ) {
+		size_t end = begin + 1;
+		while( end < numTriangles && misses[end] < 3 )
+			end++;
+		size_t runMisses = 0;
+		for( size_t triangle = begin; triangle < end; triangle++ )
+			runMisses += misses[triangle];
+		float splitAcmr = float( runMisses ) / float( end - begin ) * threshold;
+
+		for( size_t triangle = begin; triangle < end; triangle++ ) {
+			for( size_t corner = 0; corner < 3; corner++ ) {
+				auto vertex = indices[triangle * 3 + corner];
+				if( entered[vertex] > clusterTransforms && numTransforms - entered[vertex] < cacheSize )
+					continue;
+				entered[vertex] = ++numTransforms;
+				clusterMisses++;
+			}
+			numMisses += misses[triangle];
+			bool split = triangle + 1 == end || float( clusterMisses ) / float( triangle + 1 - clusterBegin ) <= splitAcmr;
+			if( split && triangle + 1 < numTriangles && float( closedMisses + clusterMisses ) <= float( numMisses ) * threshold ) {
+				clusters.push_back( clusterBegin );
+				closedMisses += clusterMisses;
+				clusterBegin = triangle + 1;
+				clusterMisses = 0;
+				clusterTransforms = numTransforms;
+			}
+		}
+		begin = end;
+	}
+	clusters.push_back( clusterBegin );
+	if( clusters.size() < 2 )
+		return;
+
+	// area weighted centroid and normal of each cluster and of the mesh.
+	size_t numClusters = clusters.size();
+	std::vector<float> clusterCentroids( numClusters * 3, 0.0f ), clusterNormals( numClusters * 3, 0.0f );
+	float meshCentroid[3] = { 0.0f, 0.0f, 0.0f }, meshArea = 0.0f;
+	for( size_t cluster = 0; cluster < numClusters; cluster++ ) {
+		size_t end = cluster + 1 < numClusters ? clusters[cluster + 1] : numTriangles;
+		float *centroid = &clusterCentroids[cluster * 3], *normal = &clusterNormals[cluster * 3], clusterArea = 0.0f;
+		for( size_t triangle = clusters[cluster]; triangle < end; triangle++ ) {
+			auto p0 = vertices[indices[triangle * 3]], p1 = vertices[indices[triangle * 3 + 1]], p2 = vertices[indices[triangle * 3 + 2]];
+			float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] }, e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			float cross[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			float area = std::sqrt( cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2] );
+			for( int axis = 0; axis < 3; axis++ ) {
+				centroid[axis] += ( p0[axis] + p1[axis] + p2[axis] ) / 3.0f * area;
+				normal[axis] += cross[axis];
+			}
+			clusterArea += area;
+		}
+		for( int axis = 0; axis < 3; axis++ ) {
+			meshCentroid[axis] += centroid[axis];
+			centroid[axis] = clusterArea > 0.0f ? centroid[axis] / clusterArea : 0.0f;
+		}
+		meshArea += clusterArea;
+	}
+	for( int axis = 0; axis < 3; axis++ )
+		meshCentroid[axis] = meshArea > 0.0f ? meshCentroid[axis] / meshArea : 0.0f;
+
+	std::vector<float> sortKeys( numClusters );
+	for( size_t cluster = 0; cluster < numClusters; cluster++ ) {
+		auto centroid = &clusterCentroids[cluster * 3], normal = &clusterNormals[cluster * 3];
+		float length = std::sqrt( normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] );
+		float dot = 0.0f;
+		for( int axis = 0; axis < 3; axis++ )
+			dot += ( centroid[axis] - meshCentroid[axis] ) * normal[axis];
+		sortKeys[cluster] = length > 0.0f ? dot / length : 0.0f;
+	}
+	std::vector<size_t> order( numClusters );
+	for( size_t cluster = 0; cluster < numClusters; cluster++ )
+		order[cluster] = cluster;
+	std::stable_sort( order.begin(), order.end(), [&]( size_t lhs, size_t rhs ) { return sortKeys[lhs] > sortKeys[rhs]; } );
+
+	std::vector<uint32_t> reordered;
+	reordered.reserve( numTriangles * 3 );
+	for( auto cluster : order ) {
+		size_t end = cluster + 1 < numClusters ? clusters[cluster + 1] : numTriangles;
+		reordered.insert( reordered.end(), indices + clusters[cluster] * 3, indices + end * 3 );
+	}
+	// the last cluster isn't bounded, the current order is kept if it tipped the misses over.
+	if( float( analyzeVertexCache( reordered.data(), reordered.size(), numVertices, cacheSize ).numTransforms ) > float( numMisses ) * threshold )
+		return;
+	std::copy( reordered.begin(), reordered.end(), indices );
+}
+
+std::vector<uint32_t> optimizeVertexFetch( uint32_t *indices, size_t numIndices, size_t numVertices )
+{
+	const uint32_t unused = std::numeric_limits<uint32_t>::max();
+	std::vector<uint32_t> newVertices( numVertices, unused ), ret;
+	ret.reserve( numVertices );
+	for( size_t i = 0; i < numIndices; i++ ) {
+		auto vertex = indices[i];
+		if( vertex >= numVertices )
+			continue;
+		if( newVertices[vertex] == unused ) {
+			newVertices[vertex] = static_cast<uint32_t>( ret.size() );
+			ret.push_back( vertex );
+		}
+		indices[i] = newVertices[vertex];
+	}
+	for( size_t vertex = 0; vertex < numVertices; vertex++ ) {
+		if( newVertices[vertex] == unused )
+			ret.push_back( static_cast<uint32_t>( vertex ) );
+	}
+	return ret;
+}
+
+void remapVertices( void *dst, const void *src, size_t vertexSize, size_t stride, const std::vector<uint32_t> &vertexOrder )
+{
+	auto dstBytes = reinterpret_cast<uint8_t*>( dst );
+	auto srcBytes = reinterpret_cast<const uint8_t*>( src );
+	for( size_t i = 0; i < vertexOrder.size(); i++ )
+		memcpy( dstBytes + i * vertexSize, srcBytes + size_t( vertexOrder[i] ) * stride, vertexSize );
+}
+
+} // namespace gltf
+} // namespace cinder
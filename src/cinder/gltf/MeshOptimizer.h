@@ -0,0 +1,85 @@
+//
+//  MeshOptimizer.h
+//  gltf
+//
+//  Reordering of triangle lists and vertices for the GPU's post-transform vertex cache, overdraw
+//  and vertex fetch, measured on the CPU.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cinder {
+namespace gltf {
+
+//! Post-transform vertex cache behavior of a triangle list, simulated with a FIFO cache.
+struct VertexCacheStats {
+	size_t	numTriangles{0};
+	//! Number of distinct vertices referenced.
+	size_t	numVertices{0};
+	//! Number of vertices transformed, i.e. cache misses.
+	size_t	numTransforms{0};
+
+	//! Returns the average cache miss ratio, transforms per triangle. 0.5 is about the best a
+	//! regular grid allows, 3 means no reuse at all.
+	float	getAcmr() const { return numTriangles ? float( numTransforms ) / float( numTriangles ) : 0.0f; }
+	//! Returns the average transform to vertex ratio, 1 is ideal.
+	float	getAtvr() const { return numVertices ? float( numTransforms ) / float( numVertices ) : 0.0f; }
+};
+
+//! Simulates a FIFO vertex cache of /a cacheSize entries over the triangle list /a indices, whose
+//! /a numIndices reference vertices below /a numVertices.
+VertexCacheStats	analyzeVertexCache( const uint32_t *indices, size_t numIndices, size_t numVertices, uint32_t cacheSize = 16 );
+//! Analyzes the triangle list /a indices, see above.
+inline VertexCacheStats	analyzeVertexCache( const std::vector<uint32_t> &indices, size_t numVertices, uint32_t cacheSize = 16 )
+{
+	return analyzeVertexCache( indices.data(), indices.size(), numVertices, cacheSize );
+}
+
+//! Reorders the triangles of the triangle list /a indices in place with Tipsify (Sander, Nehab
+//! and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw", 2007) for a
+//! cache of /a cacheSize entries. Runs in linear time, the winding of each triangle is kept.
+void	optimizeVertexCache( uint32_t *indices, size_t numIndices, uint32_t cacheSize = 16 );
+
+//! Overdraw of a triangle list rendered opaque with back faces culled, rasterized on the CPU.
+struct OverdrawStats {
+	//! Number of pixels covered by the mesh, summed over every view.
+	size_t	numPixelsCovered{0};
+	//! Number of pixels that passed the depth test when drawn, i.e. were shaded.
+	size_t	numPixelsShaded{0};
+
+	//! Returns the pixels shaded per pixel covered, 1 is ideal.
+	float	getOverdraw() const { return numPixelsCovered ? float( numPixelsShaded ) / float( numPixelsCovered ) : 0.0f; }
+};
+
+//! Estimates the overdraw of drawing the triangle list /a indices in order, from the six axis
+//! aligned directions at /a resolution pixels square. /a positions holds /a numVertices vec3
+//! positions, /a positionStride bytes apart.
+OverdrawStats	analyzeOverdraw( const uint32_t *indices, size_t numIndices, const float *positions, size_t numVertices,
+								 size_t positionStride, uint32_t resolution = 256 );
+
+//! Reorders the triangle list /a indices in place to draw occluders first, after it was ordered
+//! for the vertex cache by optimizeVertexCache(). The triangles are split into clusters where
+//! the cache restarts and where a cluster's miss ratio is within /a threshold of the whole run,
+//! then the clusters are drawn outward facing first, by the dot product of their normal and
+//! their offset from the mesh's centroid. Triangles within a cluster keep their order. The ACMR
+//! of the result stays within /a threshold times that of the order given, the order is kept
+//! otherwise, so a higher /a threshold trades cache hits for less overdraw. /a positions as above.
+void	optimizeOverdraw( uint32_t *indices, size_t numIndices, const float *positions, size_t numVertices, size_t positionStride,
+						  float threshold = 1.05f, uint32_t cacheSize = 16 );
+
+//! Renumbers the vertices of the triangle list /a indices in the order they're first used and
+//! rewrites /a indices to match, so vertices are fetched front to back. Vertices that aren't
+//! referenced follow in their original order. Returns the original vertex of each of the
+//! /a numVertices new ones, to remap every attribute with remapVertices(). Run it after
+//! optimizeVertexCache(), which decides the order.
+std::vector<uint32_t>	optimizeVertexFetch( uint32_t *indices, size_t numIndices, size_t numVertices );
+//! Writes the vertices of /a vertexSize bytes, /a stride bytes apart at /a src, to /a dst in
+//! /a vertexOrder, see optimizeVertexFetch(). /a dst must hold vertexOrder.size() packed vertices.
+void	remapVertices( void *dst, const void *src, size_t vertexSize, size_t stride, const std::vector<uint32_t> &vertexOrder );
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,149 @@
+//
+//  ResourceCache.cpp
+//  gltf
+//
+
+#include "ResourceCache.h"
+
+#include "cinder/DataSource.h"
+
+namespace cinder {
+namespace gltf {
+
+ResourceCache& ResourceCache::get()
+{
+	static ResourceCache sCache;
+	return sCache;
+}
+
+bool ResourceCache::makeKey( const ci::fs::path &path, Key *key )
+{
+	// a missing file is reported by the load that follows.
+	try {
+		auto canonical = ci::fs::canonical( path );
+		key->modified = static_cast<uint64_t>( ci::fs::last_write_time( canonical ) );
+		key->size = static_cast<uint64_t>( ci::fs::file_size( canonical ) );
+		key->path = canonical.string();
+		return true;
+	}
+	catch( const std::exception & ) {
+		return false;
+	}
+}
+
+template<typename Map>
+void ResourceCache::pruneExpired( Map &entries )
+{
+	for( auto it = entries.begin(); it != entries.end(); ) {
+		if( it->second.expired() )
+			it = entries.erase( it );
+		else
+			++it;
+	}
+}
+
+template<>
+void ResourceCache::pruneExpired( std::unordered_map<Key, ImageEntry, KeyHash> &entries )
+{
+	for( auto it = entries.begin(); it != entries.end(); ) {
+		if( it->second.image.expired() && ! it->second.pending.valid() )
+			it = entries.erase( it );
+		else
+			++it;
+	}
+}
+
+ci::BufferRef ResourceCache::loadBuffer( const ci::fs::path &path )
+{
+	Key key;
+	if( ! makeKey( path, &key ) )
+		return loadFile( path )->getBuffer();
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		auto found = mBuffers.find( key );
+		if( found != mBuffers.end() ) {
+			if( auto ret = found->second.lock() ) {
+				mStats.bufferHits++;
+				return ret;
+			}
+		}
+		mStats.bufferMisses++;
+	}
+
+	// read without the lock, concurrent misses on the same file settle on whichever finishes first.
+	auto ret = loadFile( path )->getBuffer();
+	std::lock_guard<std::mutex> lock( mMutex );
+	auto found = mBuffers.find( key );
+	if( found != mBuffers.end() ) {
+		if( auto existing = found->second.lock() )
+			return existing;
+	}
+	pruneExpired( mBuffers );
+	mBuffers[key] = ret;
+	return ret;
+}
+
+std::shared_future<ci::ImageSourceRef> ResourceCache::loadImage( const ci::fs::path &path, const std::function<ci::ImageSourceRef()> &decode,
+																ThreadPool::Priority priority )
+{
+	Key key;
+	if( ! makeKey( path, &key ) )
+		return ThreadPool::get().submit( decode, priority ).share();
+
+	std::lock_guard<std::mutex> lock( mMutex );
+	auto found = mImages.find( key );
+	if( found != mImages.end() ) {
+		if( auto image = found->second.image.lock() ) {
+			mStats.imageHits++;
+			std::promise<ci::ImageSourceRef> decoded;
+			decoded.set_value( image );
+			return decoded.get_future().share();
+		}
+		if( found->second.pending.valid() ) {
+			mStats.imageHits++;
+			return found->second.pending;
+		}
+	}
+
+	mStats.imageMisses++;
+	pruneExpired( mImages );
+	// the image is only published once decoded, the pending future stands in until then. The task
+	// can't finish before pending is set, it needs the lock held here.
+	auto ret = ThreadPool::get().submit( [this, key, decode]() -> ci::ImageSourceRef {
+		auto image = decode();
+		std::lock_guard<std::mutex> lock( mMutex );
+		auto &entry = mImages[key];
+		entry.image = image;
+		entry.pending = std::shared_future<ci::ImageSourceRef>();
+		return image;
+	}, priority ).share();
+	mImages[key].pending = ret;
+	return ret;
+}
+
+ResourceCache::Stats ResourceCache::getStats() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mStats;
+}
+
+void ResourceCache::resetStats()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	mStats = Stats();
+}
+
+size_t ResourceCache::getNumLiveEntries() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	size_t ret = 0;
+	for( auto &entry : mBuffers )
+		ret += entry.second.expired() ? 0 : 1;
+	for( auto &entry : mImages )
+		ret += entry.second.image.expired() && ! entry.second.pending.valid() ? 0 : 1;
+	return ret;
+}
+
+} // namespace gltf
+} // namespace cinder
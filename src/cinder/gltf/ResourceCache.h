@@ -0,0 +1,88 @@
+//
+//  ResourceCache.h
+//  gltf
+//
+//  Process wide registry of the external buffers and images loaded by every File, so that
+//  repeated and overlapping loads share memory instead of reading the same file again.
+//
+
+#pragma once
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cinder/Buffer.h"
+#include "cinder/Filesystem.h"
+#include "cinder/ImageIo.h"
+
+#include "cinder/gltf/ThreadPool.h"
+
+namespace cinder {
+namespace gltf {
+
+class ResourceCache {
+public:
+	//! Lookups since the last resetStats().
+	struct Stats {
+		size_t	bufferHits{0}, bufferMisses{0};
+		size_t	imageHits{0}, imageMisses{0};
+	};
+
+	ResourceCache() = default;
+	ResourceCache( const ResourceCache & ) = delete;
+	ResourceCache& operator=( const ResourceCache & ) = delete;
+
+	//! Returns the cache shared by every File.
+	static ResourceCache&	get();
+
+	//! Returns the contents of the file at /a path. Shares the buffer with every other caller for
+	//! as long as any of them holds it and the file's modification time and size don't change.
+	//! Throws like ci::loadFile() if the file can't be read.
+	ci::BufferRef	loadBuffer( const ci::fs::path &path );
+	//! Returns the image at /a path. On a miss /a decode is queued on the ThreadPool with
+	//! /a priority, otherwise the image decoded, or being decoded, for another caller is returned.
+	std::shared_future<ci::ImageSourceRef>	loadImage( const ci::fs::path &path, const std::function<ci::ImageSourceRef()> &decode,
+													   ThreadPool::Priority priority = ThreadPool::Priority::NORMAL );
+
+	//! Returns the hit and miss counts.
+	Stats	getStats() const;
+	//! Zeroes the hit and miss counts.
+	void	resetStats();
+	//! Returns the number of buffers and images that are still alive.
+	size_t	getNumLiveEntries() const;
+
+private:
+	//! Identifies the contents of a file, a rewritten file gets a new Key.
+	struct Key {
+		std::string	path; // canonical
+		uint64_t	modified, size;
+
+		bool operator==( const Key &rhs ) const { return modified == rhs.modified && size == rhs.size && path == rhs.path; }
+	};
+	struct KeyHash {
+		size_t operator()( const Key &key ) const { return std::hash<std::string>()( key.path ) ^ std::hash<uint64_t>()( key.modified ^ ( key.size << 1 ) ); }
+	};
+	struct ImageEntry {
+		std::weak_ptr<ci::ImageSource>			image;
+		// only set while the image is being decoded.
+		std::shared_future<ci::ImageSourceRef>	pending;
+	};
+
+	//! Creates the Key of /a path. Returns false if the file can't be stat'ed.
+	static bool	makeKey( const ci::fs::path &path, Key *key );
+	//! Erases the entries of /a entries that nobody holds anymore.
+	template<typename Map>
+	static void	pruneExpired( Map &entries );
+
+	mutable std::mutex										mMutex;
+	std::unordered_map<Key, std::weak_ptr<ci::Buffer>, KeyHash>	mBuffers;
+	std::unordered_map<Key, ImageEntry, KeyHash>				mImages;
+	Stats													mStats;
+};
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,259 @@
+//
+//  Selection.cpp
+//  gltf
+//
+//  Partial loading. The entries reachable from the selected scene, nodes and meshes are found by
+//  following the references in their JSON before any slot is allocated, everything else is
+//  never added, so unreferenced buffers aren't read and unreferenced images aren't decoded.
+//
+
+#include "File.h"
+
+#include <unordered_map>
+
+#include "cinder/Log.h"
+
+namespace cinder {
+namespace gltf {
+
+namespace {
+
+//! An entry named by its collection and key.
+using EntryRef = std::pair<std::string, std::string>;
+
+//! Appends /a ref, a key or a glTF 2.0 index, as an entry of /a typeName.
+void addRef( const char *typeName, const Json::Value &ref, bool version2, std::vector<EntryRef> *refs )
+{
+	if( ref.isString() )
+		refs->emplace_back( typeName, ref.asString() );
+	// glTF 1.0 numbers are values, e.g. a material's shininess, and so are fractions in 2.0.
+	else if( version2 && ref.isUInt() )
+		refs->emplace_back( typeName, std::to_string( ref.asUInt() ) );
+}
+
+//! Appends every element of the array /a array.
+void addRefs( const char *typeName, const Json::Value &array, bool version2, std::vector<EntryRef> *refs )
+{
+	if( ! array.isArray() )
+		return;
+	for( auto &ref : array )
+		addRef( typeName, ref, version2, refs );
+}
+
+//! Appends every member of the object /a object, e.g. the attributes of a primitive.
+void addMemberRefs( const char *typeName, const Json::Value &object, bool version2, std::vector<EntryRef> *refs )
+{
+	if( ! object.isObject() )
+		return;
+	for( auto &ref : object )
+		addRef( typeName, ref, version2, refs );
+}
+
+//! Appends the entries /a val of /a typeName references. Animations reference the nodes they
+//! drive rather than being referenced, they're selected separately.
+void collectRefs( const std::string &typeName, const Json::Value &val, bool version2, std::vector<EntryRef> *refs )
+{
+	if( ! val.isObject() )
+		return;
+	auto &extensions = val["extensions"];
+	if( typeName == "scenes" )
+		addRefs( "nodes", val["nodes"], version2, refs );
+	else if( typeName == "nodes" ) {
+		addRefs( "nodes", val["children"], version2, refs );
+		addRefs( "nodes", val["skeletons"], version2, refs );
+		addRefs( "meshes", val["meshes"], version2, refs );
+		addRef( "meshes", val["mesh"], version2, refs );
+		addRef( "cameras", val["camera"], version2, refs );
+		addRef( "skins", val["skin"], version2, refs );
+		if( extensions.isObject() ) {
+			addRef( "lights", extensions["KHR_materials_common"]["light"], version2, refs );
+			addRef( "lights", extensions["KHR_lights_punctual"]["light"], version2, refs );
+		}
+	}
+	else if( typeName == "meshes" ) {
+		for( auto &primitive : val["primitives"] ) {
+			addMemberRefs( "accessors", primitive["attributes"], version2, refs );
+			addRef( "accessors", primitive["indices"], version2, refs );
+			addRef( "materials", primitive["material"], version2, refs );
+			for( auto &target : primitive["targets"] )
+				addMemberRefs( "accessors", target, version2, refs );
+		}
+	}
+	else if( typeName == "skins" ) {
+		addRef( "accessors", val["inverseBindMatrices"], version2, refs );
+		addRefs( "nodes", val["joints"], version2, refs );
+		addRef( "nodes", val["skeleton"], version2, refs );
+	}
+	else if( typeName == "materials" ) {
+		addRef( "techniques", val["technique"], version2, refs );
+		// glTF 1.0 textures are values keyed like any other, keys that aren't textures are ignored.
+		addMemberRefs( "textures", val["values"], version2, refs );
+		if( extensions.isObject() )
+			addMemberRefs( "textures", extensions["KHR_materials_common"]["values"], version2, refs );
+		auto &pbr = val["pbrMetallicRoughness"];
+		if( pbr.isObject() ) {
+			addRef( "textures", pbr["baseColorTexture"]["index"], version2, refs );
+			addRef( "textures", pbr["metallicRoughnessTexture"]["index"], version2, refs );
+		}
+		addRef( "textures", val["normalTexture"]["index"], version2, refs );
+		addRef( "textures", val["occlusionTexture"]["index"], version2, refs );
+		addRef( "textures", val["emissiveTexture"]["index"], version2, refs );
+	}
+	else if( typeName == "techniques" ) {
+		addRef( "programs", val["program"], version2, refs );
+		for( auto &parameter : val["parameters"] ) {
+			addRef( "nodes", parameter["node"], version2, refs );
+			addRef( "textures", parameter["value"], version2, refs );
+		}
+	}
+	else if( typeName == "programs" ) {
+		addRef( "shaders", val["vertexShader"], version2, refs );
+		addRef( "shaders", val["fragmentShader"], version2, refs );
+	}
+	else if( typeName == "textures" ) {
+		addRef( "images", val["source"], version2, refs );
+		addRef( "samplers", val["sampler"], version2, refs );
+	}
+	else if( typeName == "images" || typeName == "shaders" ) {
+		addRef( "bufferViews", val["bufferView"], version2, refs );
+		if( extensions.isObject() )
+			addRef( "bufferViews", extensions["KHR_binary_glTF"]["bufferView"], version2, refs );
+	}
+	else if( typeName == "accessors" ) {
+		addRef( "bufferViews", val["bufferView"], version2, refs );
+		auto &sparse = val["sparse"];
+		if( sparse.isObject() ) {
+			addRef( "bufferViews", sparse["indices"]["bufferView"], version2, refs );
+			addRef( "bufferViews", sparse["values"]["bufferView"], version2, refs );
+		}
+	}
+	else if( typeName == "bufferViews" )
+		addRef( "buffers", val["buffer"], version2, refs );
+}
+
+//! Returns the keys of the nodes driven by the animation /a val.
+std::vector<std::string> getAnimationTargets( const Json::Value &val )
+{
+	std::vector<std::string> ret;
+	for( auto &channel : val["channels"] ) {
+		auto &target = channel["target"];
+		if( target["id"].isString() )
+			ret.push_back( target["id"].asString() );
+		else if( target["node"].isUInt() )
+			ret.push_back( std::to_string( target["node"].asUInt() ) );
+	}
+	return ret;
+}
+
+} // anonymous namespace
+
+void File::selectEntries( std::vector<EntryList> &collections )
+{
+	std::unordered_map<std::string, size_t> collectionIndices;
+	std::vector<std::unordered_map<std::string, size_t>> entryIndices( collections.size() );
+	std::vector<std::vector<bool>> selected( collections.size() );
+	for( size_t i = 0; i < collections.size(); i++ ) {
+		collectionIndices[collections[i].typeName] = i;
+		auto &entries = collections[i].entries;
+		entryIndices[i].reserve( entries.size() );
+		for( size_t j = 0; j < entries.size(); j++ )
+			entryIndices[i][entries[j].key] = j;
+		selected[i].resize( entries.size(), false );
+	}
+
+	// streamed entries are read here and again when added, only the selected ones are read twice.
+	auto readEntry = []( const Entry &entry, Json::Value *scratch ) -> const Json::Value& {
+		if( entry.value )
+			return *entry.value;
+		JsonStreamReader( entry.range ).readValue( scratch );
+		return *scratch;
+	};
+
+	std::vector<EntryRef> pending;
+	if( ! mSelectedScene.empty() ) {
+		pending.emplace_back( "scenes", mSelectedScene );
+		auto scenes = collectionIndices.find( "scenes" );
+		if( scenes != collectionIndices.end() && entryIndices[scenes->second].count( mSelectedScene ) )
+			mDefaultScene = mSelectedScene;
+		else
+			CI_LOG_W( "Selected scene " << mSelectedScene << " isn't part of the file" );
+	}
+	for( auto &key : mSelectedNodes )
+		pending.emplace_back( "nodes", key );
+	for( auto &key : mSelectedMeshes )
+		pending.emplace_back( "meshes", key );
+
+	Json::Value scratch;
+	auto selectPending = [&] {
+		while( ! pending.empty() ) {
+			auto ref = std::move( pending.back() );
+			pending.pop_back();
+			auto collection = collectionIndices.find( ref.first );
+			if( collection == collectionIndices.end() )
+				continue;
+			auto i = collection->second;
+			auto entry = entryIndices[i].find( ref.second );
+			if( entry == entryIndices[i].end() || selected[i][entry->second] )
+				continue;
+			selected[i][entry->second] = true;
+			collectRefs( ref.first, readEntry( collections[i].entries[entry->second], &scratch ), mVersion2, &pending );
+		}
+	};
+	selectPending();
+
+	// an animation comes along with any node it drives, nodes only lead to more accessors from here.
+	auto animations = collectionIndices.find( "animations" );
+	auto nodes = collectionIndices.find( "nodes" );
+	if( animations != collectionIndices.end() && nodes != collectionIndices.end() ) {
+		auto &animationEntries = collections[animations->second].entries;
+		for( size_t j = 0; j < animationEntries.size(); j++ ) {
+			auto &val = readEntry( animationEntries[j], &scratch );
+			bool drivesSelected = false;
+			for( auto &target : getAnimationTargets( val ) ) {
+				auto node = entryIndices[nodes->second].find( target );
+				drivesSelected = drivesSelected || ( node != entryIndices[nodes->second].end() && selected[nodes->second][node->second] );
+			}
+			if( ! drivesSelected )
+				continue;
+			selected[animations->second][j] = true;
+			// glTF 1.0 samplers read named parameters, glTF 2.0 samplers read accessors directly.
+			addMemberRefs( "accessors", val["parameters"], mVersion2, &pending );
+			for( auto &sampler : val["samplers"] ) {
+				if( sampler["input"].isNumeric() )
+					addRef( "accessors", sampler["input"], mVersion2, &pending );
+				if( sampler["output"].isNumeric() )
+					addRef( "accessors", sampler["output"], mVersion2, &pending );
+			}
+		}
+		selectPending();
+	}
+
+	size_t numSelected = 0, numEntries = 0;
+	for( size_t i = 0; i < collections.size(); i++ ) {
+		auto &entries = collections[i].entries;
+		numEntries += entries.size();
+		if( mVersion2 ) {
+			// every index has to keep resolving to its handle.
+			for( size_t j = 0; j < entries.size(); j++ ) {
+				entries[j].selected = selected[i][j];
+				numSelected += selected[i][j] ? 1 : 0;
+			}
+			continue;
+		}
+		std::vector<Entry> kept;
+		kept.reserve( entries.size() );
+		for( size_t j = 0; j < entries.size(); j++ ) {
+			if( selected[i][j] )
+				kept.push_back( std::move( entries[j] ) );
+		}
+		numSelected += kept.size();
+		entries = std::move( kept );
+	}
+	if( numSelected == 0 )
+		CI_LOG_W( "Nothing selected, none of the selected keys are part of the file" );
+	else
+		CI_LOG_V( "Selected " << numSelected << " of " << numEntries << " entries" );
+}
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,948 @@
+//
+//  Snapshot.cpp
+//  gltf
+//
+//  Binary snapshots of a loaded File. Every collection is written in handle order, pointers as
+//  handles and Symbols as indices into a string table at the end of the snapshot. Buffer payloads
+//  and decoded images are stored aligned, so that a mapped snapshot can hand them out in place.
+//
+
+#include "File.h"
+
+#include <fstream>
+#include <future>
+#include <type_traits>
+#include <unordered_map>
+
+#include "cinder/DataSource.h"
+#include "cinder/Log.h"
+#include "cinder/Surface.h"
+
+#include "MappedFile.h"
+
+namespace cinder {
+namespace gltf {
+
+namespace {
+
+const char		SNAPSHOT_MAGIC[4] = { 'C', 'G', 'S', 'N' };
+//! Bump whenever a transferred type or the layout changes, older snapshots are rejected.
+const uint32_t	SNAPSHOT_VERSION = 4;
+const uint32_t	SNAPSHOT_BYTE_ORDER = 0x01020304;
+//! Alignment of buffer payloads and image pixels within the snapshot.
+const size_t	SNAPSHOT_ALIGNMENT = 16;
+
+struct SnapshotHeader {
+	char		magic[4];
+	uint32_t	version;
+	uint32_t	byteOrder;
+	uint32_t	reserved;
+	uint64_t	stringsOffset;
+};
+
+//! Writes a File to a snapshot. Fields are written in the order transfer() visits them.
+class SnapshotWriter {
+public:
+	static const bool READING = false;
+
+	SnapshotWriter( const File &file, std::ofstream &stream ) : mFile( file ), mStream( stream ) {}
+
+	//! Writes the bytes of trivially copyable /a value.
+	template<typename T>
+	void value( T &value );
+	//! Bools are written as a byte of 0 or 1.
+	void value( bool &value ) { uint8_t byte = value ? 1 : 0; write( &byte, 1 ); }
+	void value( Symbol &symbol ) { write32( getStringIndex( symbol ) ); }
+	void value( std::string &str );
+	void value( Json::Value &json );
+	template<typename T>
+	void value( std::vector<T> &values );
+	template<typename T, typename U>
+	void value( std::pair<T, U> &pair ) { value( pair.first ); value( pair.second ); }
+	template<typename T, size_t N>
+	void value( std::array<T, N> &values ) { for( auto &val : values ) value( val ); }
+
+	//! Writes the handle of /a object in its Collection.
+	template<typename T>
+	void ref( T *&object );
+	template<typename T>
+	void refs( std::vector<T*> &objects );
+	//! Writes the number of objects in /a collection followed by their keys.
+	template<typename T>
+	void keys( Collection<T> &collection );
+	//! Writes /a data aligned, null data is written as an empty payload.
+	void payload( ci::BufferRef &data );
+	//! Writes the pixels of /a image, blocking until it's decoded.
+	void image( std::shared_future<ci::ImageSourceRef> &image );
+
+	//! Writes the string table and returns its offset.
+	uint64_t writeStrings();
+
+private:
+	void		write( const void *data, size_t size ) { mStream.write( reinterpret_cast<const char*>( data ), size ); }
+	void		write32( uint32_t value ) { write( &value, sizeof( value ) ); }
+	void		align();
+	uint32_t	getStringIndex( const Symbol &symbol );
+
+	const File								&mFile;
+	std::ofstream							&mStream;
+	// index 0 is the empty Symbol.
+	std::unordered_map<uint32_t, uint32_t>	mStringIndices;
+	std::vector<const std::string*>			mStrings{ nullptr };
+};
+
+//! Reads a File from a snapshot, mirroring SnapshotWriter.
+class SnapshotReader {
+public:
+	static const bool READING = true;
+
+	SnapshotReader( File &file, SymbolTable &symbols, const ci::BufferRef &blob );
+
+	//! Reads trivially copyable /a value, enums are checked against their enumerators.
+	template<typename T>
+	void value( T &value );
+	//! Throws unless the byte read is 0 or 1.
+	void value( bool &value );
+	void value( Symbol &symbol );
+	void value( std::string &str );
+	void value( Json::Value &json );
+	template<typename T>
+	void value( std::vector<T> &values );
+	template<typename T, typename U>
+	void value( std::pair<T, U> &pair ) { value( pair.first ); value( pair.second ); }
+	template<typename T, size_t N>
+	void value( std::array<T, N> &values ) { for( auto &val : values ) value( val ); }
+
+	template<typename T>
+	void ref( T *&object );
+	template<typename T>
+	void refs( std::vector<T*> &objects );
+	//! Allocates a slot for every key, in order, so that the handles match the written File.
+	template<typename T>
+	void keys( Collection<T> &collection );
+	//! Reads a payload, referencing the snapshot rather than copying it.
+	void payload( ci::BufferRef &data );
+	void image( std::shared_future<ci::ImageSourceRef> &image );
+
+private:
+	template<typename T>
+	void		readValue( T &value, std::false_type /*isEnum*/ ) { read( &value, sizeof( T ) ); }
+	template<typename T>
+	void		readValue( T &value, std::true_type /*isEnum*/ );
+	void		read( void *data, size_t size );
+	uint32_t	read32() { uint32_t ret; read( &ret, sizeof( ret ) ); return ret; }
+	const uint8_t*	skip( size_t size );
+	void		align();
+	template<typename T>
+	Collection<T>&	getCollection() { return const_cast<Collection<T>&>( mFile.getCollectionOf<T>() ); }
+
+	File				&mFile;
+	ci::BufferRef		mBlob;
+	const uint8_t		*mBegin, *mCurrent, *mEnd;
+	std::vector<Symbol>	mSymbols;
+};
+
+//! Whether /a value is one of the enumerators of /a T, specialized for every enum a snapshot holds.
+template<typename T>
+bool isEnumValue( typename std::underlying_type<T>::type value );
+
+template<>
+bool isEnumValue<Accessor::Type>( int value )
+{
+	return value >= 0 && value <= static_cast<int>( Accessor::Type::MAT4 );
+}
+
+template<>
+bool isEnumValue<Accessor::ComponentType>( int value )
+{
+	switch( static_cast<Accessor::ComponentType>( value ) ) {
+		case Accessor::ComponentType::BYTE:
+		case Accessor::ComponentType::UNSIGNED_BYTE:
+		case Accessor::ComponentType::SHORT:
+		case Accessor::ComponentType::UNSIGNED_SHORT:
+		case Accessor::ComponentType::UNSIGNED_INT:
+		case Accessor::ComponentType::FLOAT:
+			return true;
+		default:
+			return false;
+	}
+}
+
+template<>
+bool isEnumValue<Animation::Sampler::LerpType>( int value )
+{
+	return value == static_cast<int>( Animation::Sampler::LerpType::LINEAR );
+}
+
+template<>
+bool isEnumValue<BufferView::Target>( int value )
+{
+	// 0 when the file doesn't give one.
+	return value == 0
+		|| value == static_cast<int>( BufferView::Target::ARRAY_BUFFER )
+		|| value == static_cast<int>( BufferView::Target::ELEMENT_ARRAY_BUFFER );
+}
+
+template<>
+bool isEnumValue<Camera::Type>( int value )
+{
+	return value >= 0 && value <= static_cast<int>( Camera::Type::ORTHOGRAPHIC );
+}
+
+template<>
+bool isEnumValue<Light::Type>( int value )
+{
+	return value >= 0 && value <= static_cast<int>( Light::Type::SPOT );
+}
+
+template<>
+bool isEnumValue<Material::Source::Type>( int value )
+{
+	return value >= 0 && value <= static_cast<int>( Material::Source::Type::EMISSION );
+}
+
+template<>
+bool isEnumValue<Shader::Type>( int value )
+{
+	return value == static_cast<int>( Shader::Type::VERTEX ) || value == static_cast<int>( Shader::Type::FRAGMENT );
+}
+
+template<>
+bool isEnumValue<ci::geom::Attrib>( std::underlying_type<ci::geom::Attrib>::type value )
+{
+	// Mesh::getAttribEnum() gives NUM_ATTRIBS to attributes it doesn't know.
+	return static_cast<uint64_t>( value ) <= ci::geom::Attrib::NUM_ATTRIBS;
+}
+
+template<typename T>
+void SnapshotWriter::value( T &value )
+{
+	static_assert( std::is_trivially_copyable<T>::value, "only trivially copyable types are written as bytes" );
+	write( &value, sizeof( T ) );
+}
+
+void SnapshotWriter::value( std::string &str )
+{
+	write32( static_cast<uint32_t>( str.size() ) );
+	write( str.data(), str.size() );
+}
+
+void SnapshotWriter::value( Json::Value &json )
+{
+	auto str = json.isNull() ? std::string() : Json::FastWriter().write( json );
+	value( str );
+}
+
+template<typename T>
+void SnapshotWriter::ref( T *&object )
+{
+	auto &collection = mFile.getCollectionOf<T>();
+	write32( object ? static_cast<uint32_t>( object - collection.data() ) : Collection<T>::INVALID_HANDLE );
+}
+
+template<typename T>
+void SnapshotWriter::refs( std::vector<T*> &objects )
+{
+	write32( static_cast<uint32_t>( objects.size() ) );
+	for( auto &object : objects )
+		ref( object );
+}
+
+template<typename T>
+void SnapshotWriter::keys( Collection<T> &collection )
+{
+	write32( static_cast<uint32_t>( collection.size() ) );
+	for( auto &object : collection )
+		value( object.key );
+}
+
+void SnapshotWriter::payload( ci::BufferRef &data )
+{
+	uint64_t size = data ? data->getSize() : 0;
+	value( size );
+	align();
+	if( size )
+		write( data->getData(), size );
+}
+
+void SnapshotWriter::image( std::shared_future<ci::ImageSourceRef> &image )
+{
+	ci::ImageSourceRef source;
+	if( image.valid() )
+		source = ThreadPool::get().wait( image );
+	uint32_t width = 0, height = 0;
+	if( ! source ) {
+		value( width );
+		value( height );
+		return;
+	}
+
+	ci::Surface8u surface( source );
+	width = surface.getWidth();
+	height = surface.getHeight();
+	value( width );
+	value( height );
+	bool alpha = surface.hasAlpha();
+	int32_t channelOrder = surface.getChannelOrder().getCode();
+	value( alpha );
+	value( channelOrder );
+	// rows are written tightly packed, the Surface may pad them.
+	auto rowBytes = static_cast<size_t>( width ) * ( alpha ? 4 : 3 );
+	align();
+	for( uint32_t y = 0; y < height; y++ )
+		write( surface.getData() + y * surface.getRowBytes(), rowBytes );
+}
+
+uint64_t SnapshotWriter::writeStrings()
+{
+	align();
+	uint64_t offset = mStream.tellp();
+	write32( static_cast<uint32_t>( mStrings.size() ) );
+	for( size_t i = 1; i < mStrings.size(); i++ ) {
+		write32( static_cast<uint32_t>( mStrings[i]->size() ) );
+		write( mStrings[i]->data(), mStrings[i]->size() );
+	}
+	return offset;
+}
+
+void SnapshotWriter::align()
+{
+	static const char padding[SNAPSHOT_ALIGNMENT] = {};
+	auto offset = static_cast<size_t>( mStream.tellp() );
+	if( offset % SNAPSHOT_ALIGNMENT )
+		write( padding, SNAPSHOT_ALIGNMENT - offset % SNAPSHOT_ALIGNMENT );
+}
+
+uint32_t SnapshotWriter::getStringIndex( const Symbol &symbol )
+{
+	if( symbol.empty() )
+		return 0;
+	auto emplaced = mStringIndices.emplace( symbol.getId(), static_cast<uint32_t>( mStrings.size() ) );
+	if( emplaced.second )
+		mStrings.push_back( &symbol.str() );
+	return emplaced.first->second;
+}
+
+SnapshotReader::SnapshotReader( File &file, SymbolTable &symbols, const ci::BufferRef &blob )
+: mFile( file ), mBlob( blob )
+{
+	mBegin = reinterpret_cast<const uint8_t*>( blob->getData() );
+	mEnd = mBegin + blob->getSize();
+	mCurrent = mBegin;
+
+	SnapshotHeader header;
+	read( &header, sizeof( header ) );
+	if( ! std::equal( header.magic, header.magic + 4, SNAPSHOT_MAGIC ) )
+		throw std::runtime_error( "not a gltf snapshot" );
+	if( header.version != SNAPSHOT_VERSION || header.byteOrder != SNAPSHOT_BYTE_ORDER )
+		throw std::runtime_error( "snapshot of another version or byte order" );
+	if( header.stringsOffset > blob->getSize() )
+		throw std::runtime_error( "truncated snapshot" );
+
+	// Every string is interned up front, Symbols are then a lookup by index.
+	auto body = mCurrent;
+	mCurrent = mBegin + header.stringsOffset;
+	auto numStrings = read32();
+	mSymbols.reserve( numStrings );
+	mSymbols.emplace_back();
+	std::string str;
+	for( uint32_t i = 1; i < numStrings; i++ ) {
+		value( str );
+		mSymbols.push_back( symbols.intern( str ) );
+	}
+	mEnd = mBegin + header.stringsOffset;
+	mCurrent = body;
+}
+
+template<typename T>
+void SnapshotReader::value( T &value )
+{
+	static_assert( std::is_trivially_copyable<T>::value, "only trivially copyable types are read as bytes" );
+	readValue( value, std::is_enum<T>() );
+}
+
+template<typename T>
+void SnapshotReader::readValue( T &value, std::true_type /*isEnum*/ )
+{
+	typename std::underlying_type<T>::type raw;
+	read( &raw, sizeof( raw ) );
+	if( ! isEnumValue<T>( raw ) )
+		throw std::runtime_error( "invalid enum value" );
+	value = static_cast<T>( raw );
+}
+
+void SnapshotReader::value( bool &value )
+{
+	uint8_t byte;
+	read( &byte, 1 );
+	if( byte > 1 )
+		throw std::runtime_error( "invalid bool" );
+	value = byte == 1;
+}
+
+void SnapshotReader::value( Symbol &symbol )
+{
+	auto index = read32();
+	if( index >= mSymbols.size() )
+		throw std::runtime_error( "invalid string index" );
+	symbol = mSymbols[index];
+}
+
+void SnapshotReader::value( std::string &str )
+{
+	auto size = read32();
+	auto data = skip( size );
+	str.assign( reinterpret_cast<const char*>( data ), size );
+}
+
+void SnapshotReader::value( Json::Value &json )
+{
+	std::string str;
+	value( str );
+	json = Json::Value();
+	if( ! str.empty() )
+		Json::Reader().parse( str, json );
+}
+
+template<typename T>
+void SnapshotReader::ref( T *&object )
+{
+	auto &collection = getCollection<T>();
+	auto handle = read32();
+	if( handle == Collection<T>::INVALID_HANDLE )
+		object = nullptr;
+	else if( handle < collection.size() )
+		object = &collection[handle];
+	else
+		throw std::runtime_error( "invalid handle" );
+}
+
+template<typename T>
+void SnapshotReader::refs( std::vector<T*> &objects )
+{
+	auto size = read32();
+	if( size > static_cast<size_t>( mEnd - mCurrent ) / sizeof( uint32_t ) )
+		throw std::runtime_error( "truncated snapshot" );
+	objects.resize( size );
+	for( auto &object : objects )
+		ref( object );
+}
+
+template<typename T>
+void SnapshotReader::keys( Collection<T> &collection )
+{
+	auto size = read32();
+	if( size > static_cast<size_t>( mEnd - mCurrent ) / sizeof( uint32_t ) )
+		throw std::runtime_error( "truncated snapshot" );
+	collection.reserve( size );
+	Symbol key;
+	for( uint32_t i = 0; i < size; i++ ) {
+		value( key );
+		collection[collection.allocate( key )].key = key;
+	}
+}
+
+void SnapshotReader::payload( ci::BufferRef &data )
+{
+	uint64_t size;
+	value( size );
+	align();
+	if( size > static_cast<uint64_t>( mEnd - mCurrent ) )
+		throw std::runtime_error( "truncated snapshot" );
+	if( ! size ) {
+		data.reset();
+		return;
+	}
+	// Reference the bytes in place, the deleter keeps the snapshot alive.
+	auto blob = mBlob;
+	auto start = const_cast<uint8_t*>( skip( static_cast<size_t>( size ) ) );
+	data = ci::BufferRef( new ci::Buffer( start, static_cast<size_t>( size ) ), [blob]( ci::Buffer *buffer ) {
+		delete buffer;
+	} );
+}
+
+void SnapshotReader::image( std::shared_future<ci::ImageSourceRef> &image )
+{
+	uint32_t width, height;
+	value( width );
+	value( height );
+	std::promise<ci::ImageSourceRef> decoded;
+	image = decoded.get_future().share();
+	if( ! width || ! height ) {
+		decoded.set_value( ci::ImageSourceRef() );
+		return;
+	}
+
+	bool alpha;
+	int32_t channelOrder;
+	value( alpha );
+	value( channelOrder );
+	auto rowBytes = static_cast<size_t>( width ) * ( alpha ? 4 : 3 );
+	align();
+	if( rowBytes * height > static_cast<size_t>( mEnd - mCurrent ) )
+		throw std::runtime_error( "truncated snapshot" );
+	ci::Surface8u surface( width, height, alpha, ci::SurfaceChannelOrder( channelOrder ) );
+	for( uint32_t y = 0; y < height; y++ )
+		memcpy( surface.getData() + y * surface.getRowBytes(), skip( rowBytes ), rowBytes );
+	decoded.set_value( surface );
+}
+
+void SnapshotReader::read( void *data, size_t size )
+{
+	memcpy( data, skip( size ), size );
+}
+
+const uint8_t* SnapshotReader::skip( size_t size )
+{
+	if( size > static_cast<size_t>( mEnd - mCurrent ) )
+		throw std::runtime_error( "truncated snapshot" );
+	auto ret = mCurrent;
+	mCurrent += size;
+	return ret;
+}
+
+void SnapshotReader::align()
+{
+	auto offset = static_cast<size_t>( mCurrent - mBegin );
+	if( offset % SNAPSHOT_ALIGNMENT )
+		skip( SNAPSHOT_ALIGNMENT - offset % SNAPSHOT_ALIGNMENT );
+}
+
+// The fields of every public type, visited in the same order by both archives.
+
+template<typename Archive>
+void transfer( Archive &archive, Accessor &accessor )
+{
+	archive.ref( accessor.bufferView );
+	archive.value( accessor.dataType );
+	archive.value( accessor.componentType );
+	archive.value( accessor.byteOffset );
+	archive.value( accessor.byteStride );
+	archive.value( accessor.count );
+	archive.value( accessor.normalized );
+	archive.value( accessor.sparse.count );
+	archive.ref( accessor.sparse.indicesBufferView );
+	archive.ref( accessor.sparse.valuesBufferView );
+	archive.value( accessor.sparse.indicesByteOffset );
+	archive.value( accessor.sparse.valuesByteOffset );
+	archive.value( accessor.sparse.indicesComponentType );
+	archive.value( accessor.min );
+	archive.value( accessor.max );
+	archive.value( accessor.name );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Animation &animation )
+{
+	archive.value( animation.target );
+	archive.value( animation.channels );
+	archive.value( animation.samplers );
+	archive.ref( animation.timeAccessor );
+	archive.value( animation.parameters );
+	archive.value( animation.name );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, BufferView &bufferView )
+{
+	archive.ref( bufferView.buffer );
+	archive.value( bufferView.byteLength );
+	archive.value( bufferView.byteOffset );
+	archive.value( bufferView.byteStride );
+	archive.value( bufferView.target );
+	archive.value( bufferView.name );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Camera &camera )
+{
+	archive.value( camera.name );
+	archive.value( camera.type );
+	archive.value( camera.zfar );
+	archive.value( camera.znear );
+	archive.value( camera.yfov );
+	archive.value( camera.aspectRatio );
+	archive.value( camera.xmag );
+	archive.value( camera.ymag );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Light &light )
+{
+	archive.value( light.color );
+	archive.value( light.distance );
+	archive.value( light.constantAttenuation );
+	archive.value( light.linearAttenuation );
+	archive.value( light.quadraticAttenuation );
+	archive.value( light.falloffAngle );
+	archive.value( light.falloffExponent );
+	archive.value( light.intensity );
+	archive.value( light.type );
+	archive.value( light.name );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Material &material )
+{
+	archive.value( material.name );
+	archive.ref( material.technique );
+	archive.value( material.jointCount );
+	archive.value( material.ambient );
+	archive.value( material.sources );
+	archive.value( material.shininess );
+	archive.value( material.transparency );
+	archive.value( material.doubleSided );
+	archive.value( material.transparent );
+	archive.value( material.values );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Mesh &mesh )
+{
+	archive.value( mesh.name );
+	archive.value( mesh.primitives );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Node &node )
+{
+	// parent and Camera::node are linked again after loading, see File::linkNodes().
+	archive.ref( node.camera );
+	archive.ref( node.skin );
+	archive.ref( node.light );
+	archive.refs( node.children );
+	archive.refs( node.skeletons );
+	archive.refs( node.meshes );
+	archive.value( node.jointName );
+	archive.value( node.transformMatrix );
+	archive.value( node.rotation );
+	archive.value( node.translation );
+	archive.value( node.scale );
+	archive.value( node.name );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Program &program )
+{
+	archive.ref( program.frag );
+	archive.ref( program.vert );
+	archive.value( program.name );
+	archive.value( program.attributes );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Sampler &sampler )
+{
+	archive.value( sampler.name );
+	archive.value( sampler.magFilter );
+	archive.value( sampler.minFilter );
+	archive.value( sampler.wrapS );
+	archive.value( sampler.wrapT );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Scene &scene )
+{
+	archive.refs( scene.nodes );
+	archive.value( scene.name );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Skin &skin )
+{
+	archive.value( skin.bindShapeMatrix );
+	archive.ref( skin.inverseBindMatrices );
+	archive.refs( skin.joints );
+	archive.ref( skin.skeleton );
+	archive.value( skin.name );
+}
+
+//! Field by field, the bools in it are checked when reading.
+template<typename Archive>
+void transfer( Archive &archive, Technique::State::Functions &functions )
+{
+	archive.value( functions.blendColor );
+	archive.value( functions.blendEquationSeparate );
+	archive.value( functions.blendFuncSeparate );
+	archive.value( functions.colorMask );
+	archive.value( functions.depthRange );
+	archive.value( functions.polygonOffset );
+	archive.value( functions.scissor );
+	archive.value( functions.lineWidth );
+	archive.value( functions.cullFace );
+	archive.value( functions.depthFunc );
+	archive.value( functions.frontFace );
+	archive.value( functions.depthMask );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Technique &technique )
+{
+	archive.ref( technique.program );
+	archive.value( technique.name );
+	archive.value( technique.parameters );
+	archive.value( technique.states.enables );
+	transfer( archive, technique.states.functions );
+	archive.value( technique.attributes );
+	archive.value( technique.uniforms );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Texture &texture )
+{
+	archive.ref( texture.sampler );
+	archive.ref( texture.image );
+	archive.value( texture.format );
+	archive.value( texture.internalFormat );
+	archive.value( texture.target );
+	archive.value( texture.type );
+	archive.value( texture.name );
+}
+
+// Elements of the vectors above that hold Symbols or references.
+
+template<typename Archive>
+void transfer( Archive &archive, Animation::Channel &channel )
+{
+	archive.value( channel.sampler );
+	archive.value( channel.path );
+	archive.ref( channel.target );
+	archive.value( channel.targetId );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Animation::Sampler &sampler )
+{
+	archive.value( sampler.input );
+	archive.value( sampler.output );
+	archive.value( sampler.type );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Animation::Parameter &parameter )
+{
+	archive.value( parameter.parameter );
+	archive.ref( parameter.accessor );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Material::Source &source )
+{
+	archive.value( source.type );
+	archive.ref( source.texture );
+	archive.value( source.color );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Mesh::Primitive &primitive )
+{
+	archive.value( primitive.attributes );
+	archive.ref( primitive.indices );
+	archive.ref( primitive.material );
+	archive.value( primitive.primitive );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Mesh::Primitive::AttribAccessor &attrib )
+{
+	archive.value( attrib.attrib );
+	archive.ref( attrib.accessor );
+}
+
+template<typename Archive>
+void transfer( Archive &archive, Technique::Parameter &parameter )
+{
+	archive.value( parameter.name );
+	archive.ref( parameter.node );
+	archive.value( parameter.semantic );
+	archive.value( parameter.count );
+	archive.value( parameter.type );
+}
+
+// Elements without a transfer() of their own are trivially copyable, Symbols or strings.
+template<typename Archive, typename T>
+void transfer( Archive &archive, T &value )
+{
+	archive.value( value );
+}
+
+template<typename T>
+void SnapshotWriter::value( std::vector<T> &values )
+{
+	write32( static_cast<uint32_t>( values.size() ) );
+	for( auto &val : values )
+		transfer( *this, val );
+}
+
+template<typename T>
+void SnapshotReader::value( std::vector<T> &values )
+{
+	auto size = read32();
+	// every element takes at least a byte, a larger size can only be corruption.
+	if( size > static_cast<size_t>( mEnd - mCurrent ) )
+		throw std::runtime_error( "truncated snapshot" );
+	values.resize( size );
+	for( auto &val : values )
+		transfer( *this, val );
+}
+
+} // anonymous namespace
+
+template<typename Archive>
+void File::transferSnapshot( Archive &archive )
+{
+	archive.value( mAssetInfo.copyright );
+	archive.value( mAssetInfo.generator );
+	archive.value( mAssetInfo.version );
+	archive.value( mAssetInfo.profile.api );
+	archive.value( mAssetInfo.profile.version );
+	archive.value( mAssetInfo.premultipliedAlpha );
+	archive.value( mVersion2 );
+	archive.value( mExtensions );
+	archive.value( mDefaultScene );
+	auto gltfPath = mGltfPath.string();
+	archive.value( gltfPath );
+	mGltfPath = gltfPath;
+
+	// every slot exists before any reference is read, like ingest().
+	archive.keys( mAccessors );
+	archive.keys( mAnimations );
+	archive.keys( mBufferViews );
+	archive.keys( mBuffers );
+	archive.keys( mCameras );
+	archive.keys( mImages );
+	archive.keys( mLights );
+	archive.keys( mMaterials );
+	archive.keys( mMeshes );
+	archive.keys( mNodes );
+	archive.keys( mPrograms );
+	archive.keys( mSamplers );
+	archive.keys( mScenes );
+	archive.keys( mShaders );
+	archive.keys( mSkins );
+	archive.keys( mTechniques );
+	archive.keys( mTextures );
+
+	for( auto &accessor : mAccessors )
+		transfer( archive, accessor );
+	for( auto &animation : mAnimations )
+		transfer( archive, animation );
+	for( auto &bufferView : mBufferViews )
+		transfer( archive, bufferView );
+	// Buffers, Images and Shaders keep their data private to File.
+	for( auto &buffer : mBuffers ) {
+		archive.value( buffer.byteLength );
+		archive.value( buffer.uri );
+		archive.value( buffer.type );
+		archive.value( buffer.name );
+		// external buffers are carried by the snapshot too.
+		buffer.prefetch();
+		archive.payload( buffer.data );
+	}
+	for( auto &camera : mCameras )
+		transfer( archive, camera );
+	for( auto &image : mImages ) {
+		archive.value( image.name );
+		archive.value( image.uri );
+		archive.image( image.imageSource );
+	}
+	for( auto &light : mLights )
+		transfer( archive, light );
+	for( auto &material : mMaterials )
+		transfer( archive, material );
+	for( auto &mesh : mMeshes )
+		transfer( archive, mesh );
+	for( auto &node : mNodes )
+		transfer( archive, node );
+	for( auto &program : mPrograms )
+		transfer( archive, program );
+	for( auto &sampler : mSamplers )
+		transfer( archive, sampler );
+	for( auto &scene : mScenes )
+		transfer( archive, scene );
+	for( auto &shader : mShaders ) {
+		archive.value( shader.name );
+		archive.value( shader.uri );
+		archive.value( shader.type );
+		archive.value( shader.source );
+	}
+	for( auto &skin : mSkins )
+		transfer( archive, skin );
+	for( auto &technique : mTechniques )
+		transfer( archive, technique );
+	for( auto &texture : mTextures )
+		transfer( archive, texture );
+	
+	std::vector<std::pair<std::string, RawJson>> rawJsonEntries( mRawJsonEntries.begin(), mRawJsonEntries.end() );
+	archive.value( mRawJson );
+	archive.value( rawJsonEntries );
+	if( Archive::READING )
+		mRawJsonEntries.insert( rawJsonEntries.begin(), rawJsonEntries.end() );
+}
+
+bool File::saveSnapshot( const ci::fs::path &path ) const
+{
+	std::ofstream stream( path.string(), std::ios::binary | std::ios::trunc );
+	if( ! stream ) {
+		CI_LOG_E( "Couldn't open snapshot " << path << " for writing" );
+		return false;
+	}
+
+	SnapshotHeader header = {};
+	std::copy( SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + 4, header.magic );
+	header.version = SNAPSHOT_VERSION;
+	header.byteOrder = SNAPSHOT_BYTE_ORDER;
+	stream.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+
+	// writing doesn't modify anything, transferSnapshot() is shared with loadSnapshot().
+	SnapshotWriter writer( *this, stream );
+	const_cast<File*>( this )->transferSnapshot( writer );
+	header.stringsOffset = writer.writeStrings();
+	stream.seekp( 0 );
+	stream.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+
+	if( ! stream ) {
+		CI_LOG_E( "Error writing snapshot " << path );
+		return false;
+	}
+	return true;
+}
+
+FileRef File::loadSnapshot( const ci::fs::path &path )
+{
+	auto readStart = LoadCounters::Clock::now();
+	ci::BufferRef blob;
+	auto mapping = MappedFile::create( path );
+	if( mapping )
+		blob = mapping->createBuffer( 0, mapping->getSize() );
+	else {
+		try {
+			blob = loadFile( path )->getBuffer();
+		}
+		catch( const std::exception &e ) {
+			CI_LOG_E( "Couldn't load snapshot " << path << ": " << e.what() );
+			return FileRef();
+		}
+	}
+
+	FileRef ret( new File );
+	ret->mLoadCounters->readNanos += LoadCounters::nanosSince( readStart );
+	ret->mLoadCounters->fileBytes = blob->getSize();
+	try {
+		LoadCounters::ScopedTimer timer( ret->mLoadCounters->ingestNanos );
+		SnapshotReader reader( *ret, ret->mSymbols, blob );
+		ret->transferSnapshot( reader );
+	}
+	catch( const std::exception &e ) {
+		CI_LOG_E( "Couldn't load snapshot " << path << ": " << e.what() );
+		return FileRef();
+	}
+	{
+		LoadCounters::ScopedTimer timer( ret->mLoadCounters->linkNanos );
+		ret->linkNodes();
+	}
+	return ret;
+}
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,72 @@
+//
+//  Symbol.cpp
+//  gltf
+//
+
+#include "Symbol.h"
+
+namespace cinder {
+namespace gltf {
+
+const std::string& Symbol::getEmptyString()
+{
+	static const std::string sEmpty;
+	return sEmpty;
+}
+
+Symbol SymbolTable::intern( const std::string &str )
+{
+	if( str.empty() )
+		return Symbol();
+
+	auto shardIndex = static_cast<uint32_t>( std::hash<std::string>()( str ) & ( NUM_SHARDS - 1 ) );
+	auto &shard = mShards[shardIndex];
+	std::lock_guard<std::mutex> lock( shard.mutex );
+	// ids encode their shard in the low bits and start at 1, 0 is the empty Symbol.
+	auto id = ( static_cast<uint32_t>( shard.ids.size() + 1 ) << NUM_SHARDS_BITS ) | shardIndex;
+	auto emplaced = shard.ids.emplace( str, id );
+	return Symbol( emplaced.first->second, &emplaced.first->first );
+}
+
+Symbol SymbolTable::find( const std::string &str ) const
+{
+	if( str.empty() )
+		return Symbol();
+
+	auto shardIndex = static_cast<uint32_t>( std::hash<std::string>()( str ) & ( NUM_SHARDS - 1 ) );
+	auto &shard = mShards[shardIndex];
+	std::lock_guard<std::mutex> lock( shard.mutex );
+	auto found = shard.ids.find( str );
+	if( found == shard.ids.end() )
+		return Symbol();
+	return Symbol( found->second, &found->first );
+}
+
+size_t SymbolTable::size() const
+{
+	size_t ret = 0;
+	for( auto &shard : mShards ) {
+		std::lock_guard<std::mutex> lock( shard.mutex );
+		ret += shard.ids.size();
+	}
+	return ret;
+}
+
+size_t SymbolTable::getNumBytes() const
+{
+	size_t ret = 0;
+	for( auto &shard : mShards ) {
+		std::lock_guard<std::mutex> lock( shard.mutex );
+		for( auto &entry : shard.ids )
+			ret += entry.first.capacity() + 1;
+	}
+	return ret;
+}
+
+std::ostream& operator<<( std::ostream &lhs, const Symbol &rhs )
+{
+	return lhs << rhs.str();
+}
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,100 @@
+//
+//  Symbol.h
+//  gltf
+//
+//  Interned strings. Every distinct string of a File is stored once in its SymbolTable and
+//  referenced everywhere else by a 32-bit id.
+//
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace cinder {
+namespace gltf {
+
+class Symbol {
+public:
+	//! Constructs the empty Symbol.
+	Symbol() : mId( 0 ), mString( &getEmptyString() ) {}
+
+	//! Returns the id, unique within the SymbolTable this Symbol came from. The empty Symbol is 0.
+	uint32_t			getId() const { return mId; }
+	//! Returns the interned string. Only valid while the owning File is alive.
+	const std::string&	str() const { return *mString; }
+	operator const std::string&() const { return *mString; }
+	const char*			c_str() const { return mString->c_str(); }
+	bool				empty() const { return mId == 0; }
+	size_t				size() const { return mString->size(); }
+
+	//! Symbols of the same File compare by id.
+	bool operator==( const Symbol &rhs ) const { return mId == rhs.mId; }
+	bool operator!=( const Symbol &rhs ) const { return mId != rhs.mId; }
+	//! Orders by string, so that Symbols sort like the strings they stand for.
+	bool operator<( const Symbol &rhs ) const { return mId != rhs.mId && *mString < *rhs.mString; }
+
+private:
+	Symbol( uint32_t id, const std::string *str ) : mId( id ), mString( str ) {}
+	static const std::string& getEmptyString();
+
+	uint32_t			mId;
+	const std::string	*mString;
+
+	friend class SymbolTable;
+};
+
+inline bool operator==( const Symbol &lhs, const std::string &rhs ) { return lhs.str() == rhs; }
+inline bool operator==( const std::string &lhs, const Symbol &rhs ) { return lhs == rhs.str(); }
+inline bool operator==( const Symbol &lhs, const char *rhs ) { return lhs.str() == rhs; }
+inline bool operator!=( const Symbol &lhs, const std::string &rhs ) { return lhs.str() != rhs; }
+inline bool operator!=( const std::string &lhs, const Symbol &rhs ) { return lhs != rhs.str(); }
+inline bool operator!=( const Symbol &lhs, const char *rhs ) { return lhs.str() != rhs; }
+
+//! Owns the strings of a File. Interning is thread safe, the table is sharded so that entries
+//! being added in parallel rarely contend.
+class SymbolTable {
+public:
+	SymbolTable() = default;
+	SymbolTable( const SymbolTable & ) = delete;
+	SymbolTable& operator=( const SymbolTable & ) = delete;
+
+	//! Returns the Symbol of /a str, adding it if it isn't interned yet.
+	Symbol	intern( const std::string &str );
+	//! Returns the Symbol of /a str, or the empty Symbol if it isn't interned.
+	Symbol	find( const std::string &str ) const;
+
+	//! Returns the number of distinct strings.
+	size_t	size() const;
+	//! Returns the number of bytes held by the interned strings.
+	size_t	getNumBytes() const;
+
+private:
+	static const uint32_t NUM_SHARDS_BITS = 4;
+	static const uint32_t NUM_SHARDS = 1 << NUM_SHARDS_BITS;
+
+	struct Shard {
+		mutable std::mutex							mutex;
+		// keys never move once inserted, Symbols point straight at them.
+		std::unordered_map<std::string, uint32_t>	ids;
+	};
+
+	std::array<Shard, NUM_SHARDS>	mShards;
+};
+
+std::ostream& operator<<( std::ostream &lhs, const Symbol &rhs );
+
+} // namespace gltf
+} // namespace cinder
+
+namespace std {
+
+template<>
+struct hash<cinder::gltf::Symbol> {
+	size_t operator()( const cinder::gltf::Symbol &symbol ) const { return hash<uint32_t>()( symbol.getId() ); }
+};
+
+} // namespace std
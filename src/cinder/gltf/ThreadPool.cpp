@@ -0,0 +1,90 @@
+//
+//  ThreadPool.cpp
+//  gltf
+//
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace cinder {
+namespace gltf {
+
+ThreadPool::ThreadPool( size_t numThreads )
+: mNumTasks( 0 ), mStop( false )
+{
+	if( numThreads == 0 )
+		numThreads = std::max( 1u, std::thread::hardware_concurrency() );
+	mThreads.reserve( numThreads );
+	for( size_t i = 0; i < numThreads; i++ )
+		mThreads.emplace_back( &ThreadPool::workerLoop, this );
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mStop = true;
+	}
+	mCondition.notify_all();
+	for( auto &thread : mThreads )
+		thread.join();
+}
+
+ThreadPool& ThreadPool::get()
+{
+	static ThreadPool sPool;
+	return sPool;
+}
+
+void ThreadPool::enqueue( std::function<void()> task, Priority priority )
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mTasks[static_cast<size_t>( priority )].emplace_back( std::move( task ) );
+		mNumTasks++;
+	}
+	mCondition.notify_one();
+}
+
+bool ThreadPool::popTask( std::function<void()> *task )
+{
+	for( auto queue = mTasks.rbegin(); queue != mTasks.rend(); ++queue ) {
+		if( ! queue->empty() ) {
+			*task = std::move( queue->front() );
+			queue->pop_front();
+			mNumTasks--;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ThreadPool::runPendingTask()
+{
+	std::function<void()> task;
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		if( ! popTask( &task ) )
+			return false;
+	}
+	task();
+	return true;
+}
+
+void ThreadPool::workerLoop()
+{
+	while( true ) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			mCondition.wait( lock, [this] { return mStop || mNumTasks > 0; } );
+			if( ! popTask( &task ) )
+				return;
+		}
+		task();
+	}
+}
+
+} // namespace gltf
+} // namespace cinder
@@ -0,0 +1,88 @@
+//
+//  ThreadPool.h
+//  gltf
+//
+//  Fixed size pool of worker threads used to parallelize loading.
+//
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinder {
+namespace gltf {
+
+class ThreadPool {
+public:
+	//! Queued tasks of a higher Priority always run before those of a lower one.
+	enum class Priority { LOW, NORMAL, HIGH };
+
+	//! Creates a pool with /a numThreads workers. 0 uses the number of hardware threads.
+	explicit ThreadPool( size_t numThreads = 0 );
+	~ThreadPool();
+
+	ThreadPool( const ThreadPool & ) = delete;
+	ThreadPool& operator=( const ThreadPool & ) = delete;
+
+	//! Returns the pool shared by every File.
+	static ThreadPool&	get();
+
+	//! Queues /a task with /a priority and returns a future for its result.
+	template<typename F>
+	std::future<typename std::result_of<F()>::type> submit( F &&task, Priority priority = Priority::NORMAL );
+	//! Blocks until /a future is ready, running queued tasks on the calling thread in the meantime
+	//! so that waiting from inside a worker can't deadlock the pool. Works with std::future and
+	//! std::shared_future.
+	template<typename Future>
+	auto	wait( Future &future ) -> decltype( future.get() );
+	//! Runs a single queued task on the calling thread. Returns false if the queue was empty.
+	bool	runPendingTask();
+
+	//! Returns the number of worker threads.
+	size_t	getNumThreads() const { return mThreads.size(); }
+
+private:
+	void	enqueue( std::function<void()> task, Priority priority );
+	//! Pops the highest priority queued task. The caller must hold mMutex.
+	bool	popTask( std::function<void()> *task );
+	void	workerLoop();
+
+	std::vector<std::thread>							mThreads;
+	std::array<std::deque<std::function<void()>>, 3>	mTasks; // indexed by Priority
+	size_t												mNumTasks;
+	std::mutex											mMutex;
+	std::condition_variable								mCondition;
+	bool												mStop;
+};
+
+template<typename F>
+std::future<typename std::result_of<F()>::type> ThreadPool::submit( F &&task, Priority priority )
+{
+	using Result = typename std::result_of<F()>::type;
+	// std::function requires copyable targets, so the packaged_task is shared.
+	auto packaged = std::make_shared<std::packaged_task<Result()>>( std::forward<F>( task ) );
+	auto ret = packaged->get_future();
+	enqueue( [packaged]() { (*packaged)(); }, priority );
+	return ret;
+}
+
+template<typename Future>
+auto ThreadPool::wait( Future &future ) -> decltype( future.get() )
+{
+	while( future.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready ) {
+		if( ! runPendingTask() )
+			future.wait();
+	}
+	return future.get();
+}
+
+} // namespace gltf
+} // namespace cinder
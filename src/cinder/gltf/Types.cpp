@@ -7,9 +7,21 @@
 //
 
 #include "cinder/gltf/Types.h"
+#include "cinder/gltf/AccessorView.h"
 #include "cinder/Log.h"
+#include "cinder/DataSource.h"
+#include "cinder/gltf/ThreadPool.h"
+#include "cinder/gltf/ResourceCache.h"
+#include "cinder/gltf/LoadStats.h"
 #include "cinder/Skeleton.h"
 
+#include <unordered_map>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+	#define CI_GLTF_SSE2
+	#include <emmintrin.h>
+#endif
+
 using namespace ci;
 using namespace std;
 
@@ -59,13 +71,17 @@ ci::geom::Attrib Mesh::getAttribEnum( const std::string &attrib )
 	else if( attrib == "TEXCOORD_1" )	return Attrib::TEX_COORD_1;
 	else if( attrib == "TEXCOORD_2" )	return Attrib::TEX_COORD_2;
 	else if( attrib == "TEXCOORD_3" )	return Attrib::TEX_COORD_3;
+	else if( attrib == "TANGENT" )		return Attrib::TANGENT;
 	else if( attrib == "COLOR" )		return Attrib::COLOR;
+	else if( attrib == "COLOR_0" )		return Attrib::COLOR;
 	else if( attrib == "JOINT" )		return Attrib::BONE_INDEX;
+	else if( attrib == "JOINTS_0" )		return Attrib::BONE_INDEX;
 	else if( attrib == "JOINTMATRIX" ) {
 		CI_LOG_W( "UNDEFINED Attib JOINTMATRIX Using CUSTOM_0" );
 		return Attrib::CUSTOM_0;
 	}
 	else if( attrib == "WEIGHT" )		return Attrib::BONE_WEIGHT;
+	else if( attrib == "WEIGHTS_0" )	return Attrib::BONE_WEIGHT;
 	else								return Attrib::NUM_ATTRIBS;
 }
 
@@ -98,7 +114,7 @@ uint8_t Accessor::getNumComponents() const
 		case Accessor::Type::VEC4: return 4; break;
 		case Accessor::Type::MAT2: return 4; break;
 		case Accessor::Type::MAT3: return 9; break;
-		case Accessor::Type::MAT4: return 12; break;
+		case Accessor::Type::MAT4: return 16; break;
 		default: CI_LOG_E( "Component not recognized." ); return 1; break;
 	}
 }
@@ -114,6 +130,7 @@ uint8_t Accessor::getNumBytesForComponentType() const
 		case Accessor::ComponentType::UNSIGNED_SHORT: // UNSIGNED_SHORT
 			return 2;
 			break;
+		case Accessor::ComponentType::UNSIGNED_INT: // UNSIGNED_INT
 		case Accessor::ComponentType::FLOAT: // FLOAT
 			return 4;
 			break;
@@ -125,10 +142,440 @@ uint8_t Accessor::getNumBytesForComponentType() const
 	}
 }
 
+namespace {
+
+//! Returns the number of columns of matrix types, 1 for vectors and scalars.
+uint8_t getNumColumns( Accessor::Type type )
+{
+	switch( type ) {
+		case Accessor::Type::MAT2: return 2;
+		case Accessor::Type::MAT3: return 3;
+		case Accessor::Type::MAT4: return 4;
+		default: return 1;
+	}
+}
+
+//! Returns the number of bytes per column, matrix columns start on 4 byte boundaries.
+uint32_t getColumnSize( const Accessor &accessor )
+{
+	auto numColumns = getNumColumns( accessor.dataType );
+	uint32_t ret = accessor.getNumComponents() / numColumns * accessor.getNumBytesForComponentType();
+	return numColumns > 1 ? ( ret + 3 ) & ~3u : ret;
+}
+
+//! Converts the leading multiple of 8 of /a count components C, see convertPacked(). Returns how
+//! many were converted, none unless there's a SIMD kernel for C.
+template<typename C>
+size_t convertPackedSimd( const uint8_t *src, size_t count, float scale, float *dst )
+{
+	return 0;
+}
+
+//! Converts the leading elements of /a count strided vectors of /a numRows components C, returns
+//! how many were converted, none unless there's a SIMD kernel for C.
+template<typename C>
+uint32_t convertStridedSimd( const uint8_t *src, uint32_t stride, uint32_t count, uint32_t numRows, float scale, float *dst )
+{
+	return 0;
+}
+
+//! Widens the leading multiple of 8 of /a count packed unsigned integers C, returns how many were
+//! widened, none unless there's a SIMD kernel for C.
+template<typename C>
+size_t widenPackedSimd( const uint8_t *src, size_t count, uint32_t *dst )
+{
+	return 0;
+}
+
+#if defined( CI_GLTF_SSE2 )
+//! Widens the next 8 components at /a src to two vectors of 4 int32.
+template<typename C> void widen8( const uint8_t *src, __m128i *lo, __m128i *hi );
+
+template<> void widen8<int8_t>( const uint8_t *src, __m128i *lo, __m128i *hi )
+{
+	auto bytes = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( src ) );
+	auto shorts = _mm_unpacklo_epi8( bytes, bytes );
+	*lo = _mm_srai_epi32( _mm_unpacklo_epi16( shorts, shorts ), 24 );
+	*hi = _mm_srai_epi32( _mm_unpackhi_epi16( shorts, shorts ), 24 );
+}
+
+template<> void widen8<uint8_t>( const uint8_t *src, __m128i *lo, __m128i *hi )
+{
+	auto zero = _mm_setzero_si128();
+	auto shorts = _mm_unpacklo_epi8( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( src ) ), zero );
+	*lo = _mm_unpacklo_epi16( shorts, zero );
+	*hi = _mm_unpackhi_epi16( shorts, zero );
+}
+
+template<> void widen8<int16_t>( const uint8_t *src, __m128i *lo, __m128i *hi )
+{
+	auto shorts = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src ) );
+	*lo = _mm_srai_epi32( _mm_unpacklo_epi16( shorts, shorts ), 16 );
+	*hi = _mm_srai_epi32( _mm_unpackhi_epi16( shorts, shorts ), 16 );
+}
+
+template<> void widen8<uint16_t>( const uint8_t *src, __m128i *lo, __m128i *hi )
+{
+	auto zero = _mm_setzero_si128();
+	auto shorts = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src ) );
+	*lo = _mm_unpacklo_epi16( shorts, zero );
+	*hi = _mm_unpackhi_epi16( shorts, zero );
+}
+
+template<typename C>
+size_t convertPackedSse2( const uint8_t *src, size_t count, float scale, float *dst )
+{
+	auto scaleVec = _mm_set1_ps( scale ), minusOne = _mm_set1_ps( -1.0f );
+	size_t i = 0;
+	for( ; i + 8 <= count; i += 8 ) {
+		__m128i lo, hi;
+		widen8<C>( src + i * sizeof( C ), &lo, &hi );
+		auto loFloats = _mm_cvtepi32_ps( lo ), hiFloats = _mm_cvtepi32_ps( hi );
+		if( scale != 0.0f ) {
+			loFloats = _mm_max_ps( _mm_mul_ps( loFloats, scaleVec ), minusOne );
+			hiFloats = _mm_max_ps( _mm_mul_ps( hiFloats, scaleVec ), minusOne );
+		}
+		_mm_storeu_ps( dst + i, loFloats );
+		_mm_storeu_ps( dst + i + 4, hiFloats );
+	}
+	return i;
+}
+
+//! Widens /a count tightly packed unsigned components C to uint32_t 8 at a time. Returns the
+//! number widened, the rest is left to the scalar path.
+template<typename C>
+size_t widenPackedSse2( const uint8_t *src, size_t count, uint32_t *dst )
+{
+	size_t i = 0;
+	for( ; i + 8 <= count; i += 8 ) {
+		__m128i lo, hi;
+		widen8<C>( src + i * sizeof( C ), &lo, &hi );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), lo );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i + 4 ), hi );
+	}
+	return i;
+}
+
+//! Converts each element of up to 4 components with one widen, storing 4 floats where the next
+//! element's are written after. Stops while those 4 floats still fit in the /a count * /a numRows
+//! of /a dst, the last elements are left to the scalar path.
+template<typename C>
+uint32_t convertStridedSse2( const uint8_t *src, uint32_t stride, uint32_t count, uint32_t numRows, float scale, float *dst )
+{
+	if( numRows > 4 || count == 0 )
+		return 0;
+	auto scaleVec = _mm_set1_ps( scale ), minusOne = _mm_set1_ps( -1.0f );
+	// elements are copied out first, reading 16 bytes at the end of the buffer could fault.
+	alignas( 16 ) uint8_t element[16] = {};
+	uint32_t i = 0;
+	for( ; size_t( i ) * numRows + 4 <= size_t( count ) * numRows; i++, src += stride ) {
+		memcpy( element, src, numRows * sizeof( C ) );
+		__m128i lo, hi;
+		widen8<C>( element, &lo, &hi );
+		auto floats = _mm_cvtepi32_ps( lo );
+		if( scale != 0.0f )
+			floats = _mm_max_ps( _mm_mul_ps( floats, scaleVec ), minusOne );
+		_mm_storeu_ps( dst + size_t( i ) * numRows, floats );
+	}
+	return i;
+}
+
+template<> size_t convertPackedSimd<int8_t>( const uint8_t *src, size_t count, float scale, float *dst ) { return convertPackedSse2<int8_t>( src, count, scale, dst ); }
+template<> size_t convertPackedSimd<uint8_t>( const uint8_t *src, size_t count, float scale, float *dst ) { return convertPackedSse2<uint8_t>( src, count, scale, dst ); }
+template<> size_t convertPackedSimd<int16_t>( const uint8_t *src, size_t count, float scale, float *dst ) { return convertPackedSse2<int16_t>( src, count, scale, dst ); }
+template<> size_t convertPackedSimd<uint16_t>( const uint8_t *src, size_t count, float scale, float *dst ) { return convertPackedSse2<uint16_t>( src, count, scale, dst ); }
+
+template<> uint32_t convertStridedSimd<int8_t>( const uint8_t *src, uint32_t stride, uint32_t count, uint32_t numRows, float scale, float *dst ) { return convertStridedSse2<int8_t>( src, stride, count, numRows, scale, dst ); }
+template<> uint32_t convertStridedSimd<uint8_t>( const uint8_t *src, uint32_t stride, uint32_t count, uint32_t numRows, float scale, float *dst ) { return convertStridedSse2<uint8_t>( src, stride, count, numRows, scale, dst ); }
+template<> uint32_t convertStridedSimd<int16_t>( const uint8_t *src, uint32_t stride, uint32_t count, uint32_t numRows, float scale, float *dst ) { return convertStridedSse2<int16_t>( src, stride, count, numRows, scale, dst ); }
+template<> uint32_t convertStridedSimd<uint16_t>( const uint8_t *src, uint32_t stride, uint32_t count, uint32_t numRows, float scale, float *dst ) { return convertStridedSse2<uint16_t>( src, stride, count, numRows, scale, dst ); }
+
+template<> size_t widenPackedSimd<uint8_t>( const uint8_t *src, size_t count, uint32_t *dst ) { return widenPackedSse2<uint8_t>( src, count, dst ); }
+template<> size_t widenPackedSimd<uint16_t>( const uint8_t *src, size_t count, uint32_t *dst ) { return widenPackedSse2<uint16_t>( src, count, dst ); }
+#endif
+
+//! Converts /a count tightly packed components C, multiplied by /a scale unless it's 0, clamping
+//! at -1 as glTF normalizes signed integers.
+template<typename C>
+void convertPacked( const uint8_t *src, size_t count, float scale, float *dst )
+{
+	for( size_t i = convertPackedSimd<C>( src, count, scale, dst ); i < count; i++ ) {
+		C value;
+		memcpy( &value, src + i * sizeof( C ), sizeof( C ) );
+		dst[i] = scale != 0.0f ? std::max( value * scale, -1.0f ) : static_cast<float>( value );
+	}
+}
+
+//! Converts /a count elements of /a numColumns columns of /a numRows components C, see above.
+template<typename C>
+void convertStrided( const uint8_t *src, uint32_t stride, uint32_t count, uint32_t numColumns, uint32_t numRows,
+					 uint32_t columnSize, float scale, float *dst )
+{
+	uint32_t i = 0;
+	if( numColumns == 1 ) {
+		i = convertStridedSimd<C>( src, stride, count, numRows, scale, dst );
+		src += size_t( i ) * stride;
+		dst += size_t( i ) * numRows;
+	}
+	for( ; i < count; i++, src += stride ) {
+		for( uint32_t column = 0; column < numColumns; column++ ) {
+			convertPacked<C>( src + column * columnSize, numRows, scale, dst );
+			dst += numRows;
+		}
+	}
+}
+
+template<typename C>
+void convertComponents( const Accessor &accessor, const uint8_t *src, uint32_t stride, uint32_t count, float scale, float *dst )
+{
+	uint32_t numComponents = accessor.getNumComponents();
+	if( stride == numComponents * sizeof( C ) ) {
+		convertPacked<C>( src, size_t( count ) * numComponents, scale, dst );
+		return;
+	}
+	uint32_t numColumns = getNumColumns( accessor.dataType );
+	convertStrided<C>( src, stride, count, numColumns, numComponents / numColumns, getColumnSize( accessor ), scale, dst );
+}
+
+//! Converts /a count elements of /a accessor's layout at /a src, /a stride bytes apart.
+void convertElements( const Accessor &accessor, const uint8_t *src, uint32_t stride, uint32_t count, float *dst )
+{
+	uint32_t numComponents = accessor.getNumComponents();
+	if( accessor.componentType == Accessor::ComponentType::FLOAT && stride == numComponents * sizeof( float ) ) {
+		memcpy( dst, src, size_t( count ) * stride );
+		return;
+	}
+	auto normalized = accessor.normalized;
+	switch( accessor.componentType ) {
+		case Accessor::ComponentType::BYTE:
+			convertComponents<int8_t>( accessor, src, stride, count, normalized ? 1.0f / 127.0f : 0.0f, dst );
+			break;
+		case Accessor::ComponentType::UNSIGNED_BYTE:
+			convertComponents<uint8_t>( accessor, src, stride, count, normalized ? 1.0f / 255.0f : 0.0f, dst );
+			break;
+		case Accessor::ComponentType::SHORT:
+			convertComponents<int16_t>( accessor, src, stride, count, normalized ? 1.0f / 32767.0f : 0.0f, dst );
+			break;
+		case Accessor::ComponentType::UNSIGNED_SHORT:
+			convertComponents<uint16_t>( accessor, src, stride, count, normalized ? 1.0f / 65535.0f : 0.0f, dst );
+			break;
+		case Accessor::ComponentType::UNSIGNED_INT:
+			convertComponents<uint32_t>( accessor, src, stride, count, 0.0f, dst );
+			break;
+		case Accessor::ComponentType::FLOAT:
+			convertComponents<float>( accessor, src, stride, count, 0.0f, dst );
+			break;
+	}
+}
+
+//! Widens /a count unsigned integers C at /a src, /a stride bytes apart.
+template<typename C>
+void widenIndices( const uint8_t *src, uint32_t stride, uint32_t count, uint32_t *dst )
+{
+	if( stride == sizeof( C ) && sizeof( C ) == sizeof( uint32_t ) ) {
+		memcpy( dst, src, size_t( count ) * sizeof( C ) );
+		return;
+	}
+	size_t i = stride == sizeof( C ) ? widenPackedSimd<C>( src, count, dst ) : 0;
+	for( ; i < count; i++ ) {
+		C value;
+		memcpy( &value, src + i * stride, sizeof( C ) );
+		dst[i] = value;
+	}
+}
+
+//! Widens /a count elements of the index /a accessor at /a src. Returns false if they aren't unsigned.
+bool widenElements( const Accessor &accessor, const uint8_t *src, uint32_t stride, uint32_t count, uint32_t *dst )
+{
+	switch( accessor.componentType ) {
+		case Accessor::ComponentType::UNSIGNED_BYTE: widenIndices<uint8_t>( src, stride, count, dst ); return true;
+		case Accessor::ComponentType::UNSIGNED_SHORT: widenIndices<uint16_t>( src, stride, count, dst ); return true;
+		case Accessor::ComponentType::UNSIGNED_INT: widenIndices<uint32_t>( src, stride, count, dst ); return true;
+		default: return false;
+	}
+}
+
+//! Returns the data of /a bufferView at /a byteOffset, null if its buffer couldn't be loaded.
+const uint8_t* getBufferViewData( const BufferView *bufferView, uint32_t byteOffset )
+{
+	auto data = bufferView->buffer->getBuffer();
+	if( ! data )
+		return nullptr;
+	return reinterpret_cast<const uint8_t*>( data->getData() ) + bufferView->byteOffset + byteOffset;
+}
+
+//! Calls /a write with the index and data of every sparse value of /a accessor.
+template<typename I, typename Write>
+void scatterSparse( const Accessor &accessor, const uint8_t *indices, const uint8_t *values, const Write &write )
+{
+	auto elementSize = accessor.getElementSize();
+	bool invalid = false;
+	for( uint32_t i = 0; i < accessor.sparse.count; i++ ) {
+		I index;
+		memcpy( &index, indices + i * sizeof( I ), sizeof( I ) );
+		if( index >= accessor.count ) {
+			invalid = true;
+			continue;
+		}
+		write( index, values + i * elementSize );
+	}
+	if( invalid )
+		CI_LOG_E( "Sparse accessor " << accessor.key << " has indices past its count, they were skipped" );
+}
+
+//! Writes the sparse values of /a accessor over the elements at their indices with /a write.
+template<typename Write>
+bool applySparse( const Accessor &accessor, const Write &write )
+{
+	auto &sparse = accessor.sparse;
+	if( ! sparse.indicesBufferView || ! sparse.valuesBufferView ) {
+		CI_LOG_E( "Sparse accessor " << accessor.key << " has no indices or values to copy" );
+		return false;
+	}
+	auto indices = getBufferViewData( sparse.indicesBufferView, sparse.indicesByteOffset );
+	auto values = getBufferViewData( sparse.valuesBufferView, sparse.valuesByteOffset );
+	if( ! indices || ! values ) {
+		CI_LOG_E( "Sparse accessor " << accessor.key << " has no indices or values to copy" );
+		return false;
+	}
+	size_t indexSize = 0;
+	switch( sparse.indicesComponentType ) {
+		case Accessor::ComponentType::UNSIGNED_BYTE: indexSize = 1; break;
+		case Accessor::ComponentType::UNSIGNED_SHORT: indexSize = 2; break;
+		case Accessor::ComponentType::UNSIGNED_INT: indexSize = 4; break;
+		default: break;
+	}
+	auto fits = []( const BufferView *bufferView, size_t byteOffset, size_t size ) {
+		return ! bufferView->byteLength || byteOffset + size <= bufferView->byteLength;
+	};
+	if( ! fits( sparse.indicesBufferView, sparse.indicesByteOffset, size_t( sparse.count ) * indexSize )
+	   || ! fits( sparse.valuesBufferView, sparse.valuesByteOffset, size_t( sparse.count ) * accessor.getElementSize() ) ) {
+		CI_LOG_E( "Sparse accessor " << accessor.key << " reads past the end of its bufferViews" );
+		return false;
+	}
+	switch( sparse.indicesComponentType ) {
+		case Accessor::ComponentType::UNSIGNED_BYTE: scatterSparse<uint8_t>( accessor, indices, values, write ); break;
+		case Accessor::ComponentType::UNSIGNED_SHORT: scatterSparse<uint16_t>( accessor, indices, values, write ); break;
+		case Accessor::ComponentType::UNSIGNED_INT: scatterSparse<uint32_t>( accessor, indices, values, write ); break;
+		default: CI_LOG_E( "Sparse accessor " << accessor.key << " has indices that aren't unsigned" ); return false;
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+uint32_t Accessor::getElementSize() const
+{
+	return getNumColumns( dataType ) * getColumnSize( *this );
+}
+
+uint32_t Accessor::getByteStride() const
+{
+	return byteStride ? byteStride : getElementSize();
+}
+
+bool Accessor::copyTo( float *dst ) const
+{
+	uint32_t numComponents = getNumComponents();
+	if( ! bufferView )
+		std::fill( dst, dst + size_t( count ) * numComponents, 0.0f );
+	else {
+		auto src = reinterpret_cast<const uint8_t*>( getDataPtr() );
+		if( ! src ) {
+			CI_LOG_E( "Accessor " << key << " has no data to copy" );
+			return false;
+		}
+		convertElements( *this, src, getByteStride(), count, dst );
+	}
+	if( ! isSparse() )
+		return true;
+	auto elementSize = getElementSize();
+	return applySparse( *this, [&]( uint32_t index, const uint8_t *value ) {
+		convertElements( *this, value, elementSize, 1, dst + size_t( index ) * numComponents );
+	} );
+}
+
+bool Accessor::copyTo( uint32_t *dst ) const
+{
+	if( dataType != Type::SCALAR || componentType == ComponentType::BYTE || componentType == ComponentType::SHORT
+	   || componentType == ComponentType::FLOAT ) {
+		CI_LOG_E( "Accessor " << key << " doesn't hold unsigned integer scalars" );
+		return false;
+	}
+	if( ! bufferView )
+		std::fill( dst, dst + count, 0u );
+	else {
+		auto src = reinterpret_cast<const uint8_t*>( getDataPtr() );
+		if( ! src ) {
+			CI_LOG_E( "Accessor " << key << " has no data to copy" );
+			return false;
+		}
+		widenElements( *this, src, getByteStride(), count, dst );
+	}
+	if( ! isSparse() )
+		return true;
+	auto elementSize = getElementSize();
+	return applySparse( *this, [&]( uint32_t index, const uint8_t *value ) {
+		widenElements( *this, value, elementSize, 1, dst + index );
+	} );
+}
+
 void* Accessor::getDataPtr() const
 {
-	const auto &buffer = bufferView->buffer;
-	return reinterpret_cast<uint8_t*>(buffer->getBuffer()->getData()) + bufferView->byteOffset + byteOffset;
+	// glTF 2.0 accessors without a bufferView are all zeros.
+	if( ! bufferView )
+		return nullptr;
+	return const_cast<uint8_t*>( getBufferViewData( bufferView, byteOffset ) );
+}
+
+ci::BufferRef Buffer::getBuffer() const
+{
+	cacheData();
+	return std::atomic_load( &data );
+}
+
+void Buffer::cacheData() const
+{
+	// Checked without the lock first, loaded buffers are never replaced.
+	if( std::atomic_load( &data ) || path.empty() )
+		return;
+	
+	std::lock_guard<std::mutex> lock( *dataMutex );
+	// a failed load isn't retried, every later call returns null without touching the disk.
+	if( data || failed )
+		return;
+	try {
+		auto start = LoadCounters::Clock::now();
+		auto loaded = shared ? ResourceCache::get().loadBuffer( path ) : loadFile( path )->getBuffer();
+		// counted even when loaded on first use, long after the File was created.
+		if( counters ) {
+			counters->bufferNanos += LoadCounters::nanosSince( start );
+			counters->bufferBytes += loaded->getSize();
+		}
+		std::atomic_store( &data, loaded );
+	}
+	catch( const std::exception &e ) {
+		failed = true;
+		CI_LOG_E( "Couldn't load buffer " << path << ": " << e.what() );
+	}
+}
+
+ci::ImageSourceRef Image::getImage() const
+{
+	cacheData();
+	return imageSource.valid() ? imageSource.get() : ci::ImageSourceRef();
+}
+
+bool Image::isReady() const
+{
+	return ! imageSource.valid() || imageSource.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+}
+
+void Image::cacheData() const
+{
+	// Helps the pool rather than sleeping, so this is safe to call from inside a worker.
+	if( imageSource.valid() && ! isReady() )
+		ThreadPool::get().wait( imageSource );
 }
 
 ci::AxisAlignedBox Mesh::getPositionAABB()
@@ -180,14 +627,10 @@ const Node* Node::getParent() const
 
 ci::mat4 Node::getHeirarchyTransform() const
 {
+	// each ancestor is applied once, walking up without recursion.
 	ci::mat4 ret = getTransformMatrix();
-	Node* tempParent = parent;
-	
-	while( tempParent != nullptr ) {
-		ret = tempParent->getHeirarchyTransform() * ret;
-		tempParent = tempParent->parent;
-	}
-	
+	for( auto ancestor = parent; ancestor != nullptr; ancestor = ancestor->parent )
+		ret = ancestor->getTransformMatrix() * ret;
 	return ret;
 }
 
@@ -203,29 +646,44 @@ Functions::Functions()
 
 SkeletonRef Skin::createSkeleton() const
 {
-	auto matricesPtr = reinterpret_cast<ci::mat4*>( inverseBindMatrices->getDataPtr() );
+	// inverseBindMatrices is optional in glTF 2.0, the joints are then bound with identity matrices.
+	AccessorView<ci::mat4> matrices;
+	if( inverseBindMatrices )
+		matrices = AccessorView<ci::mat4>( *inverseBindMatrices );
 	auto numJoints = joints.size();
+	if( inverseBindMatrices && matrices.size() < numJoints )
+		CI_LOG_E( "Skin " << key << " has fewer inverse bind matrices than joints" );
+	// ids are uint8_t, with 0xFF reserved for roots.
+	if( numJoints >= 0xFF ) {
+		CI_LOG_E( "Skin " << key << " has " << numJoints << " joints, at most 254 are supported" );
+		return SkeletonRef();
+	}
+	std::unordered_map<const Node*, uint8_t> jointIds;
+	for( size_t i = 0; i < numJoints; i++ ) {
+		if( ! joints[i] ) {
+			CI_LOG_E( "Skin " << key << " references a missing joint" );
+			return SkeletonRef();
+		}
+		jointIds[joints[i]] = static_cast<uint8_t>( i );
+	}
+	
 	std::vector<std::string> jointNames;
 	jointNames.reserve( numJoints );
-	
 	std::vector<Skeleton::Joint> jointsContainer;
 	jointsContainer.reserve( numJoints );
-	for( int i = 0; i < numJoints; i++ ) {
-		uint8_t parentId;
-		// if this joint is the root.
-		if( i == 0 )
-			parentId = 0xFF;
-		else {
-			auto begIt = begin( jointNames );
-			auto foundIt = std::find( begIt, end( jointNames ), joints[i]->parent->name );
-			auto distance = std::distance( begIt, foundIt );
-			parentId = static_cast<uint8_t>( distance );
+	for( size_t i = 0; i < numJoints; i++ ) {
+		// Joints aren't ordered parent first in glTF 2.0 and there can be several roots: the
+		// skeleton node, and any joint whose parent is missing or isn't part of this skin.
+		uint8_t parentId = 0xFF;
+		auto parent = joints[i]->parent;
+		if( joints[i] != skeleton && parent ) {
+			auto found = jointIds.find( parent );
+			if( found != jointIds.end() )
+				parentId = found->second;
 		}
-		CI_ASSERT( !  joints[i]->jointName.empty() );
-		jointNames.emplace_back(  joints[i]->jointName );
-		jointsContainer.emplace_back( static_cast<uint8_t>( parentId ), 
-									  static_cast<uint8_t>( jointNames.size() - 1 ), 
-									  *matricesPtr++ );
+		CI_ASSERT( ! joints[i]->jointName.empty() );
+		jointNames.emplace_back( joints[i]->jointName );
+		jointsContainer.emplace_back( parentId, static_cast<uint8_t>( i ), i < matrices.size() ? matrices[i] : ci::mat4() );
 	}
 	auto ret = std::make_shared<Skeleton>( std::move( jointsContainer ), std::move( jointNames ), bindShapeMatrix );
 	
@@ -258,10 +716,9 @@ std::vector<Animation::Parameter::Data> Animation::getParameters() const
 	// Initialize times for keyframes
 	CI_ASSERT( timeAccessor->dataType == Accessor::Type::SCALAR );
 	auto totalKeyFrames = timeAccessor->count;
-	auto dataPtr = timeAccessor->getDataPtr();
 	
 	Animation::Parameter::Data time{ "TIME", 1, std::vector<float>( totalKeyFrames ) };
-	memcpy( time.data.data(), dataPtr, totalKeyFrames * sizeof( float ) );
+	timeAccessor->copyTo( time.data.data() );
 	ret.emplace_back( move( time ) );
 	
 	for( auto & param : parameters ) {
@@ -269,10 +726,10 @@ std::vector<Animation::Parameter::Data> Animation::getParameters() const
 		auto numComponents = accessor->getNumComponents();
 		
 		CI_ASSERT( totalKeyFrames == accessor->count );
-		auto dataPtr = accessor->getDataPtr();
 		
+		// converts strided and quantized (KHR_mesh_quantization) keys as well.
 		Animation::Parameter::Data parameter{ param.parameter, numComponents, std::vector<float>( totalKeyFrames * numComponents ) };
-		memcpy( parameter.data.data(), dataPtr, accessor->count * numComponents * sizeof( float ) );
+		accessor->copyTo( parameter.data.data() );
 		ret.emplace_back( move( parameter ) );
 	}
 	
@@ -10,11 +10,16 @@
 
 #include <memory>
 #include <array>
+#include <future>
+#include <mutex>
+#include "cinder/Filesystem.h"
 // need this to define the GL constants, possibly figure out something else
 #include "cinder/gl/gl.h"
 // need this because of materials, possibly figure out something else
 #include "jsoncpp/json.h"
 
+#include "cinder/gltf/Symbol.h"
+
 namespace cinder {
 	
 class TransformClip;
@@ -41,6 +46,7 @@ struct Shader;
 struct Skin;
 struct Technique;
 struct Texture;
+class LoadCounters;
 
 struct Asset {
 	struct Profile {
@@ -53,7 +59,7 @@ struct Asset {
 
 struct Scene {
 	std::vector<Node*>			nodes;
-	std::string					name, key;
+	Symbol						name, key;
 };
 
 //! An accessor defines a method for retrieving data as typed arrays from within a bufferView.
@@ -66,14 +72,39 @@ struct Accessor {
 		UNSIGNED_BYTE = GL_UNSIGNED_BYTE,
 		SHORT = GL_SHORT,
 		UNSIGNED_SHORT = GL_UNSIGNED_SHORT,
+		UNSIGNED_INT = GL_UNSIGNED_INT,
 		FLOAT = GL_FLOAT
 	};
-	//! Returns a void* to the beginning of the data for this accessor
+	//! glTF 2.0 sparse storage, /a count values replacing the elements at /a count increasing
+	//! indices of the bufferView's data, or of zeros without one. Both arrays are tightly packed.
+	struct Sparse {
+		uint32_t		count{0};
+		BufferView		*indicesBufferView{nullptr},
+						*valuesBufferView{nullptr};
+		uint32_t		indicesByteOffset{0},
+						valuesByteOffset{0};
+		ComponentType	indicesComponentType{ComponentType::UNSIGNED_INT};
+	};
+	
+	//! Returns a void* to the beginning of the data for this accessor, not including sparse values.
 	void*	getDataPtr() const;
+	//! Returns whether some elements are stored sparsely, see Sparse.
+	bool	isSparse() const { return sparse.count > 0; }
 	//! Returns the number of components in the data type
 	uint8_t getNumComponents() const;
 	//! Returns the number of bytes per component of the data type
 	uint8_t getNumBytesForComponentType() const;
+	//! Returns the number of bytes per element, including the padding of matrix columns.
+	uint32_t getElementSize() const;
+	//! Returns the number of bytes from one element to the next, byteStride or the element size if packed.
+	uint32_t getByteStride() const;
+	//! Converts count elements to floats in /a dst, which must hold count * getNumComponents().
+	//! Normalized integers are mapped to [0, 1] or [-1, 1], accessors without a bufferView are
+	//! zeros and sparse accessors are densified. Returns false if a buffer couldn't be loaded.
+	bool	copyTo( float *dst ) const;
+	//! Widens count unsigned integer scalars, e.g. indices, to /a dst. Returns false if they aren't
+	//! unsigned integer scalars or a buffer couldn't be loaded.
+	bool	copyTo( uint32_t *dst ) const;
 	
 	BufferView*			bufferView{nullptr};
 	Type				dataType;
@@ -81,8 +112,10 @@ struct Accessor {
 	uint32_t			byteOffset, // Required
 						byteStride{0},
 						count;
+	bool				normalized{false};
+	Sparse				sparse;
 	std::vector<float>	min, max;
-	std::string			name, key;
+	Symbol				name, key;
 };
 
 //! Stores key frame data in buffers and references them using accessors.
@@ -90,15 +123,15 @@ struct Animation {
 	
 	//! Connects the output values of the key frame animation to a specific node in the hierarchy.
 	struct Channel {
-		std::string sampler, path;
+		Symbol		sampler, path;
 		Node		*target{nullptr};
-		std::string	targetId;
+		Symbol		targetId;
 	};
 	//! Animation type. Linear is the only defined type
 	struct Sampler {
 		enum class LerpType { LINEAR };
-		std::string input, output;
-		LerpType type{LerpType::LINEAR};
+		Symbol		input, output;
+		LerpType	type{LerpType::LINEAR};
 	};
 	//! Parameter data with associated accessor.
 	struct Parameter {
@@ -107,8 +140,8 @@ struct Animation {
 			uint32_t			numComponents;
 			std::vector<float>	data;
 		};
-		std::string parameter;
-		Accessor* accessor{nullptr};
+		Symbol		parameter;
+		Accessor*	accessor{nullptr};
 	};
 	
 	//! Returns a vector of Parameter data.
@@ -122,27 +155,38 @@ struct Animation {
 	//! Returns a Clip<ci::quat> representing the rotation with the information stored in /a paramData.
 	static Clip<ci::quat>	createRotationClip( const std::vector<Parameter::Data> &paramData );
 	
-	std::string				target;
+	Symbol					target;
 	std::vector<Channel>	channels;
 	std::vector<Sampler>	samplers;
 	Accessor				*timeAccessor{nullptr};
 	std::vector<Parameter>	parameters;
-	std::string				name, key;
+	Symbol					name, key;
 };
 
 struct Buffer {
 	
-	ci::BufferRef getBuffer() const { return data; }
+	//! Returns the data, loading external buffers from disk on first use. Safe to call from any thread.
+	//! Null if the load failed, which is only attempted once.
+	ci::BufferRef getBuffer() const;
+	//! Loads the data on the calling thread if it isn't resident yet.
+	void prefetch() const { cacheData(); }
+	//! Returns whether the data is resident.
+	bool isLoaded() const { return std::atomic_load( &data ) != nullptr; }
 	
 	uint32_t		byteLength{0};
 	std::string		uri; // path
 	std::string		type = "arrayBuffer";
-	std::string		name, key;
+	Symbol			name, key;
 	
 private:
 	void cacheData() const;
 	
+	ci::fs::path				path; // resolved location of an external buffer, empty if embedded.
+	bool						shared{false}; // loaded through the ResourceCache
+	std::shared_ptr<LoadCounters>	counters; // of the File, null for snapshots
 	mutable ci::BufferRef		data;
+	mutable bool				failed{false}; // the load threw, guarded by dataMutex
+	std::shared_ptr<std::mutex>	dataMutex{ std::make_shared<std::mutex>() };
 	friend class File;
 };
 
@@ -154,9 +198,10 @@ struct BufferView {
 	
 	Buffer			*buffer{nullptr}; // Pointer to buffer
 	uint32_t		byteLength{0},
-					byteOffset;
+					byteOffset,
+					byteStride{0}; // glTF 2.0, 0 if tightly packed
 	Target			target;
-	std::string		name, key;
+	Symbol			name, key;
 };
 
 struct Camera {
@@ -165,9 +210,9 @@ struct Camera {
 	ci::CameraPersp		getPerspCameraByName( const ci::mat4 &transformBake = ci::mat4() );
 	ci::CameraOrtho		getOrthoCameraByName( const ci::mat4 &transformBack = ci::mat4() );
 	
-	std::string		name, key;
+	Symbol			name, key;
 	Type			type;
-	Node			*node;
+	Node			*node{nullptr};
 	float			zfar{0.0f},
 					znear{0.0f},
 					// only for perspective
@@ -179,14 +224,19 @@ struct Camera {
 };
 
 struct Image {
-	ci::ImageSourceRef getImage() const { return imageSource; }
+	//! Returns the decoded image, blocking only if the decode started while loading hasn't finished.
+	//! Null if the image couldn't be decoded.
+	ci::ImageSourceRef getImage() const;
+	//! Returns whether the decode has finished.
+	bool isReady() const;
 	
-	std::string			name, key;
+	Symbol				name, key;
 	std::string			uri; // path
 private:
 	void cacheData() const;
 	
-	mutable ci::ImageSourceRef	imageSource;
+	std::shared_future<ci::ImageSourceRef>	imageSource;
+	bool									shared{false}; // decoded through the ResourceCache
 	friend class File;
 };
 
@@ -200,13 +250,14 @@ struct Light {
 				linearAttenuation{1.0f},
 				quadraticAttenuation{1.0f},
 				falloffAngle{float( M_PI ) / 2.0f},
-				falloffExponent{0.0f};
+				falloffExponent{0.0f},
+				intensity{1.0f}; // KHR_lights_punctual
 	Type		type;
-	std::string name, key;
+	Symbol name, key;
 };
 
 struct Material {
-	std::string		name, key;
+	Symbol			name, key;
 	Technique		*technique = nullptr;
 	
 	struct Source {
@@ -242,7 +293,7 @@ struct Mesh {
 	static ci::geom::Attrib getAttribEnum( const std::string &attrib );
 	static ci::geom::Primitive convertToPrimitive( GLenum primitive );
 	
-	std::string				name, key;
+	Symbol					name, key;
 	std::vector<Primitive>	primitives;
 };
 
@@ -276,23 +327,23 @@ struct Node {
 	Light					*light{nullptr};
 	std::vector<Node*>		children, skeletons;
 	std::vector<Mesh*>		meshes;
-	std::string				jointName;
+	Symbol					jointName;
 	std::vector<float>		transformMatrix,	// either 0 or 16
 							rotation,			// either 0 or 4
 							translation,		// either 0 or 3
 							scale;				// either 0 or 3
 	
-	std::string				name, key;
+	Symbol					name, key;
 };
 
 struct Program {
 	Shader					*frag{nullptr}, *vert{nullptr};
-	std::string				 name, key;
-	std::vector<std::string> attributes;
+	Symbol					 name, key;
+	std::vector<Symbol>		 attributes;
 };
 
 struct Sampler {
-	std::string				name, key;
+	Symbol					name, key;
 	GLenum					magFilter{GL_LINEAR},
 							minFilter{GL_NEAREST_MIPMAP_LINEAR},
 							wrapS{GL_REPEAT},
@@ -307,7 +358,7 @@ struct Shader {
 	
 	const std::string& getSource() const;
 	
-	std::string				name, key;
+	Symbol					name, key;
 	std::string				uri; // path
 	Type					type;
 	
@@ -325,14 +376,15 @@ struct Skin {
 	ci::mat4			bindShapeMatrix;
 	Accessor			*inverseBindMatrices{nullptr};
 	std::vector<Node*>	joints;
-	std::string			name, key;
+	Node				*skeleton{nullptr}; // glTF 2.0 root of the joint hierarchy
+	Symbol				name, key;
 };
 
 struct Technique {
 	struct Parameter {
-		std::string				name;
+		Symbol					name;
 		Node*					node{nullptr};
-		std::string				semantic;
+		Symbol					semantic;
 		uint32_t				count{0};
 		GLenum					type;
 	};
@@ -361,10 +413,10 @@ struct Technique {
 	static ci::gl::UniformSemantic getUniformEnum( const std::string &uniform );
 	
 	Program					*program{nullptr};
-	std::string				name, key;
+	Symbol					name, key;
 	std::vector<Parameter>	parameters;
 	State					states;
-	std::vector<std::pair<std::string, std::string>> attributes, uniforms;
+	std::vector<std::pair<Symbol, Symbol>> attributes, uniforms;
 };
 
 struct Texture {
@@ -374,7 +426,7 @@ struct Texture {
 					internalFormat{GL_RGBA},
 					target{GL_TEXTURE_2D},
 					type{GL_UNSIGNED_BYTE};
-	std::string		name, key;
+	Symbol			name, key;
 };
 	
 } // gltf
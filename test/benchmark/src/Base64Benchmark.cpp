@@ -0,0 +1,79 @@
+//
+//  Base64Benchmark.cpp
+//  gltf
+//
+//  Times decoding a large embedded buffer with ci::fromBase64(), which gltf::File used before
+//  DataUri, and with each decoder of gltf::decodeBase64() the CPU supports.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "cinder/Base64.h"
+
+#include "cinder/gltf/DataUri.h"
+
+using namespace ci;
+using namespace ci::gltf;
+using namespace std;
+
+namespace {
+
+//! Returns the fastest of /a runs calls to /a decode, in seconds.
+double time( const function<void()> &decode, int runs )
+{
+	double ret = numeric_limits<double>::max();
+	for( int run = 0; run < runs; run++ ) {
+		auto start = chrono::steady_clock::now();
+		decode();
+		ret = min( ret, chrono::duration<double>( chrono::steady_clock::now() - start ).count() );
+	}
+	return ret;
+}
+
+void report( const char *name, size_t numBytes, double seconds, double baseline )
+{
+	cout << name << ": " << seconds * 1000.0 << " ms, " << numBytes / seconds / ( 1024.0 * 1024.0 ) << " MB/s, "
+		 << baseline / seconds << "x fromBase64" << endl;
+}
+
+} // anonymous namespace
+
+int main()
+{
+	// about the size of a textured model's embedded buffer.
+	const size_t numBytes = 32 * 1024 * 1024;
+	const int runs = 10;
+	vector<uint8_t> bytes( numBytes );
+	for( size_t i = 0; i < numBytes; i++ )
+		bytes[i] = static_cast<uint8_t>( i * 2654435761u >> 24 );
+	auto chars = toBase64( bytes.data(), bytes.size() );
+
+	auto baseline = time( [&] { fromBase64( chars ); }, runs );
+	report( "fromBase64", numBytes, baseline, baseline );
+
+	vector<uint8_t> decoded( getBase64DecodedSize( chars.data(), chars.size() ) );
+	const pair<const char*, Base64Decoder> decoders[] = {
+		{ "decodeBase64 SCALAR", Base64Decoder::SCALAR },
+		{ "decodeBase64 SSSE3", Base64Decoder::SSSE3 },
+		{ "decodeBase64 AVX2", Base64Decoder::AVX2 }
+	};
+	for( auto &decoder : decoders ) {
+		if( ! isBase64DecoderSupported( decoder.second ) ) {
+			cout << decoder.first << ": unsupported" << endl;
+			continue;
+		}
+		auto seconds = time( [&] { decodeBase64( chars.data(), chars.size(), decoded.data(), decoder.second ); }, runs );
+		if( decoded != bytes ) {
+			cout << decoder.first << ": decoded the wrong bytes" << endl;
+			return 1;
+		}
+		report( decoder.first, numBytes, seconds, baseline );
+	}
+	return 0;
+}
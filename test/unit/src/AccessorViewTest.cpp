@@ -0,0 +1,275 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "cinder/Base64.h"
+#include "cinder/DataSource.h"
+
+#include "cinder/gltf/AccessorView.h"
+#include "cinder/gltf/File.h"
+
+using namespace ci;
+using namespace ci::gltf;
+using namespace std;
+
+namespace {
+
+template<typename T>
+void append( vector<uint8_t> *bytes, initializer_list<T> values )
+{
+	for( auto &value : values ) {
+		auto begin = reinterpret_cast<const uint8_t*>( &value );
+		bytes->insert( bytes->end(), begin, begin + sizeof( T ) );
+	}
+}
+
+//! 3 vertices interleaved at a stride of 20: a float VEC3, 4 UNSIGNED_BYTEs and 2 SHORTs. Then 4
+//! packed UNSIGNED_SHORT indices.
+vector<uint8_t> createBuffer()
+{
+	vector<uint8_t> ret;
+	append<float>( &ret, { 0, 0, 0 } );
+	append<uint8_t>( &ret, { 0, 255, 51, 128 } );
+	append<int16_t>( &ret, { -32767, 32767 } );
+	append<float>( &ret, { 1, 2, 3 } );
+	append<uint8_t>( &ret, { 255, 0, 0, 255 } );
+	append<int16_t>( &ret, { -32768, 16384 } );
+	append<float>( &ret, { 2, 4, 6 } );
+	append<uint8_t>( &ret, { 1, 2, 3, 4 } );
+	append<int16_t>( &ret, { 0, -1 } );
+	append<uint16_t>( &ret, { 0, 1, 2, 2 } );
+	return ret;
+}
+
+//! Accessors 0 to 2 read the interleaved attributes, 1 normalized and 3 not. 4 reads the
+//! indices and 5 reads past the end of their bufferView.
+FileRef createFile()
+{
+	auto bytes = createBuffer();
+	string json = R"({
+		"asset": { "version": "2.0" },
+		"buffers": [ { "byteLength": )" + to_string( bytes.size() ) + R"(, "uri": "data:application/octet-stream;base64,)" + toBase64( bytes.data(), bytes.size() ) + R"(" } ],
+		"bufferViews": [
+			{ "buffer": 0, "byteLength": 60, "byteStride": 20 },
+			{ "buffer": 0, "byteOffset": 60, "byteLength": 8 }
+		],
+		"accessors": [
+			{ "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3" },
+			{ "bufferView": 0, "byteOffset": 12, "componentType": 5121, "normalized": true, "count": 3, "type": "VEC4" },
+			{ "bufferView": 0, "byteOffset": 16, "componentType": 5122, "normalized": true, "count": 3, "type": "VEC2" },
+			{ "bufferView": 0, "byteOffset": 12, "componentType": 5121, "count": 3, "type": "VEC4" },
+			{ "bufferView": 1, "componentType": 5123, "count": 4, "type": "SCALAR" },
+			{ "bufferView": 1, "componentType": 5123, "count": 5, "type": "SCALAR" }
+		]
+	})";
+	auto buffer = ci::Buffer::create( json.size() );
+	memcpy( buffer->getData(), json.data(), json.size() );
+	return File::create( DataSourceBuffer::create( buffer ) );
+}
+
+//! 4 float VEC3 base elements, 2 UNSIGNED_BYTE sparse indices, 2 sparse values and 2 more
+//! indices as UNSIGNED_SHORT. Accessor 0 replaces elements 1 and 3 of the base, accessor 1
+//! replaces elements 0 and 2 of zeros. Accessor 2's indices and accessor 3's base don't fit.
+FileRef createSparseFile()
+{
+	vector<uint8_t> bytes;
+	append<float>( &bytes, { 0, 0, 1,  1, 1, 1,  2, 2, 1,  3, 3, 1 } );
+	append<uint8_t>( &bytes, { 1, 3, 0, 0 } );
+	append<float>( &bytes, { 10, 10, 10,  30, 30, 30 } );
+	append<uint16_t>( &bytes, { 0, 2 } );
+	string json = R"({
+		"asset": { "version": "2.0" },
+		"buffers": [ { "byteLength": )" + to_string( bytes.size() ) + R"(, "uri": "data:application/octet-stream;base64,)" + toBase64( bytes.data(), bytes.size() ) + R"(" } ],
+		"bufferViews": [
+			{ "buffer": 0, "byteLength": 48 },
+			{ "buffer": 0, "byteOffset": 48, "byteLength": 2 },
+			{ "buffer": 0, "byteOffset": 52, "byteLength": 24 },
+			{ "buffer": 0, "byteOffset": 76, "byteLength": 4 },
+			{ "buffer": 0, "byteOffset": 48, "byteLength": 1 }
+		],
+		"accessors": [
+			{ "bufferView": 0, "componentType": 5126, "count": 4, "type": "VEC3", "sparse": { "count": 2,
+				"indices": { "bufferView": 1, "componentType": 5121 }, "values": { "bufferView": 2 } } },
+			{ "componentType": 5126, "count": 4, "type": "VEC3", "sparse": { "count": 2,
+				"indices": { "bufferView": 3, "componentType": 5123 }, "values": { "bufferView": 2 } } },
+			{ "bufferView": 0, "componentType": 5126, "count": 4, "type": "VEC3", "sparse": { "count": 2,
+				"indices": { "bufferView": 4, "componentType": 5121 }, "values": { "bufferView": 2 } } },
+			{ "bufferView": 0, "componentType": 5126, "count": 5, "type": "VEC3", "sparse": { "count": 2,
+				"indices": { "bufferView": 1, "componentType": 5121 }, "values": { "bufferView": 2 } } }
+		]
+	})";
+	auto buffer = ci::Buffer::create( json.size() );
+	memcpy( buffer->getData(), json.data(), json.size() );
+	return File::create( DataSourceBuffer::create( buffer ) );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "AccessorView" )
+{
+	auto file = createFile();
+	REQUIRE( file );
+	auto &accessors = file->getCollectionOf<Accessor>();
+	REQUIRE( accessors.size() == 6 );
+
+	SECTION( "stride" )
+	{
+		AccessorView<vec3> positions( *accessors.get( "0" ) );
+		REQUIRE( positions.size() == 3 );
+		REQUIRE( positions.getByteStride() == 20 );
+		REQUIRE_FALSE( positions.isContiguous() );
+		for( size_t i = 0; i < positions.size(); i++ )
+			REQUIRE( positions[i] == vec3( i, 2 * i, 3 * i ) );
+
+		vector<vec3> copied( positions.size() );
+		positions.copyTo( copied.data() );
+		REQUIRE( copied == vector<vec3>{ vec3( 0 ), vec3( 1, 2, 3 ), vec3( 2, 4, 6 ) } );
+
+		AccessorView<uint16_t> indices( *accessors.get( "4" ) );
+		REQUIRE( indices.getByteStride() == 2 );
+		REQUIRE( indices.isContiguous() );
+		vector<uint16_t> copiedIndices( indices.size() );
+		indices.copyTo( copiedIndices.data() );
+		REQUIRE( copiedIndices == vector<uint16_t>{ 0, 1, 2, 2 } );
+	}
+
+	SECTION( "type mismatch" )
+	{
+		// another type, another component type, or both.
+		REQUIRE( AccessorView<vec4>( *accessors.get( "0" ) ).empty() );
+		REQUIRE( AccessorView<float>( *accessors.get( "0" ) ).empty() );
+		REQUIRE( AccessorView<int16_t>( *accessors.get( "4" ) ).empty() );
+		REQUIRE( AccessorView<uint32_t>( *accessors.get( "4" ) ).empty() );
+		REQUIRE( AccessorView<uint8_t>( *accessors.get( "1" ) ).empty() );
+		REQUIRE_FALSE( AccessorView<uint16_t>( *accessors.get( "4" ) ).empty() );
+	}
+
+	SECTION( "reading past the bufferView" )
+	{
+		REQUIRE( AccessorView<uint16_t>( *accessors.get( "5" ) ).empty() );
+	}
+
+	SECTION( "random access iteration" )
+	{
+		AccessorView<vec3> positions( *accessors.get( "0" ) );
+		auto begin = positions.begin(), end = positions.end();
+		REQUIRE( end - begin == 3 );
+		REQUIRE( distance( begin, end ) == 3 );
+		REQUIRE( begin[2] == vec3( 2, 4, 6 ) );
+		REQUIRE( *( begin + 1 ) == vec3( 1, 2, 3 ) );
+		REQUIRE( *( end - 1 ) == vec3( 2, 4, 6 ) );
+		auto it = begin;
+		it += 2;
+		REQUIRE( *it-- == vec3( 2, 4, 6 ) );
+		REQUIRE( *it == vec3( 1, 2, 3 ) );
+		REQUIRE( ( begin < it && it < end && it >= begin + 1 && it <= end - 2 ) );
+		REQUIRE( vector<vec3>( begin, end ).size() == 3 );
+		REQUIRE( vector<vec3>( positions.begin(), positions.end() ) == vector<vec3>{ positions[0], positions[1], positions[2] } );
+
+		AccessorView<uint16_t> indices( *accessors.get( "4" ) );
+		REQUIRE( lower_bound( indices.begin(), indices.end(), uint16_t( 2 ) ) - indices.begin() == 2 );
+		REQUIRE( upper_bound( indices.begin(), indices.end(), uint16_t( 0 ) ) - indices.begin() == 1 );
+		vector<uint16_t> reversed( indices.size() );
+		reverse_copy( indices.begin(), indices.end(), reversed.begin() );
+		REQUIRE( reversed == vector<uint16_t>{ 2, 2, 1, 0 } );
+	}
+
+	SECTION( "copyTo converts normalized integers" )
+	{
+		vector<float> colors( 12 );
+		REQUIRE( accessors.get( "1" )->copyTo( colors.data() ) );
+		const float expectedColors[] = { 0, 1, 0.2f, 128 / 255.0f,  1, 0, 0, 1,  1 / 255.0f, 2 / 255.0f, 3 / 255.0f, 4 / 255.0f };
+		for( size_t i = 0; i < colors.size(); i++ )
+			REQUIRE( colors[i] == Approx( expectedColors[i] ) );
+
+		// -32768 clamps to -1.
+		vector<float> shorts( 6 );
+		REQUIRE( accessors.get( "2" )->copyTo( shorts.data() ) );
+		const float expectedShorts[] = { -1, 1,  -1, 16384 / 32767.0f,  0, -1 / 32767.0f };
+		for( size_t i = 0; i < shorts.size(); i++ )
+			REQUIRE( shorts[i] == Approx( expectedShorts[i] ) );
+
+		vector<float> unnormalized( 12 );
+		REQUIRE( accessors.get( "3" )->copyTo( unnormalized.data() ) );
+		REQUIRE( unnormalized == vector<float>{ 0, 255, 51, 128,  255, 0, 0, 255,  1, 2, 3, 4 } );
+
+		vector<uint32_t> indices( 4 );
+		REQUIRE( accessors.get( "4" )->copyTo( indices.data() ) );
+		REQUIRE( indices == vector<uint32_t>{ 0, 1, 2, 2 } );
+		REQUIRE_FALSE( accessors.get( "0" )->copyTo( indices.data() ) );
+	}
+}
+
+TEST_CASE( "SparseAccessorView" )
+{
+	auto file = createSparseFile();
+	REQUIRE( file );
+	auto &accessors = file->getCollectionOf<Accessor>();
+	REQUIRE( accessors.size() == 4 );
+	const vector<vec3> withBase = { vec3( 0, 0, 1 ), vec3( 10 ), vec3( 2, 2, 1 ), vec3( 30 ) };
+	const vector<vec3> withoutBase = { vec3( 10 ), vec3( 0 ), vec3( 30 ), vec3( 0 ) };
+
+	SECTION( "with a base bufferView" )
+	{
+		SparseAccessorView<vec3> view( *accessors.get( "0" ) );
+		REQUIRE( view.size() == 4 );
+		REQUIRE( view.getBase().size() == 4 );
+		REQUIRE( view.getNumSparse() == 2 );
+		REQUIRE( view.getSparseIndex( 1 ) == 3 );
+		for( size_t i = 0; i < view.size(); i++ )
+			REQUIRE( view[i] == withBase[i] );
+
+		vector<vec3> copied( view.size() );
+		view.copyTo( copied.data() );
+		REQUIRE( copied == withBase );
+
+		vector<vec3> densified( 4 );
+		REQUIRE( accessors.get( "0" )->copyTo( &densified[0].x ) );
+		REQUIRE( densified == withBase );
+	}
+
+	SECTION( "without a base bufferView" )
+	{
+		SparseAccessorView<vec3> view( *accessors.get( "1" ) );
+		REQUIRE( view.size() == 4 );
+		REQUIRE( view.getBase().empty() );
+		for( size_t i = 0; i < view.size(); i++ )
+			REQUIRE( view[i] == withoutBase[i] );
+
+		vector<vec3> copied( view.size(), vec3( -1 ) );
+		view.copyTo( copied.data() );
+		REQUIRE( copied == withoutBase );
+
+		vector<vec3> densified( 4, vec3( -1 ) );
+		REQUIRE( accessors.get( "1" )->copyTo( &densified[0].x ) );
+		REQUIRE( densified == withoutBase );
+	}
+
+	SECTION( "data that doesn't fit its bufferViews" )
+	{
+		vector<vec3> densified( 5 );
+		SparseAccessorView<vec3> indicesPastEnd( *accessors.get( "2" ) );
+		REQUIRE( indicesPastEnd.size() == 0 );
+		REQUIRE_FALSE( accessors.get( "2" )->copyTo( &densified[0].x ) );
+
+		SparseAccessorView<vec3> basePastEnd( *accessors.get( "3" ) );
+		REQUIRE( basePastEnd.size() == 0 );
+		REQUIRE( basePastEnd.getBase().empty() );
+	}
+
+	SECTION( "missing indices or values" )
+	{
+		for( bool missingIndices : { false, true } ) {
+			auto accessor = *accessors.get( "0" );
+			if( missingIndices )
+				accessor.sparse.indicesBufferView = nullptr;
+			else
+				accessor.sparse.valuesBufferView = nullptr;
+			SparseAccessorView<vec3> view( accessor );
+			REQUIRE( view.size() == 0 );
+			vector<vec3> densified( 4 );
+			REQUIRE_FALSE( accessor.copyTo( &densified[0].x ) );
+		}
+	}
+}
@@ -0,0 +1,105 @@
+#include "catch.hpp"
+
+#include "cinder/Base64.h"
+
+#include "cinder/gltf/DataUri.h"
+
+using namespace ci;
+using namespace ci::gltf;
+using namespace std;
+
+namespace {
+
+//! Every byte value, repeated to /a size, so the characters span the whole alphabet.
+vector<uint8_t> makeBytes( size_t size )
+{
+	vector<uint8_t> ret( size );
+	for( size_t i = 0; i < size; i++ )
+		ret[i] = static_cast<uint8_t>( i * 37 + 11 );
+	return ret;
+}
+
+//! Encodes /a bytes, without the trailing '=' unless /a padded.
+string encode( const vector<uint8_t> &bytes, bool padded )
+{
+	auto ret = toBase64( bytes.data(), bytes.size() );
+	if( ! padded )
+		ret.erase( ret.find_last_not_of( '=' ) + 1 );
+	return ret;
+}
+
+vector<Base64Decoder> getSupportedDecoders()
+{
+	vector<Base64Decoder> ret;
+	for( auto decoder : { Base64Decoder::SCALAR, Base64Decoder::SSSE3, Base64Decoder::AVX2 } ) {
+		if( isBase64DecoderSupported( decoder ) )
+			ret.push_back( decoder );
+	}
+	return ret;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "decodeBase64" )
+{
+	auto decoders = getSupportedDecoders();
+
+	SECTION( "every decoder matches the scalar one around the SIMD block thresholds" )
+	{
+		// SSSE3 decodes 16 characters while 24 remain, AVX2 32 while 40 remain, so these lengths
+		// cover running out just before, at and after a block for both.
+		for( size_t numBytes = 0; numBytes <= 96; numBytes++ ) {
+			auto bytes = makeBytes( numBytes );
+			for( bool padded : { false, true } ) {
+				auto chars = encode( bytes, padded );
+				REQUIRE( getBase64DecodedSize( chars.data(), chars.size() ) == numBytes );
+				for( auto decoder : decoders ) {
+					INFO( "decoder " << int( decoder ) << ", " << chars.size() << " characters, padded " << padded );
+					// the bytes past the output catch a store that runs over.
+					vector<uint8_t> decoded( numBytes + 32, 0xCD );
+					REQUIRE( decodeBase64( chars.data(), chars.size(), decoded.data(), decoder ) );
+					REQUIRE( equal( bytes.begin(), bytes.end(), decoded.begin() ) );
+					REQUIRE( all_of( decoded.begin() + numBytes, decoded.end(), []( uint8_t byte ) { return byte == 0xCD; } ) );
+				}
+			}
+		}
+	}
+
+	SECTION( "an invalid character fails every decoder, inside a SIMD block or after it" )
+	{
+		auto chars = encode( makeBytes( 60 ), true );
+		REQUIRE( chars.size() == 80 );
+		for( size_t position : { 0, 7, 15, 16, 23, 31, 32, 39, 40, 55, 79 } ) {
+			for( char invalid : { '*', '=', '\n', '\x80' } ) {
+				auto corrupted = chars;
+				corrupted[position] = invalid;
+				// trailing padding is valid.
+				if( invalid == '=' && position == chars.size() - 1 )
+					continue;
+				for( auto decoder : decoders ) {
+					INFO( "decoder " << int( decoder ) << ", character " << int( invalid ) << " at " << position );
+					vector<uint8_t> decoded( 60 );
+					REQUIRE_FALSE( decodeBase64( corrupted.data(), corrupted.size(), decoded.data(), decoder ) );
+				}
+			}
+		}
+	}
+
+	SECTION( "a length of one more than a multiple of 4 is invalid" )
+	{
+		string chars = "QUJDREVGR";
+		vector<uint8_t> decoded( 8 );
+		for( auto decoder : decoders )
+			REQUIRE_FALSE( decodeBase64( chars.data(), chars.size(), decoded.data(), decoder ) );
+	}
+
+	SECTION( "the default decoder matches the scalar one" )
+	{
+		auto bytes = makeBytes( 1000 );
+		auto chars = encode( bytes, true );
+		auto decoded = decodeBase64( chars.data(), chars.size() );
+		REQUIRE( decoded );
+		REQUIRE( decoded->getSize() == bytes.size() );
+		REQUIRE( memcmp( decoded->getData(), bytes.data(), bytes.size() ) == 0 );
+	}
+}
@@ -0,0 +1,304 @@
+#include "catch.hpp"
+
+#include <cstring>
+#include <fstream>
+
+#include "cinder/Base64.h"
+#include "cinder/DataSource.h"
+
+#include "cinder/Skeleton.h"
+#include "cinder/gltf/File.h"
+
+using namespace ci;
+using namespace ci::gltf;
+using namespace std;
+
+namespace {
+
+template<typename T>
+void append( vector<uint8_t> *bytes, initializer_list<T> values )
+{
+	for( auto &value : values ) {
+		auto begin = reinterpret_cast<const uint8_t*>( &value );
+		bytes->insert( bytes->end(), begin, begin + sizeof( T ) );
+	}
+}
+
+//! 3 vertices with POSITION and NORMAL interleaved at a stride of 24, 6 UNSIGNED_SHORT indices,
+//! then 2 key frame times, translations and rotations.
+vector<uint8_t> createBuffer()
+{
+	vector<uint8_t> ret;
+	for( int i = 0; i < 3; i++ )
+		append<float>( &ret, { float( i ), 0, 0,  0, 0, 1 } );
+	append<uint16_t>( &ret, { 0, 1, 2,  0, 2, 1 } );
+	append<float>( &ret, { 0, 1 } );
+	append<float>( &ret, { 0, 0, 0,  1, 2, 3 } );
+	append<float>( &ret, { 0, 0, 0, 1,  0, 1, 0, 0 } );
+	return ret;
+}
+
+//! Node 0 parents 1 and 2, 1 parents 3 and 2 parents 4. Skin 0 binds joints out of order with
+//! roots whose parents aren't joints, skin 1 roots its joints at its skeleton node.
+string createJson( const string &bufferJson, size_t bufferSize )
+{
+	return R"({
+		"asset": { "version": "2.0" },
+		"scene": 0,
+		"scenes": [ { "nodes": [ 0 ] } ],
+		"buffers": [ )" + bufferJson + R"( ],
+		"bufferViews": [
+			{ "buffer": 0, "byteLength": 72, "byteStride": 24, "target": 34962 },
+			{ "buffer": 0, "byteOffset": 72, "byteLength": 12, "target": 34963 },
+			{ "buffer": 0, "byteOffset": 84, "byteLength": )" + to_string( bufferSize - 84 ) + R"( }
+		],
+		"accessors": [
+			{ "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3" },
+			{ "bufferView": 0, "byteOffset": 12, "componentType": 5126, "count": 3, "type": "VEC3" },
+			{ "bufferView": 1, "componentType": 5123, "count": 6, "type": "SCALAR" },
+			{ "componentType": 5126, "count": 2, "type": "VEC3" },
+			{ "bufferView": 2, "componentType": 5126, "count": 2, "type": "SCALAR" },
+			{ "bufferView": 2, "byteOffset": 8, "componentType": 5126, "count": 2, "type": "VEC3" },
+			{ "bufferView": 2, "byteOffset": 32, "componentType": 5126, "count": 2, "type": "VEC4" }
+		],
+		"meshes": [ { "primitives": [
+			{ "attributes": { "POSITION": 0, "NORMAL": 1 }, "indices": 2 },
+			{ "attributes": { "POSITION": 0 }, "mode": 1 }
+		] } ],
+		"nodes": [
+			{ "name": "root", "children": [ 1, 2 ], "mesh": 0, "skin": 0 },
+			{ "name": "hip", "children": [ 3 ], "translation": [ 0, 1, 0 ] },
+			{ "name": "other", "children": [ 4 ] },
+			{ "name": "leg", "translation": [ 2, 0, 0 ] },
+			{ "name": "arm" }
+		],
+		"skins": [
+			{ "joints": [ 3, 1, 4 ] },
+			{ "joints": [ 3, 1, 0 ], "skeleton": 1 }
+		],
+		"animations": [
+			{
+				"samplers": [ { "input": 4, "output": 5 }, { "input": 4, "output": 6 } ],
+				"channels": [
+					{ "sampler": 0, "target": { "node": 1, "path": "translation" } },
+					{ "sampler": 1, "target": { "node": 3, "path": "rotation" } },
+					{ "sampler": 1, "target": { "node": 1, "path": "rotation" } },
+					{ "sampler": 0, "target": { "node": 3, "path": "weights" } }
+				]
+			},
+			{
+				"samplers": [ { "input": 4, "output": 5 } ],
+				"channels": [ { "sampler": 0, "target": { "node": 4, "path": "translation" } } ]
+			}
+		]
+	})";
+}
+
+FileRef createEmbeddedFile()
+{
+	auto bytes = createBuffer();
+	auto bufferJson = R"({ "byteLength": )" + to_string( bytes.size() ) + R"(, "uri": "data:application/octet-stream;base64,)" + toBase64( bytes.data(), bytes.size() ) + R"(" })";
+	auto json = createJson( bufferJson, bytes.size() );
+	auto buffer = ci::Buffer::create( json.size() );
+	memcpy( buffer->getData(), json.data(), json.size() );
+	return File::create( DataSourceBuffer::create( buffer ) );
+}
+
+void appendChunk( vector<uint8_t> *glb, uint32_t type, const vector<uint8_t> &data, uint8_t padding )
+{
+	auto paddedSize = static_cast<uint32_t>( ( data.size() + 3 ) & ~size_t( 3 ) );
+	append<uint32_t>( glb, { paddedSize, type } );
+	glb->insert( glb->end(), data.begin(), data.end() );
+	glb->resize( glb->size() + paddedSize - data.size(), padding );
+}
+
+//! A GLB v2 file with a JSON chunk, a chunk of an unknown type and a BIN chunk.
+vector<uint8_t> createGlb()
+{
+	auto bytes = createBuffer();
+	auto json = createJson( R"({ "byteLength": )" + to_string( bytes.size() ) + " }", bytes.size() );
+
+	vector<uint8_t> ret;
+	append<uint32_t>( &ret, { 0x46546C67, 2, 0 } );
+	appendChunk( &ret, 0x4E4F534A, vector<uint8_t>( json.begin(), json.end() ), ' ' );
+	appendChunk( &ret, 0x12345678, vector<uint8_t>( 8, 0xAB ), 0 );
+	appendChunk( &ret, 0x004E4942, bytes, 0 );
+	auto length = static_cast<uint32_t>( ret.size() );
+	memcpy( ret.data() + 8, &length, sizeof( length ) );
+	return ret;
+}
+
+FileRef loadGlb( const vector<uint8_t> &glb, bool mapBinary )
+{
+	auto path = fs::temp_directory_path() / "gltfUnitTests.glb";
+	{
+		ofstream out( path.string(), ios::binary | ios::trunc );
+		out.write( reinterpret_cast<const char*>( glb.data() ), glb.size() );
+	}
+	auto ret = File::create( loadFile( path ), File::Options().mapBinary( mapBinary ) );
+	fs::remove( path );
+	return ret;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "glTF 2.0 references and defaults" )
+{
+	auto file = createEmbeddedFile();
+	REQUIRE( file );
+
+	SECTION( "accessors" )
+	{
+		// byteStride moves from the bufferView to the accessors reading it.
+		auto &normals = file->getAccessorInfo( "1" );
+		REQUIRE( normals.bufferView == &file->getBufferViewInfo( "0" ) );
+		REQUIRE( normals.getByteStride() == 24 );
+		vector<float> values( 9 );
+		REQUIRE( normals.copyTo( values.data() ) );
+		REQUIRE( values == vector<float>( { 0, 0, 1,  0, 0, 1,  0, 0, 1 } ) );
+		REQUIRE( file->getAccessorInfo( "2" ).getByteStride() == 2 );
+
+		// without a bufferView, an accessor is all zeros.
+		auto &zeros = file->getAccessorInfo( "3" );
+		REQUIRE_FALSE( zeros.bufferView );
+		values.assign( 6, 1.0f );
+		REQUIRE( zeros.copyTo( values.data() ) );
+		REQUIRE( values == vector<float>( 6, 0.0f ) );
+	}
+
+	SECTION( "meshes" )
+	{
+		auto &mesh = file->getMeshInfo( "0" );
+		REQUIRE( mesh.primitives.size() == 2 );
+		REQUIRE( mesh.primitives[0].primitive == GL_TRIANGLES );
+		REQUIRE( mesh.primitives[0].indices == &file->getAccessorInfo( "2" ) );
+		REQUIRE( mesh.primitives[0].attributes.size() == 2 );
+		REQUIRE( mesh.primitives[1].primitive == GL_LINES );
+		REQUIRE_FALSE( mesh.primitives[1].indices );
+	}
+
+	SECTION( "nodes" )
+	{
+		auto &root = file->getNodeInfo( "0" );
+		REQUIRE( root.name == "root" );
+		REQUIRE( root.getNumChildren() == 2 );
+		REQUIRE( root.meshes.front() == &file->getMeshInfo( "0" ) );
+		REQUIRE( root.skin == &file->getSkinInfo( "0" ) );
+		REQUIRE( file->getNodeInfo( "3" ).getParent() == &file->getNodeInfo( "1" ) );
+		REQUIRE( file->getSceneInfo( "0" ).nodes.front() == &root );
+		// joints are named by their key.
+		REQUIRE( file->getNodeInfo( "3" ).jointName == "3" );
+	}
+
+	SECTION( "skin without inverseBindMatrices and with out of skin parents" )
+	{
+		auto &skin = file->getSkinInfo( "0" );
+		REQUIRE_FALSE( skin.inverseBindMatrices );
+		auto skeleton = skin.createSkeleton();
+		REQUIRE( skeleton );
+		auto &joints = skeleton->getJoints();
+		REQUIRE( joints.size() == 3 );
+		// leg's parent is hip, hip's and arm's parents aren't joints.
+		REQUIRE( joints[0].getParentId() == 1 );
+		REQUIRE( joints[1].getParentId() == 0xFF );
+		REQUIRE( joints[2].getParentId() == 0xFF );
+		REQUIRE( skeleton->getRoot() == &joints[1] );
+		REQUIRE( *skeleton->getJointName( joints[2] ) == "4" );
+		for( auto &joint : joints )
+			REQUIRE( joint.getInverseBindMatrix() == mat4() );
+
+		// leg comes first in the skin but is still derived from hip.
+		vector<mat4> local = { glm::translate( vec3( 2, 0, 0 ) ), glm::translate( vec3( 0, 1, 0 ) ), glm::translate( vec3( 0, 0, 3 ) ) };
+		vector<mat4> global;
+		skeleton->calcGlobalMatrices( local, &global );
+		REQUIRE( global.size() == 3 );
+		REQUIRE( global[0][3] == vec4( 2, 1, 0, 1 ) );
+		REQUIRE( global[1][3] == vec4( 0, 1, 0, 1 ) );
+		REQUIRE( global[2][3] == vec4( 0, 0, 3, 1 ) );
+	}
+
+	SECTION( "skin rooted at its skeleton" )
+	{
+		auto &skin = file->getSkinInfo( "1" );
+		REQUIRE( skin.skeleton == &file->getNodeInfo( "1" ) );
+		auto skeleton = skin.createSkeleton();
+		REQUIRE( skeleton );
+		auto &joints = skeleton->getJoints();
+		REQUIRE( joints[0].getParentId() == 1 );
+		// hip is the skeleton, so root is ignored as its parent.
+		REQUIRE( joints[1].getParentId() == 0xFF );
+		REQUIRE( joints[2].getParentId() == 0xFF );
+	}
+}
+
+TEST_CASE( "glTF 2.0 animations are split per target" )
+{
+	auto file = createEmbeddedFile();
+	REQUIRE( file );
+
+	auto &animations = file->getCollectionOf<Animation>();
+	REQUIRE( animations.size() == 3 );
+
+	// the first animation targets two nodes, weights aren't supported.
+	auto &hip = file->getAnimationInfo( "0:1" );
+	REQUIRE( hip.target == "1" );
+	REQUIRE( hip.channels.size() == 2 );
+	REQUIRE( hip.channels[0].target == &file->getNodeInfo( "1" ) );
+	REQUIRE( hip.channels[0].path == "translation" );
+	REQUIRE( hip.channels[1].path == "rotation" );
+	REQUIRE( hip.timeAccessor == &file->getAccessorInfo( "4" ) );
+	REQUIRE( hip.parameters[0].accessor == &file->getAccessorInfo( "5" ) );
+	REQUIRE( hip.parameters[1].accessor == &file->getAccessorInfo( "6" ) );
+
+	auto &leg = file->getAnimationInfo( "0:3" );
+	REQUIRE( leg.target == "3" );
+	REQUIRE( leg.channels.size() == 1 );
+	REQUIRE( leg.channels[0].path == "rotation" );
+
+	// a single target keeps the animation's key.
+	auto &arm = file->getAnimationInfo( "1" );
+	REQUIRE( arm.target == "4" );
+	REQUIRE( arm.channels.size() == 1 );
+}
+
+TEST_CASE( "GLB v2" )
+{
+	auto glb = createGlb();
+	auto expected = vector<float>( { 0, 0, 0,  1, 0, 0,  2, 0, 0 } );
+
+	SECTION( "JSON, unknown and BIN chunks" )
+	{
+		for( bool mapBinary : { false, true } ) {
+			auto file = loadGlb( glb, mapBinary );
+			REQUIRE( file );
+			REQUIRE( file->getBufferInfo( "0" ).getBuffer() );
+			REQUIRE( file->getBufferInfo( "0" ).getBuffer()->getSize() == createBuffer().size() );
+			vector<float> positions( 9 );
+			REQUIRE( file->getAccessorInfo( "0" ).copyTo( positions.data() ) );
+			REQUIRE( positions == expected );
+			vector<uint32_t> indices( 6 );
+			REQUIRE( file->getAccessorInfo( "2" ).copyTo( indices.data() ) );
+			REQUIRE( indices == vector<uint32_t>( { 0, 1, 2,  0, 2, 1 } ) );
+		}
+	}
+
+	SECTION( "truncated BIN chunk" )
+	{
+		// the header still claims the full length.
+		glb.resize( glb.size() - 8 );
+		for( bool mapBinary : { false, true } ) {
+			auto file = loadGlb( glb, mapBinary );
+			REQUIRE( file );
+			REQUIRE( file->getMeshInfo( "0" ).primitives.size() == 2 );
+			REQUIRE_FALSE( file->getBufferInfo( "0" ).getBuffer() );
+			vector<float> positions( 9 );
+			REQUIRE_FALSE( file->getAccessorInfo( "0" ).copyTo( positions.data() ) );
+		}
+	}
+
+	SECTION( "truncated JSON chunk" )
+	{
+		glb.resize( 100 );
+		REQUIRE_THROWS( loadGlb( glb, false ) );
+	}
+}
@@ -0,0 +1,177 @@
+#include "catch.hpp"
+
+#include <cstring>
+
+#include "cinder/Base64.h"
+#include "cinder/DataSource.h"
+
+#include "cinder/gltf/File.h"
+#include "cinder/gltf/InterleavedMesh.h"
+
+using namespace ci;
+using namespace ci::gltf;
+using namespace std;
+
+namespace {
+
+//! A glTF 2.0 file embedding one buffer: 4 vertices of POSITION, NORMAL and TEXCOORD_0 drawn by
+//! two primitives sharing their accessors, then 3 vertices with only POSITION for a third.
+FileRef createFile()
+{
+	const float positions[] = { 0, 0, 0,  1, 0, 0,  1, 1, 0,  1e6f, -1e6f, 0.5f };
+	const float normals[] = { 0, 0, 1,  -1, 0.5f, 0,  2, -2, 0,  0.25f, -0.25f, 1 };
+	const float texCoords[] = { 0, 1,  0.5f, -0.25f,  1.5f, 0.75f,  0.25f, 0 };
+	const float otherPositions[] = { 2, 0, 0,  3, 0, 0,  3, 1, 0 };
+	vector<uint8_t> bytes;
+	for( auto &floats : { make_pair( positions, sizeof( positions ) ), make_pair( normals, sizeof( normals ) ),
+						  make_pair( texCoords, sizeof( texCoords ) ), make_pair( otherPositions, sizeof( otherPositions ) ) } ) {
+		auto begin = reinterpret_cast<const uint8_t*>( floats.first );
+		bytes.insert( bytes.end(), begin, begin + floats.second );
+	}
+
+	string json = R"({
+		"asset": { "version": "2.0" },
+		"buffers": [ { "byteLength": )" + to_string( bytes.size() ) + R"(, "uri": "data:application/octet-stream;base64,)" + toBase64( bytes.data(), bytes.size() ) + R"(" } ],
+		"bufferViews": [ { "buffer": 0, "byteOffset": 0, "byteLength": )" + to_string( bytes.size() ) + R"( } ],
+		"accessors": [
+			{ "bufferView": 0, "byteOffset": 0, "componentType": 5126, "count": 4, "type": "VEC3" },
+			{ "bufferView": 0, "byteOffset": 48, "componentType": 5126, "count": 4, "type": "VEC3" },
+			{ "bufferView": 0, "byteOffset": 96, "componentType": 5126, "count": 4, "type": "VEC2" },
+			{ "bufferView": 0, "byteOffset": 128, "componentType": 5126, "count": 3, "type": "VEC3" }
+		],
+		"meshes": [ { "primitives": [
+			{ "attributes": { "POSITION": 0, "NORMAL": 1, "TEXCOORD_0": 2 } },
+			{ "attributes": { "POSITION": 0, "NORMAL": 1, "TEXCOORD_0": 2 } },
+			{ "attributes": { "POSITION": 3 } }
+		] } ]
+	})";
+	auto buffer = ci::Buffer::create( json.size() );
+	memcpy( buffer->getData(), json.data(), json.size() );
+	return File::create( DataSourceBuffer::create( buffer ) );
+}
+
+template<typename T>
+T read( const InterleavedMeshRef &mesh, uint32_t vertex, const InterleavedMesh::Attrib *attrib, uint32_t component )
+{
+	T ret;
+	auto data = reinterpret_cast<const uint8_t*>( mesh->getBuffer()->getData() );
+	memcpy( &ret, data + vertex * mesh->getLayout().stride + attrib->offset + component * sizeof( T ), sizeof( T ) );
+	return ret;
+}
+
+//! Interleaves POSITION as floats, NORMAL as normalized bytes and TEXCOORD_0 as normalized shorts.
+InterleavedMeshRef interleave( const Mesh &mesh, bool parallel )
+{
+	auto options = InterleavedMesh::Options()
+		.attrib( geom::POSITION )
+		.attrib( geom::NORMAL, Accessor::ComponentType::BYTE, true )
+		.attrib( geom::TEX_COORD_0, Accessor::ComponentType::UNSIGNED_SHORT, true )
+		.alignment( 4 )
+		.parallel( parallel );
+	return InterleavedMesh::create( &mesh, options );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "InterleavedMesh" )
+{
+	auto file = createFile();
+	REQUIRE( file );
+	auto &mesh = file->getMeshInfo( "0" );
+	REQUIRE( mesh.primitives.size() == 3 );
+
+	SECTION( "attributes are laid out in order, each aligned" )
+	{
+		auto interleaved = interleave( mesh, false );
+		REQUIRE( interleaved );
+		auto &layout = interleaved->getLayout();
+		REQUIRE( layout.attribs.size() == 3 );
+		auto position = layout.find( geom::POSITION ), normal = layout.find( geom::NORMAL ), texCoord = layout.find( geom::TEX_COORD_0 );
+		REQUIRE( position->offset == 0 );
+		REQUIRE( position->dims == 3 );
+		// 3 bytes of normal are padded to 4.
+		REQUIRE( normal->offset == 12 );
+		REQUIRE( normal->dims == 3 );
+		REQUIRE( texCoord->offset == 16 );
+		REQUIRE( texCoord->dims == 2 );
+		REQUIRE( layout.stride == 20 );
+		// only floats have a geom::DataType.
+		REQUIRE( layout.getBufferLayout().getAttribs().size() == 1 );
+	}
+
+	SECTION( "primitives with the same accessors share their vertices" )
+	{
+		auto interleaved = interleave( mesh, false );
+		REQUIRE( interleaved );
+		auto &layout = interleaved->getLayout();
+		auto &ranges = interleaved->getRanges();
+		REQUIRE( ranges.size() == 3 );
+		REQUIRE( ranges[0].firstVertex == 0 );
+		REQUIRE( ranges[0].numVertices == 4 );
+		REQUIRE( ranges[1].firstVertex == 0 );
+		REQUIRE( ranges[1].numVertices == 4 );
+		REQUIRE( ranges[2].firstVertex == 4 );
+		REQUIRE( ranges[2].numVertices == 3 );
+		REQUIRE( interleaved->getNumVertices() == 7 );
+		REQUIRE( interleaved->getBuffer()->getSize() == 7 * layout.stride );
+	}
+
+	SECTION( "floats are copied and normalized integers quantized, clamped to their range" )
+	{
+		auto interleaved = interleave( mesh, false );
+		REQUIRE( interleaved );
+		auto &layout = interleaved->getLayout();
+		auto position = layout.find( geom::POSITION ), normal = layout.find( geom::NORMAL ), texCoord = layout.find( geom::TEX_COORD_0 );
+		REQUIRE( read<float>( interleaved, 1, position, 0 ) == 1.0f );
+		REQUIRE( read<float>( interleaved, 3, position, 2 ) == 0.5f );
+		REQUIRE( read<float>( interleaved, 6, position, 1 ) == 1.0f );
+
+		REQUIRE( read<int8_t>( interleaved, 0, normal, 2 ) == 127 );
+		REQUIRE( read<int8_t>( interleaved, 1, normal, 0 ) == -127 );
+		REQUIRE( read<int8_t>( interleaved, 1, normal, 1 ) == 64 );
+		REQUIRE( read<int8_t>( interleaved, 2, normal, 0 ) == 127 );
+		REQUIRE( read<int8_t>( interleaved, 2, normal, 1 ) == -127 );
+		REQUIRE( read<int8_t>( interleaved, 3, normal, 0 ) == 32 );
+		REQUIRE( read<int8_t>( interleaved, 3, normal, 1 ) == -32 );
+
+		REQUIRE( read<uint16_t>( interleaved, 0, texCoord, 1 ) == 65535 );
+		REQUIRE( read<uint16_t>( interleaved, 1, texCoord, 0 ) == 32768 );
+		REQUIRE( read<uint16_t>( interleaved, 1, texCoord, 1 ) == 0 );
+		REQUIRE( read<uint16_t>( interleaved, 2, texCoord, 0 ) == 65535 );
+		REQUIRE( read<uint16_t>( interleaved, 2, texCoord, 1 ) == 49151 );
+	}
+
+	SECTION( "attributes a primitive doesn't have are zeros" )
+	{
+		auto interleaved = interleave( mesh, false );
+		REQUIRE( interleaved );
+		auto &layout = interleaved->getLayout();
+		auto normal = layout.find( geom::NORMAL ), texCoord = layout.find( geom::TEX_COORD_0 );
+		for( uint32_t vertex = 4; vertex < 7; vertex++ ) {
+			for( uint32_t component = 0; component < 3; component++ )
+				REQUIRE( read<int8_t>( interleaved, vertex, normal, component ) == 0 );
+			for( uint32_t component = 0; component < 2; component++ )
+				REQUIRE( read<uint16_t>( interleaved, vertex, texCoord, component ) == 0 );
+		}
+	}
+
+	SECTION( "packing in parallel writes the same vertices" )
+	{
+		auto serial = interleave( mesh, false ), parallel = interleave( mesh, true );
+		REQUIRE( parallel );
+		REQUIRE( parallel->getBuffer()->getSize() == serial->getBuffer()->getSize() );
+		REQUIRE( memcmp( parallel->getBuffer()->getData(), serial->getBuffer()->getData(), serial->getBuffer()->getSize() ) == 0 );
+	}
+
+	SECTION( "integers that aren't normalized are clamped to their range" )
+	{
+		auto options = InterleavedMesh::Options().attrib( geom::POSITION, Accessor::ComponentType::SHORT ).parallel( false );
+		auto interleaved = InterleavedMesh::create( &mesh, options );
+		REQUIRE( interleaved );
+		auto position = interleaved->getLayout().find( geom::POSITION );
+		REQUIRE( read<int16_t>( interleaved, 1, position, 0 ) == 1 );
+		REQUIRE( read<int16_t>( interleaved, 3, position, 0 ) == 32767 );
+		REQUIRE( read<int16_t>( interleaved, 3, position, 1 ) == -32768 );
+		REQUIRE( read<int16_t>( interleaved, 3, position, 2 ) == 0 );
+	}
+}
@@ -0,0 +1,190 @@
+#include "catch.hpp"
+
+#include "cinder/DataSource.h"
+
+#include "cinder/gltf/File.h"
+#include "cinder/gltf/JsonStreamReader.h"
+
+using namespace ci;
+using namespace ci::gltf;
+using namespace std;
+
+namespace {
+
+Json::Value readStreamed( const string &json )
+{
+	Json::Value ret;
+	JsonStreamReader reader( json.data(), json.data() + json.size() );
+	reader.readValue( &ret );
+	return ret;
+}
+
+string readString( const string &json )
+{
+	return readStreamed( json ).asString();
+}
+
+//! Returns the text of every member value of the object in /a json, skipped rather than read.
+map<string, string> skipMembers( const string &json )
+{
+	map<string, string> ret;
+	JsonStreamReader reader( json.data(), json.data() + json.size() );
+	REQUIRE( reader.beginObject() );
+	string name;
+	while( reader.nextMember( &name ) ) {
+		auto range = reader.skipValue();
+		ret[name] = string( range.begin, range.end );
+	}
+	return ret;
+}
+
+const char *kSampleFiles[] = {
+	"/BasicLoading/assets/Duck/glTF/Duck.gltf",
+	"/BasicLoading/assets/Duck/glTF-Embedded/Duck.gltf",
+	"/BasicLoading/assets/Duck/glTF-MaterialsCommon/Duck.gltf",
+	"/BasicAnimation/assets/glTF/BoxAnimated.gltf",
+	"/SkeletalAnimation/assets/monster/glTF-Embedded/Monster.gltf",
+	"/SkeletalAnimation/assets/CesiumMan/glTF/CesiumMan.gltf"
+};
+
+} // anonymous namespace
+
+TEST_CASE( "JsonStreamReader" )
+{
+	SECTION( "escapes" )
+	{
+		REQUIRE( readString( R"("a\"b\\c\/d")" ) == "a\"b\\c/d" );
+		REQUIRE( readString( R"("\b\f\n\r\t")" ) == "\b\f\n\r\t" );
+		REQUIRE( readString( R"("no escapes")" ) == "no escapes" );
+		REQUIRE_THROWS( readString( R"("\q")" ) );
+		REQUIRE_THROWS( readString( R"("unterminated)" ) );
+	}
+
+	SECTION( "unicode escapes and surrogates" )
+	{
+		REQUIRE( readString( R"("\u0041")" ) == "A" );
+		REQUIRE( readString( R"("\u00e9\u00E9")" ) == "\xC3\xA9\xC3\xA9" );
+		REQUIRE( readString( R"("\u20AC")" ) == "\xE2\x82\xAC" );
+		// U+1F600 as a surrogate pair.
+		REQUIRE( readString( R"("\uD83D\uDE00")" ) == "\xF0\x9F\x98\x80" );
+		// raw UTF-8 passes through untouched.
+		REQUIRE( readString( "\"\xC3\xA9\"" ) == "\xC3\xA9" );
+		REQUIRE_THROWS( readString( R"("\u00g1")" ) );
+		REQUIRE_THROWS( readString( R"("\u12")" ) );
+		REQUIRE_THROWS( readString( R"("\uD83D\u0041")" ) );
+	}
+
+	SECTION( "comments" )
+	{
+		auto json = "// leading\n{ /* before */ \"a\" : /* between */ [ 1, // trailing\n 2 ] }";
+		auto value = readStreamed( json );
+		REQUIRE( value["a"].size() == 2 );
+		REQUIRE( value["a"][1].asInt() == 2 );
+
+		auto members = skipMembers( "{ \"a\" : /* x */ [ 1, /* ] */ 2 ], \"b\" : 3 }" );
+		REQUIRE( members["a"] == "[ 1, /* ] */ 2 ]" );
+		REQUIRE( members["b"] == "3" );
+	}
+
+	SECTION( "skipValue ranges" )
+	{
+		auto members = skipMembers( R"({ "s" : "x}\"]", "a" : [1, {"b": "]}"}], "o" : {}, "n" : -1.5e+3, "t" : true, "f" : false, "z" : null })" );
+		REQUIRE( members.size() == 7 );
+		REQUIRE( members["s"] == R"("x}\"]")" );
+		REQUIRE( members["a"] == R"([1, {"b": "]}"}])" );
+		REQUIRE( members["o"] == "{}" );
+		REQUIRE( members["n"] == "-1.5e+3" );
+		REQUIRE( members["t"] == "true" );
+		REQUIRE( members["f"] == "false" );
+		REQUIRE( members["z"] == "null" );
+	}
+
+	SECTION( "numbers stop at nul and non-ASCII bytes" )
+	{
+		string withNul( "12\0\0", 4 );
+		JsonStreamReader nulReader( withNul.data(), withNul.data() + withNul.size() );
+		REQUIRE( nulReader.skipValue().size() == 2 );
+
+		string withHighByte( "34\xE9" );
+		JsonStreamReader highReader( withHighByte.data(), withHighByte.data() + withHighByte.size() );
+		REQUIRE( highReader.skipValue().size() == 2 );
+
+		// the number ends at the reader's end, not at the end of the string.
+		string number( "-7.25e1x" );
+		JsonStreamReader endReader( number.data(), number.data() + 7 );
+		Json::Value value;
+		endReader.readValue( &value );
+		REQUIRE( value.asDouble() == -72.5 );
+
+		string invalid( "x" );
+		JsonStreamReader invalidReader( invalid.data(), invalid.data() + invalid.size() );
+		REQUIRE_THROWS( invalidReader.skipValue() );
+	}
+
+	SECTION( "unterminated containers" )
+	{
+		REQUIRE_THROWS( readStreamed( "[1, 2" ) );
+		string json( "{\"a\": [1}" );
+		JsonStreamReader reader( json.data(), json.data() + json.size() );
+		REQUIRE_THROWS( reader.skipValue() );
+	}
+}
+
+TEST_CASE( "JsonStreamReader matches Json::Reader on the samples" )
+{
+	for( auto sampleFile : kSampleFiles ) {
+		auto json = loadString( loadFile( string( GLTF_SAMPLES_PATH ) + sampleFile ) );
+
+		Json::Features features;
+		features.allowComments_ = true;
+		features.strictRoot_ = true;
+		Json::Reader reader( features );
+		Json::Value tree;
+		REQUIRE( reader.parse( json, tree ) );
+
+		INFO( sampleFile );
+		REQUIRE( readStreamed( json ) == tree );
+	}
+}
+
+TEST_CASE( "Streamed and tree Files match on the samples" )
+{
+	for( auto sampleFile : kSampleFiles ) {
+		auto path = string( GLTF_SAMPLES_PATH ) + sampleFile;
+		auto tree = File::create( loadFile( path ) );
+		auto streamed = File::create( loadFile( path ), File::Options().streamJson() );
+		REQUIRE( tree );
+		REQUIRE( streamed );
+
+		INFO( sampleFile );
+		auto &treeAccessors = tree->getCollectionOf<Accessor>();
+		auto &streamedAccessors = streamed->getCollectionOf<Accessor>();
+		REQUIRE( treeAccessors.size() == streamedAccessors.size() );
+		for( auto &accessor : treeAccessors ) {
+			auto other = streamedAccessors.get( accessor.key );
+			REQUIRE( other );
+			REQUIRE( other->count == accessor.count );
+			REQUIRE( other->byteOffset == accessor.byteOffset );
+			REQUIRE( other->componentType == accessor.componentType );
+			REQUIRE( other->min == accessor.min );
+			REQUIRE( other->max == accessor.max );
+			REQUIRE( ( other->bufferView ? other->bufferView->key.str() : "" ) == ( accessor.bufferView ? accessor.bufferView->key.str() : "" ) );
+		}
+
+		auto &treeNodes = tree->getCollectionOf<Node>();
+		auto &streamedNodes = streamed->getCollectionOf<Node>();
+		REQUIRE( treeNodes.size() == streamedNodes.size() );
+		for( auto &node : treeNodes ) {
+			auto other = streamedNodes.get( node.key );
+			REQUIRE( other );
+			REQUIRE( other->getNumChildren() == node.getNumChildren() );
+			REQUIRE( other->meshes.size() == node.meshes.size() );
+			REQUIRE( other->transformMatrix == node.transformMatrix );
+			REQUIRE( other->translation == node.translation );
+		}
+
+		REQUIRE( tree->getCollectionOf<Mesh>().size() == streamed->getCollectionOf<Mesh>().size() );
+		REQUIRE( tree->getCollectionOf<Animation>().size() == streamed->getCollectionOf<Animation>().size() );
+		REQUIRE( tree->getCollectionOf<Material>().size() == streamed->getCollectionOf<Material>().size() );
+	}
+}
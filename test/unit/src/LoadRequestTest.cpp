@@ -0,0 +1,71 @@
+#include "catch.hpp"
+
+#include <cstring>
+
+#include "cinder/DataSource.h"
+
+#include "cinder/gltf/BatchLoader.h"
+#include "cinder/gltf/File.h"
+
+using namespace ci;
+using namespace ci::gltf;
+using namespace std;
+
+namespace {
+
+DataSourceRef createSource( const string &json )
+{
+	auto buffer = ci::Buffer::create( json.size() );
+	memcpy( buffer->getData(), json.data(), json.size() );
+	return DataSourceBuffer::create( buffer );
+}
+
+const char *kValidJson = R"({ "asset": { "version": "2.0" }, "nodes": [ { "name": "root" } ] })";
+// a missing closing brace, and a root that isn't an object.
+const char *kMalformedJson[] = {
+	R"({ "asset": { "version": "2.0" }, "nodes": [ { "name": "root" } ] )",
+	R"([ 1, 2 ])"
+};
+
+} // anonymous namespace
+
+TEST_CASE( "Malformed JSON fails the load" )
+{
+	SECTION( "synchronous" )
+	{
+		for( bool streamed : { false, true } ) {
+			auto options = File::Options().streamJson( streamed );
+			REQUIRE( File::create( createSource( kValidJson ), options ) );
+			for( auto json : kMalformedJson )
+				REQUIRE_THROWS( File::create( createSource( json ), options ) );
+		}
+	}
+
+	SECTION( "async" )
+	{
+		for( bool streamed : { false, true } ) {
+			auto options = File::Options().streamJson( streamed );
+			auto valid = File::createAsync( createSource( kValidJson ), options );
+			REQUIRE( valid->getFile() );
+			REQUIRE( valid->getPhase() == LoadRequest::Phase::DONE );
+			for( auto json : kMalformedJson ) {
+				auto request = File::createAsync( createSource( json ), options );
+				REQUIRE_FALSE( request->getFile() );
+				REQUIRE( request->getPhase() == LoadRequest::Phase::FAILED );
+			}
+		}
+	}
+
+	SECTION( "batch" )
+	{
+		for( bool streamed : { false, true } ) {
+			auto sources = vector<DataSourceRef>{ createSource( kMalformedJson[0] ), createSource( kValidJson ), createSource( kMalformedJson[1] ) };
+			auto loader = BatchLoader::create( sources, File::Options().streamJson( streamed ) );
+			BatchLoader::Result result;
+			while( loader->next( &result ) )
+				REQUIRE( bool( result.file ) == ( result.index == 1 ) );
+			REQUIRE( loader->getStats().numLoaded == 1 );
+			REQUIRE( loader->getStats().numFailed == 2 );
+		}
+	}
+}
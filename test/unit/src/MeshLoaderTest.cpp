@@ -0,0 +1,240 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "cinder/Base64.h"
+#include "cinder/DataSource.h"
+
+#include "cinder/gltf/File.h"
+#include "cinder/gltf/MeshLoader.h"
+
+using namespace ci;
+using namespace ci::gltf;
+using namespace std;
+
+namespace {
+
+//! Records what a MeshLoader hands over.
+class RecordingTarget : public geom::Target {
+public:
+	struct Attrib {
+		uint8_t			dims{0};
+		size_t			strideBytes{0};
+		const float		*data{nullptr};
+		size_t			count{0};
+		//! The values, copied tightly packed.
+		vector<float>	values;
+	};
+
+	uint8_t	getAttribDims( geom::Attrib attr ) const override { return 0; }
+	void	copyAttrib( geom::Attrib attr, uint8_t dims, size_t strideBytes, const float *srcData, size_t count ) override
+	{
+		auto &recorded = attribs[attr];
+		recorded.dims = dims;
+		recorded.strideBytes = strideBytes;
+		recorded.data = srcData;
+		recorded.count = count;
+		auto stride = strideBytes ? strideBytes : dims * sizeof( float );
+		recorded.values.resize( count * dims );
+		for( size_t i = 0; i < count; i++ )
+			memcpy( recorded.values.data() + i * dims, reinterpret_cast<const uint8_t*>( srcData ) + i * stride, dims * sizeof( float ) );
+	}
+	void	copyIndices( geom::Primitive primitive, const uint32_t *source, size_t numIndices, uint8_t requiredBytesPerIndex ) override
+	{
+		indices.assign( source, source + numIndices );
+		bytesPerIndex = requiredBytesPerIndex;
+	}
+
+	map<geom::Attrib, Attrib>	attribs;
+	vector<uint32_t>			indices;
+	uint8_t						bytesPerIndex{0};
+};
+
+const uint32_t kNumVertices = 300;
+//! Mesh 2's indices use vertex ( v * kScramble ) % kNumVertices where mesh 0's use v.
+const uint32_t kScramble = 7;
+
+//! kNumVertices vertices of POSITION and NORMAL interleaved at a stride of 24, then UNSIGNED_SHORT
+//! indices of a fan of triangles reaching the last vertex. Mesh 1 uses the first 256 vertices.
+//! Mesh 2 draws the fan through scrambled indices with UNSIGNED_BYTE JOINTS_0, float WEIGHTS_0
+//! and a TEXCOORD_0 with too few values.
+FileRef createFile()
+{
+	vector<uint8_t> bytes;
+	auto append = [&]( const void *data, size_t size ) {
+		auto begin = reinterpret_cast<const uint8_t*>( data );
+		bytes.insert( bytes.end(), begin, begin + size );
+	};
+	for( uint32_t i = 0; i < kNumVertices; i++ ) {
+		const float vertex[] = { float( i ), float( 2 * i ), 0,  0, 0, float( i % 2 ? 1 : -1 ) };
+		append( vertex, sizeof( vertex ) );
+	}
+	for( uint16_t i = 1; i + 1 < kNumVertices; i++ ) {
+		const uint16_t triangle[] = { 0, i, uint16_t( i + 1 ) };
+		append( triangle, sizeof( triangle ) );
+	}
+	for( uint16_t i = 1; i + 1 < kNumVertices; i++ ) {
+		const uint16_t triangle[] = { 0, uint16_t( i * kScramble % kNumVertices ), uint16_t( ( i + 1 ) * kScramble % kNumVertices ) };
+		append( triangle, sizeof( triangle ) );
+	}
+	for( uint32_t i = 0; i < kNumVertices; i++ ) {
+		const uint8_t joints[] = { uint8_t( i & 0xFF ), uint8_t( i >> 8 ), 0, 0 };
+		append( joints, sizeof( joints ) );
+	}
+	for( uint32_t i = 0; i < kNumVertices; i++ ) {
+		const float weights[] = { float( i ), 0, 0, 1 };
+		append( weights, sizeof( weights ) );
+	}
+	const float texCoords[20] = {};
+	append( texCoords, sizeof( texCoords ) );
+
+	auto verticesLength = kNumVertices * 24;
+	auto indicesLength = ( kNumVertices - 2 ) * 3 * sizeof( uint16_t );
+	auto jointsOffset = verticesLength + 2 * indicesLength;
+	auto weightsOffset = jointsOffset + kNumVertices * 4;
+	auto texCoordsOffset = weightsOffset + kNumVertices * 16;
+	string json = R"({
+		"asset": { "version": "2.0" },
+		"buffers": [ { "byteLength": )" + to_string( bytes.size() ) + R"(, "uri": "data:application/octet-stream;base64,)" + toBase64( bytes.data(), bytes.size() ) + R"(" } ],
+		"bufferViews": [
+			{ "buffer": 0, "byteLength": )" + to_string( verticesLength ) + R"(, "byteStride": 24, "target": 34962 },
+			{ "buffer": 0, "byteOffset": )" + to_string( verticesLength ) + R"(, "byteLength": )" + to_string( indicesLength ) + R"(, "target": 34963 },
+			{ "buffer": 0, "byteOffset": )" + to_string( verticesLength + indicesLength ) + R"(, "byteLength": )" + to_string( indicesLength ) + R"(, "target": 34963 },
+			{ "buffer": 0, "byteOffset": )" + to_string( jointsOffset ) + R"(, "byteLength": )" + to_string( texCoordsOffset - jointsOffset + sizeof( texCoords ) ) + R"( }
+		],
+		"accessors": [
+			{ "bufferView": 0, "componentType": 5126, "count": )" + to_string( kNumVertices ) + R"(, "type": "VEC3" },
+			{ "bufferView": 0, "byteOffset": 12, "componentType": 5126, "count": )" + to_string( kNumVertices ) + R"(, "type": "VEC3" },
+			{ "bufferView": 1, "componentType": 5123, "count": )" + to_string( ( kNumVertices - 2 ) * 3 ) + R"(, "type": "SCALAR" },
+			{ "bufferView": 0, "componentType": 5126, "count": 256, "type": "VEC3" },
+			{ "bufferView": 1, "componentType": 5123, "count": 762, "type": "SCALAR" },
+			{ "bufferView": 2, "componentType": 5123, "count": )" + to_string( ( kNumVertices - 2 ) * 3 ) + R"(, "type": "SCALAR" },
+			{ "bufferView": 3, "componentType": 5121, "count": )" + to_string( kNumVertices ) + R"(, "type": "VEC4" },
+			{ "bufferView": 3, "byteOffset": )" + to_string( weightsOffset - jointsOffset ) + R"(, "componentType": 5126, "count": )" + to_string( kNumVertices ) + R"(, "type": "VEC4" },
+			{ "bufferView": 3, "byteOffset": )" + to_string( texCoordsOffset - jointsOffset ) + R"(, "componentType": 5126, "count": 10, "type": "VEC2" }
+		],
+		"meshes": [
+			{ "primitives": [ { "attributes": { "POSITION": 0, "NORMAL": 1 }, "indices": 2 } ] },
+			{ "primitives": [ { "attributes": { "POSITION": 3 }, "indices": 4 } ] },
+			{ "primitives": [ { "attributes": { "POSITION": 0, "JOINTS_0": 6, "WEIGHTS_0": 7, "TEXCOORD_0": 8 }, "indices": 5 } ] }
+		]
+	})";
+	auto buffer = ci::Buffer::create( json.size() );
+	memcpy( buffer->getData(), json.data(), json.size() );
+	return File::create( DataSourceBuffer::create( buffer ) );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "MeshLoader interleaved attributes and 16-bit indices" )
+{
+	auto file = createFile();
+	REQUIRE( file );
+	auto &accessors = file->getCollectionOf<Accessor>();
+
+	SECTION( "more than 256 vertices" )
+	{
+		MeshLoader loader( &file->getMeshInfo( "0" ) );
+		REQUIRE( loader.getNumVertices() == kNumVertices );
+		REQUIRE( loader.getNumIndices() == ( kNumVertices - 2 ) * 3 );
+		REQUIRE( loader.getAttribDims( geom::POSITION ) == 3 );
+		REQUIRE( loader.getAttribDims( geom::NORMAL ) == 3 );
+
+		RecordingTarget target;
+		loader.loadInto( &target, { geom::POSITION, geom::NORMAL } );
+
+		// the strided floats are read in place rather than copied out first.
+		auto &positions = target.attribs[geom::POSITION];
+		REQUIRE( positions.data == accessors.get( "0" )->getDataPtr() );
+		REQUIRE( positions.strideBytes == 24 );
+		REQUIRE( positions.count == kNumVertices );
+		auto &normals = target.attribs[geom::NORMAL];
+		REQUIRE( normals.data == accessors.get( "1" )->getDataPtr() );
+		REQUIRE( normals.strideBytes == 24 );
+		for( uint32_t i = 0; i < kNumVertices; i++ ) {
+			REQUIRE( positions.values[i * 3] == float( i ) );
+			REQUIRE( positions.values[i * 3 + 1] == float( 2 * i ) );
+			REQUIRE( normals.values[i * 3 + 2] == ( i % 2 ? 1.0f : -1.0f ) );
+		}
+
+		// vertex 299 doesn't fit a byte.
+		REQUIRE( target.bytesPerIndex == 2 );
+		REQUIRE( target.indices.size() == loader.getNumIndices() );
+		REQUIRE( *max_element( target.indices.begin(), target.indices.end() ) == kNumVertices - 1 );
+		for( uint32_t i = 0; i + 2 < kNumVertices; i++ ) {
+			REQUIRE( target.indices[i * 3] == 0 );
+			REQUIRE( target.indices[i * 3 + 1] == i + 1 );
+			REQUIRE( target.indices[i * 3 + 2] == i + 2 );
+		}
+	}
+
+	SECTION( "256 vertices fit bytes" )
+	{
+		MeshLoader loader( &file->getMeshInfo( "1" ) );
+		REQUIRE( loader.getNumVertices() == 256 );
+		RecordingTarget target;
+		loader.loadInto( &target, { geom::POSITION } );
+		REQUIRE( target.bytesPerIndex == 1 );
+		REQUIRE( *max_element( target.indices.begin(), target.indices.end() ) == 255 );
+		REQUIRE( target.attribs[geom::POSITION].strideBytes == 24 );
+	}
+}
+
+TEST_CASE( "MeshLoader vertex fetch reordering" )
+{
+	auto file = createFile();
+	REQUIRE( file );
+	auto &mesh = file->getMeshInfo( "2" );
+	vector<uint32_t> original( mesh.primitives.front().indices->count );
+	REQUIRE( mesh.primitives.front().indices->copyTo( original.data() ) );
+
+	MeshLoader loader( &mesh );
+	loader.reorderForVertexFetch();
+	RecordingTarget target;
+	loader.loadInto( &target, { geom::POSITION, geom::BONE_INDEX, geom::BONE_WEIGHT, geom::TEX_COORD_0 } );
+	REQUIRE( target.indices.size() == original.size() );
+
+	SECTION( "first use order" )
+	{
+		// the scrambled fan first uses 0, 7, 14 and so on.
+		uint32_t next = 0;
+		for( auto index : target.indices ) {
+			REQUIRE( index <= next );
+			next = std::max( next, index + 1 );
+		}
+		REQUIRE( next == kNumVertices );
+		auto &positions = target.attribs[geom::POSITION];
+		for( uint32_t i = 0; i < kNumVertices; i++ )
+			REQUIRE( positions.values[i * 3] == float( i * kScramble % kNumVertices ) );
+	}
+
+	SECTION( "the same triangles" )
+	{
+		auto &positions = target.attribs[geom::POSITION];
+		REQUIRE( positions.strideBytes == 0 );
+		REQUIRE( positions.count == kNumVertices );
+		for( size_t i = 0; i < original.size(); i++ ) {
+			REQUIRE( positions.values[target.indices[i] * 3] == float( original[i] ) );
+			REQUIRE( positions.values[target.indices[i] * 3 + 1] == float( 2 * original[i] ) );
+		}
+	}
+
+	SECTION( "skin attributes follow, mismatched counts are skipped" )
+	{
+		auto &positions = target.attribs[geom::POSITION];
+		auto &joints = target.attribs[geom::BONE_INDEX];
+		auto &weights = target.attribs[geom::BONE_WEIGHT];
+		REQUIRE( joints.count == kNumVertices );
+		REQUIRE( weights.count == kNumVertices );
+		for( uint32_t i = 0; i < kNumVertices; i++ ) {
+			auto vertex = static_cast<uint32_t>( positions.values[i * 3] );
+			REQUIRE( joints.values[i * 4] == float( vertex & 0xFF ) );
+			REQUIRE( joints.values[i * 4 + 1] == float( vertex >> 8 ) );
+			REQUIRE( weights.values[i * 4] == float( vertex ) );
+			REQUIRE( weights.values[i * 4 + 3] == 1.0f );
+		}
+		REQUIRE( target.attribs.count( geom::TEX_COORD_0 ) == 0 );
+	}
+}
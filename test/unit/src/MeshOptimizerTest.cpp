@@ -0,0 +1,133 @@
+#include "catch.hpp"
+
+#include <algorithm>
+
+#include "cinder/DataSource.h"
+
+#include "cinder/gltf/File.h"
+#include "cinder/gltf/MeshOptimizer.h"
+
+using namespace ci;
+using namespace ci::gltf;
+using namespace std;
+
+namespace {
+
+//! The triangle list of the Duck sample and its vec3 positions.
+struct TriangleList {
+	vector<uint32_t>	indices;
+	vector<float>		positions;
+	size_t				numVertices{0};
+};
+
+TriangleList loadDuck()
+{
+	TriangleList ret;
+	auto file = File::create( loadFile( GLTF_SAMPLES_PATH "/BasicLoading/assets/Duck/glTF/Duck.gltf" ) );
+	if( ! file )
+		return ret;
+	auto &primitive = file->getMeshInfo( "LOD3spShape-lib" ).primitives.front();
+	for( auto &attribute : primitive.attributes ) {
+		if( attribute.attrib != geom::POSITION )
+			continue;
+		ret.numVertices = attribute.accessor->count;
+		ret.positions.resize( ret.numVertices * 3 );
+		attribute.accessor->copyTo( ret.positions.data() );
+	}
+	ret.indices.resize( primitive.indices->count );
+	primitive.indices->copyTo( ret.indices.data() );
+	return ret;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "MeshOptimizer vertex cache" )
+{
+	auto duck = loadDuck();
+	REQUIRE( duck.indices.size() == 4212 * 3 );
+	REQUIRE( duck.numVertices == 2399 );
+
+	auto exported = analyzeVertexCache( duck.indices, duck.numVertices );
+	REQUIRE( exported.numTriangles == 4212 );
+	REQUIRE( exported.numVertices == 2399 );
+	// as exported, ACMR 1.200 and ATVR 2.107.
+	REQUIRE( exported.numTransforms == 5055 );
+
+	optimizeVertexCache( duck.indices.data(), duck.indices.size() );
+	auto optimized = analyzeVertexCache( duck.indices, duck.numVertices );
+	REQUIRE( optimized.numTriangles == exported.numTriangles );
+	REQUIRE( optimized.numVertices == exported.numVertices );
+	// Tipsify measured ACMR 0.718 and ATVR 1.261, the bound leaves room for tuning.
+	REQUIRE( optimized.getAcmr() < exported.getAcmr() );
+	REQUIRE( optimized.getAcmr() < 0.75f );
+	REQUIRE( optimized.getAtvr() < 1.35f );
+}
+
+TEST_CASE( "MeshOptimizer overdraw" )
+{
+	auto duck = loadDuck();
+	REQUIRE( duck.indices.size() == 4212 * 3 );
+	const size_t stride = 3 * sizeof( float );
+	const float threshold = 1.05f;
+
+	optimizeVertexCache( duck.indices.data(), duck.indices.size() );
+	auto tipsifyCache = analyzeVertexCache( duck.indices, duck.numVertices );
+	auto tipsifyOverdraw = analyzeOverdraw( duck.indices.data(), duck.indices.size(), duck.positions.data(), duck.numVertices, stride );
+	REQUIRE( tipsifyOverdraw.numPixelsCovered > 0 );
+
+	optimizeOverdraw( duck.indices.data(), duck.indices.size(), duck.positions.data(), duck.numVertices, stride, threshold );
+	auto cache = analyzeVertexCache( duck.indices, duck.numVertices );
+	auto overdraw = analyzeOverdraw( duck.indices.data(), duck.indices.size(), duck.positions.data(), duck.numVertices, stride );
+
+	// the same pixels are covered, fewer are shaded: measured 1.084 after Tipsify, 1.033 after.
+	REQUIRE( overdraw.numPixelsCovered == tipsifyOverdraw.numPixelsCovered );
+	REQUIRE( overdraw.getOverdraw() < tipsifyOverdraw.getOverdraw() );
+	// measured ACMR 0.718 after Tipsify, 0.752 after.
+	REQUIRE( cache.numTriangles == tipsifyCache.numTriangles );
+	REQUIRE( float( cache.numTransforms ) <= float( tipsifyCache.numTransforms ) * threshold );
+}
+
+TEST_CASE( "MeshOptimizer vertex fetch" )
+{
+	SECTION( "first use order" )
+	{
+		// vertex 2 and 5 aren't used, 7 is out of range and left alone.
+		vector<uint32_t> indices = { 4, 1, 4,  3, 0, 1,  7, 0, 3 };
+		auto vertexOrder = optimizeVertexFetch( indices.data(), indices.size(), 6 );
+		REQUIRE( vertexOrder == vector<uint32_t>{ 4, 1, 3, 0, 2, 5 } );
+		REQUIRE( indices == vector<uint32_t>{ 0, 1, 0,  2, 3, 1,  7, 3, 2 } );
+	}
+
+	SECTION( "remapped vertices draw the same triangles" )
+	{
+		auto duck = loadDuck();
+		REQUIRE( duck.indices.size() == 4212 * 3 );
+		optimizeVertexCache( duck.indices.data(), duck.indices.size() );
+		auto indices = duck.indices;
+		auto vertexOrder = optimizeVertexFetch( indices.data(), indices.size(), duck.numVertices );
+		REQUIRE( vertexOrder.size() == duck.numVertices );
+
+		// every new vertex is used after the ones before it.
+		uint32_t next = 0;
+		for( auto index : indices ) {
+			REQUIRE( index <= next );
+			next = std::max( next, index + 1 );
+		}
+
+		vector<float> positions( duck.positions.size() );
+		remapVertices( positions.data(), duck.positions.data(), 3 * sizeof( float ), 3 * sizeof( float ), vertexOrder );
+		for( size_t i = 0; i < indices.size(); i++ ) {
+			for( size_t c = 0; c < 3; c++ )
+				REQUIRE( positions[indices[i] * 3 + c] == duck.positions[duck.indices[i] * 3 + c] );
+		}
+	}
+
+	SECTION( "remapVertices reads strided vertices" )
+	{
+		// 2 floats of each vertex, 3 floats apart.
+		const float src[] = { 0, 1, -1,  2, 3, -1,  4, 5, -1 };
+		vector<float> dst( 6 );
+		remapVertices( dst.data(), src, 2 * sizeof( float ), 3 * sizeof( float ), { 2, 0, 1 } );
+		REQUIRE( dst == vector<float>{ 4, 5,  0, 1,  2, 3 } );
+	}
+}
@@ -0,0 +1,187 @@
+#include "catch.hpp"
+
+#include <cstring>
+#include <fstream>
+
+#include "cinder/DataSource.h"
+
+#include "cinder/gltf/File.h"
+
+using namespace ci;
+using namespace ci::gltf;
+using namespace std;
+
+namespace {
+
+//! Scene 0 holds node 0 drawing mesh 0, scene 1 holds node 1 drawing mesh 1 with node 2 as its
+//! child. Node 3 is in no scene. Each mesh reads its own accessor, bufferView and external buffer.
+const char *kSelectionJson = R"({
+	"asset": { "version": "2.0" },
+	"scene": 0,
+	"scenes": [ { "name": "s0", "nodes": [ 0 ] }, { "name": "s1", "nodes": [ 1 ] } ],
+	"nodes": [
+		{ "name": "n0", "mesh": 0 },
+		{ "name": "n1", "mesh": 1, "children": [ 2 ] },
+		{ "name": "n2" },
+		{ "name": "n3", "mesh": 0 }
+	],
+	"meshes": [
+		{ "name": "m0", "primitives": [ { "attributes": { "POSITION": 0 } } ] },
+		{ "name": "m1", "primitives": [ { "attributes": { "POSITION": 1 }, "material": 0 } ] }
+	],
+	"materials": [ { "name": "mat", "pbrMetallicRoughness": { "metallicFactor": 1.0, "roughnessFactor": 0.5 } } ],
+	"accessors": [
+		{ "name": "a0", "bufferView": 0, "componentType": 5126, "count": 1, "type": "VEC3" },
+		{ "name": "a1", "bufferView": 1, "componentType": 5126, "count": 1, "type": "VEC3" }
+	],
+	"bufferViews": [ { "name": "v0", "buffer": 0, "byteLength": 12 }, { "name": "v1", "buffer": 1, "byteLength": 12 } ],
+	"buffers": [ { "name": "b0", "uri": "b0.bin", "byteLength": 12 }, { "name": "b1", "uri": "b1.bin", "byteLength": 12 } ]
+})";
+
+//! Writes the glTF above and its two buffers to a temporary directory, returning the glTF path.
+fs::path writeSelectionFiles()
+{
+	auto dir = fs::temp_directory_path() / "gltfSelectionTest";
+	fs::create_directories( dir );
+	ofstream( ( dir / "selection.gltf" ).string() ) << kSelectionJson;
+	const char zeros[12] = {};
+	for( auto name : { "b0.bin", "b1.bin" } )
+		ofstream( ( dir / name ).string(), ios::binary ).write( zeros, sizeof( zeros ) );
+	return dir / "selection.gltf";
+}
+
+//! Returns the names of the loaded entries of /a T, unselected glTF 2.0 slots have none.
+template<typename T>
+vector<string> loadedNames( const File &file )
+{
+	vector<string> ret;
+	for( auto &object : file.getCollectionOf<T>() ) {
+		if( ! object.name.empty() )
+			ret.push_back( object.name.str() );
+	}
+	return ret;
+}
+
+vector<string> loadedBuffers( const File &file )
+{
+	vector<string> ret;
+	for( auto &buffer : file.getCollectionOf<gltf::Buffer>() ) {
+		if( buffer.isLoaded() )
+			ret.push_back( buffer.name.str() );
+	}
+	return ret;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "Selections load only what they reference" )
+{
+	auto path = writeSelectionFiles();
+	auto load = [&]( File::Options options, bool streamed ) {
+		auto ret = File::create( loadFile( path ), options.streamJson( streamed ).prefetchBuffers().shareResources( false ) );
+		REQUIRE( ret );
+		return ret;
+	};
+
+	SECTION( "scene" )
+	{
+		for( bool streamed : { false, true } ) {
+			auto file = load( File::Options().selectScene( "1" ), streamed );
+			REQUIRE( loadedNames<Scene>( *file ) == vector<string>{ "s1" } );
+			REQUIRE( loadedNames<Node>( *file ) == vector<string>{ "n1", "n2" } );
+			REQUIRE( loadedNames<Mesh>( *file ) == vector<string>{ "m1" } );
+			REQUIRE( loadedNames<Material>( *file ) == vector<string>{ "mat" } );
+			REQUIRE( loadedNames<Accessor>( *file ) == vector<string>{ "a1" } );
+			REQUIRE( loadedNames<BufferView>( *file ) == vector<string>{ "v1" } );
+			REQUIRE( loadedBuffers( *file ) == vector<string>{ "b1" } );
+			REQUIRE( file->getDefaultScene().name == "s1" );
+			// every index still resolves to its handle.
+			REQUIRE( file->getCollectionOf<Node>().size() == 4 );
+			REQUIRE( file->getCollectionOf<Node>().get( "1" )->meshes.front() == file->getCollectionOf<Mesh>().get( "1" ) );
+		}
+	}
+
+	SECTION( "nodes" )
+	{
+		for( bool streamed : { false, true } ) {
+			auto file = load( File::Options().selectNodes( { "3" } ), streamed );
+			REQUIRE( loadedNames<Scene>( *file ).empty() );
+			REQUIRE( loadedNames<Node>( *file ) == vector<string>{ "n3" } );
+			REQUIRE( loadedNames<Mesh>( *file ) == vector<string>{ "m0" } );
+			REQUIRE( loadedNames<Material>( *file ).empty() );
+			REQUIRE( loadedNames<Accessor>( *file ) == vector<string>{ "a0" } );
+			REQUIRE( loadedBuffers( *file ) == vector<string>{ "b0" } );
+		}
+	}
+
+	SECTION( "meshes" )
+	{
+		for( bool streamed : { false, true } ) {
+			auto file = load( File::Options().selectMeshes( { "1" } ), streamed );
+			REQUIRE( loadedNames<Node>( *file ).empty() );
+			REQUIRE( loadedNames<Mesh>( *file ) == vector<string>{ "m1" } );
+			REQUIRE( loadedNames<Material>( *file ) == vector<string>{ "mat" } );
+			REQUIRE( loadedNames<Accessor>( *file ) == vector<string>{ "a1" } );
+			REQUIRE( loadedBuffers( *file ) == vector<string>{ "b1" } );
+		}
+	}
+
+	SECTION( "a missing scene keeps the default scene" )
+	{
+		for( bool streamed : { false, true } ) {
+			auto file = load( File::Options().selectScene( "7" ), streamed );
+			REQUIRE( loadedNames<Node>( *file ).empty() );
+			REQUIRE( loadedBuffers( *file ).empty() );
+			// the default scene is scene 0, which isn't loaded.
+			REQUIRE( file->getDefaultScene().name.empty() );
+		}
+	}
+
+	SECTION( "numbers that aren't indices" )
+	{
+		// a fraction is never an index.
+		string json = kSelectionJson;
+		auto pos = json.find( R"("material": 0)" );
+		json.replace( pos, strlen( R"("material": 0)" ), R"("material": 0.5)" );
+		ofstream( path.string() ) << json;
+		auto file = load( File::Options().selectMeshes( { "1" } ), false );
+		REQUIRE( loadedNames<Material>( *file ).empty() );
+		REQUIRE( loadedNames<Mesh>( *file ) == vector<string>{ "m1" } );
+		REQUIRE( loadedBuffers( *file ) == vector<string>{ "b1" } );
+	}
+
+	fs::remove_all( path.parent_path() );
+}
+
+TEST_CASE( "glTF 1.0 selections only follow keys" )
+{
+	// the shininess of 1 mustn't select texture "1".
+	string json = R"({
+		"asset": { "version": "1.0" },
+		"scene": "scene",
+		"scenes": { "scene": { "nodes": [ "root" ] } },
+		"nodes": {
+			"root": { "name": "root", "children": [], "meshes": [ "mesh" ] },
+			"2": { "name": "other" }
+		},
+		"meshes": { "mesh": { "name": "mesh", "primitives": [ { "attributes": {}, "material": "material" } ] } },
+		"materials": { "material": { "name": "material", "values": { "shininess": 1, "diffuse": "texture" } } },
+		"textures": {
+			"texture": { "name": "texture", "sampler": "sampler", "source": "image" },
+			"1": { "name": "unreferenced", "sampler": "sampler", "source": "image" }
+		},
+		"samplers": { "sampler": {} },
+		"images": { "image": { "uri": "missing.png" } }
+	})";
+	for( bool streamed : { false, true } ) {
+		auto buffer = ci::Buffer::create( json.size() );
+		memcpy( buffer->getData(), json.data(), json.size() );
+		auto file = File::create( DataSourceBuffer::create( buffer ), File::Options().selectScene( "scene" ).streamJson( streamed ) );
+		REQUIRE( file );
+		REQUIRE( file->getCollectionOf<Material>().size() == 1 );
+		REQUIRE( file->getCollectionOf<Texture>().size() == 1 );
+		REQUIRE( file->getCollectionOf<Texture>().get( "texture" ) );
+		REQUIRE( file->getCollectionOf<Node>().size() == 1 );
+		REQUIRE( file->getDefaultScene().key == "scene" );
+	}
+}
@@ -0,0 +1,252 @@
+#include "catch.hpp"
+
+#include <cstring>
+#include <fstream>
+
+#include "cinder/DataSource.h"
+
+#include "cinder/gltf/File.h"
+
+using namespace ci;
+using namespace ci::gltf;
+using namespace std;
+
+namespace {
+
+template<typename T>
+string keyOf( const T *object )
+{
+	return object ? object->key.str() : string();
+}
+
+template<typename T>
+vector<string> keysOf( const vector<T*> &objects )
+{
+	vector<string> ret;
+	for( auto object : objects )
+		ret.push_back( keyOf( object ) );
+	return ret;
+}
+
+template<typename T>
+void requireSameKeys( const File &lhs, const File &rhs )
+{
+	auto &lhsCollection = lhs.getCollectionOf<T>();
+	auto &rhsCollection = rhs.getCollectionOf<T>();
+	REQUIRE( lhsCollection.size() == rhsCollection.size() );
+	for( auto &object : lhsCollection )
+		REQUIRE( rhsCollection.get( object.key ) );
+}
+
+//! Compares the collections of /a loaded and /a snapshot, their references by key and buffer payloads.
+void requireSameFile( const File &loaded, const File &snapshot )
+{
+	requireSameKeys<Accessor>( loaded, snapshot );
+	requireSameKeys<Animation>( loaded, snapshot );
+	requireSameKeys<BufferView>( loaded, snapshot );
+	requireSameKeys<gltf::Buffer>( loaded, snapshot );
+	requireSameKeys<Camera>( loaded, snapshot );
+	requireSameKeys<Image>( loaded, snapshot );
+	requireSameKeys<Light>( loaded, snapshot );
+	requireSameKeys<Material>( loaded, snapshot );
+	requireSameKeys<Mesh>( loaded, snapshot );
+	requireSameKeys<Node>( loaded, snapshot );
+	requireSameKeys<Program>( loaded, snapshot );
+	requireSameKeys<Sampler>( loaded, snapshot );
+	requireSameKeys<Scene>( loaded, snapshot );
+	requireSameKeys<Shader>( loaded, snapshot );
+	requireSameKeys<Skin>( loaded, snapshot );
+	requireSameKeys<Technique>( loaded, snapshot );
+	requireSameKeys<Texture>( loaded, snapshot );
+	REQUIRE( loaded.isVersion2() == snapshot.isVersion2() );
+
+	for( auto &accessor : loaded.getCollectionOf<Accessor>() ) {
+		auto other = snapshot.getCollectionOf<Accessor>().get( accessor.key );
+		REQUIRE( keyOf( other->bufferView ) == keyOf( accessor.bufferView ) );
+		REQUIRE( other->dataType == accessor.dataType );
+		REQUIRE( other->componentType == accessor.componentType );
+		REQUIRE( other->normalized == accessor.normalized );
+		REQUIRE( other->count == accessor.count );
+		REQUIRE( other->min == accessor.min );
+		REQUIRE( other->max == accessor.max );
+	}
+	for( auto &bufferView : loaded.getCollectionOf<BufferView>() ) {
+		auto other = snapshot.getCollectionOf<BufferView>().get( bufferView.key );
+		REQUIRE( keyOf( other->buffer ) == keyOf( bufferView.buffer ) );
+		REQUIRE( other->target == bufferView.target );
+	}
+	for( auto &buffer : loaded.getCollectionOf<gltf::Buffer>() ) {
+		auto data = buffer.getBuffer();
+		auto otherData = snapshot.getCollectionOf<gltf::Buffer>().get( buffer.key )->getBuffer();
+		REQUIRE( data );
+		REQUIRE( otherData );
+		REQUIRE( otherData->getSize() == data->getSize() );
+		REQUIRE( memcmp( otherData->getData(), data->getData(), data->getSize() ) == 0 );
+	}
+	for( auto &node : loaded.getCollectionOf<Node>() ) {
+		auto other = snapshot.getCollectionOf<Node>().get( node.key );
+		REQUIRE( keysOf( other->children ) == keysOf( node.children ) );
+		REQUIRE( keysOf( other->meshes ) == keysOf( node.meshes ) );
+		REQUIRE( keyOf( other->skin ) == keyOf( node.skin ) );
+		REQUIRE( keyOf( other->parent ) == keyOf( node.parent ) );
+		REQUIRE( other->transformMatrix == node.transformMatrix );
+	}
+	for( auto &mesh : loaded.getCollectionOf<Mesh>() ) {
+		auto other = snapshot.getCollectionOf<Mesh>().get( mesh.key );
+		REQUIRE( other->primitives.size() == mesh.primitives.size() );
+		for( size_t i = 0; i < mesh.primitives.size(); i++ ) {
+			auto &primitive = mesh.primitives[i];
+			auto &otherPrimitive = other->primitives[i];
+			REQUIRE( keyOf( otherPrimitive.indices ) == keyOf( primitive.indices ) );
+			REQUIRE( keyOf( otherPrimitive.material ) == keyOf( primitive.material ) );
+			REQUIRE( otherPrimitive.attributes.size() == primitive.attributes.size() );
+			for( size_t j = 0; j < primitive.attributes.size(); j++ ) {
+				REQUIRE( otherPrimitive.attributes[j].attrib == primitive.attributes[j].attrib );
+				REQUIRE( keyOf( otherPrimitive.attributes[j].accessor ) == keyOf( primitive.attributes[j].accessor ) );
+			}
+		}
+	}
+	for( auto &material : loaded.getCollectionOf<Material>() ) {
+		auto other = snapshot.getCollectionOf<Material>().get( material.key );
+		REQUIRE( keyOf( other->technique ) == keyOf( material.technique ) );
+		REQUIRE( other->doubleSided == material.doubleSided );
+		REQUIRE( other->transparent == material.transparent );
+		REQUIRE( other->sources.size() == material.sources.size() );
+		for( size_t i = 0; i < material.sources.size(); i++ ) {
+			REQUIRE( other->sources[i].type == material.sources[i].type );
+			REQUIRE( keyOf( other->sources[i].texture ) == keyOf( material.sources[i].texture ) );
+		}
+	}
+	for( auto &technique : loaded.getCollectionOf<Technique>() ) {
+		auto other = snapshot.getCollectionOf<Technique>().get( technique.key );
+		REQUIRE( keyOf( other->program ) == keyOf( technique.program ) );
+		REQUIRE( other->states.enables == technique.states.enables );
+		REQUIRE( other->states.functions.colorMask == technique.states.functions.colorMask );
+		REQUIRE( other->states.functions.depthMask == technique.states.functions.depthMask );
+	}
+	for( auto &shader : loaded.getCollectionOf<Shader>() ) {
+		auto other = snapshot.getCollectionOf<Shader>().get( shader.key );
+		REQUIRE( other->type == shader.type );
+		REQUIRE( other->uri == shader.uri );
+	}
+	for( auto &image : loaded.getCollectionOf<Image>() ) {
+		auto source = image.getImage();
+		auto otherSource = snapshot.getCollectionOf<Image>().get( image.key )->getImage();
+		REQUIRE( source );
+		REQUIRE( otherSource );
+		REQUIRE( otherSource->getWidth() == source->getWidth() );
+		REQUIRE( otherSource->getHeight() == source->getHeight() );
+		REQUIRE( otherSource->hasAlpha() == source->hasAlpha() );
+	}
+	for( auto &skin : loaded.getCollectionOf<Skin>() ) {
+		auto other = snapshot.getCollectionOf<Skin>().get( skin.key );
+		REQUIRE( keysOf( other->joints ) == keysOf( skin.joints ) );
+		REQUIRE( keyOf( other->inverseBindMatrices ) == keyOf( skin.inverseBindMatrices ) );
+	}
+	for( auto &animation : loaded.getCollectionOf<Animation>() ) {
+		auto other = snapshot.getCollectionOf<Animation>().get( animation.key );
+		REQUIRE( keyOf( other->timeAccessor ) == keyOf( animation.timeAccessor ) );
+		REQUIRE( other->channels.size() == animation.channels.size() );
+		REQUIRE( other->samplers.size() == animation.samplers.size() );
+	}
+}
+
+vector<char> readBytes( const fs::path &path )
+{
+	ifstream stream( path.string(), ios::binary );
+	return vector<char>( istreambuf_iterator<char>( stream ), istreambuf_iterator<char>() );
+}
+
+void writeBytes( const fs::path &path, const vector<char> &bytes )
+{
+	ofstream stream( path.string(), ios::binary | ios::trunc );
+	stream.write( bytes.data(), bytes.size() );
+}
+
+const char *kSampleFiles[] = {
+	"/BasicLoading/assets/Duck/glTF/Duck.gltf",
+	"/BasicLoading/assets/Duck/glTF-MaterialsCommon/Duck.gltf",
+	"/BasicAnimation/assets/glTF/BoxAnimated.gltf",
+	"/SkeletalAnimation/assets/monster/glTF-Embedded/Monster.gltf",
+	"/SkeletalAnimation/assets/CesiumMan/glTF/CesiumMan.gltf"
+};
+
+const char *kExtrasJson = R"({
+	"asset": { "version": "2.0" },
+	"scenes": [ { "nodes": [ 0 ] } ],
+	"nodes": [ { "name": "root", "children": [ 1 ], "extras": { "tag": "root", "weights": [ 1, 2 ] } }, { "extras": 7 } ],
+	"materials": [ { "doubleSided": true, "extensions": { "EXT_custom": { "value": 3 } } } ]
+})";
+
+} // anonymous namespace
+
+TEST_CASE( "Snapshots round trip" )
+{
+	auto snapshotPath = fs::temp_directory_path() / "gltfUnitTests.snapshot";
+
+	SECTION( "samples" )
+	{
+		for( auto sampleFile : kSampleFiles ) {
+			INFO( sampleFile );
+			auto loaded = File::create( loadFile( string( GLTF_SAMPLES_PATH ) + sampleFile ) );
+			REQUIRE( loaded );
+			REQUIRE( loaded->saveSnapshot( snapshotPath ) );
+			auto snapshot = File::loadSnapshot( snapshotPath );
+			REQUIRE( snapshot );
+			requireSameFile( *loaded, *snapshot );
+		}
+	}
+
+	SECTION( "extras and extensions" )
+	{
+		string json( kExtrasJson );
+		auto buffer = ci::Buffer::create( json.size() );
+		memcpy( buffer->getData(), json.data(), json.size() );
+		auto loaded = File::create( DataSourceBuffer::create( buffer ) );
+		REQUIRE( loaded );
+		REQUIRE( loaded->saveSnapshot( snapshotPath ) );
+		auto snapshot = File::loadSnapshot( snapshotPath );
+		REQUIRE( snapshot );
+		requireSameFile( *loaded, *snapshot );
+
+		REQUIRE( snapshot->getExtrasFrom<Node>( "0" ) == loaded->getExtrasFrom<Node>( "0" ) );
+		REQUIRE( snapshot->getExtrasFrom<Node>( "0" )["tag"].asString() == "root" );
+		REQUIRE( snapshot->getExtrasFrom<Node>( "1" ).asInt() == 7 );
+		REQUIRE( snapshot->getExtensionsFrom<Material>( "0" )["EXT_custom"]["value"].asInt() == 3 );
+		REQUIRE( snapshot->getCollectionOf<Material>().get( "0" )->doubleSided );
+	}
+
+	fs::remove( snapshotPath );
+}
+
+TEST_CASE( "Snapshots of another version or truncated are rejected" )
+{
+	auto snapshotPath = fs::temp_directory_path() / "gltfUnitTests.snapshot";
+	auto loaded = File::create( loadFile( string( GLTF_SAMPLES_PATH ) + kSampleFiles[0] ) );
+	REQUIRE( loaded );
+	REQUIRE( loaded->saveSnapshot( snapshotPath ) );
+	auto bytes = readBytes( snapshotPath );
+	REQUIRE( File::loadSnapshot( snapshotPath ) );
+
+	SECTION( "bumped version" )
+	{
+		// the version follows the 4 byte magic.
+		auto bumped = bytes;
+		uint32_t version;
+		memcpy( &version, bumped.data() + 4, sizeof( version ) );
+		version++;
+		memcpy( bumped.data() + 4, &version, sizeof( version ) );
+		writeBytes( snapshotPath, bumped );
+		REQUIRE_FALSE( File::loadSnapshot( snapshotPath ) );
+	}
+
+	SECTION( "truncated" )
+	{
+		for( size_t size : { bytes.size() / 2, bytes.size() - 1, size_t( 8 ) } ) {
+			writeBytes( snapshotPath, vector<char>( bytes.begin(), bytes.begin() + size ) );
+			REQUIRE_FALSE( File::loadSnapshot( snapshotPath ) );
+		}
+	}
+
+	fs::remove( snapshotPath );
+}